@@ -28,6 +28,7 @@
 #include <iostream>
 #include <complex>
 #include <cstdlib>
+#include <ctime>
 
 namespace po = boost::program_options;
 
@@ -163,7 +164,8 @@ void benchmark_tx_rate(
         const std::string &tx_cpu,
         uhd::tx_streamer::sptr tx_stream,
         atomic_bool& burst_timer_elapsed,
-        bool random_nsamps=false
+        bool random_nsamps=false,
+        size_t spb=0
 ) {
     uhd::set_thread_priority_safe();
 
@@ -177,7 +179,9 @@ void benchmark_tx_rate(
     md.time_spec = usrp->get_time_now() + uhd::time_spec_t(INIT_DELAY);
     md.has_time_spec = (tx_stream->get_num_channels() > 1);
     const size_t max_samps_per_packet = tx_stream->get_max_num_samps();
-    std::vector<char> buff(max_samps_per_packet*uhd::convert::get_bytes_per_item(tx_cpu));
+    //one packet per send() call unless asked for more
+    if (spb == 0) spb = max_samps_per_packet;
+    std::vector<char> buff(std::max(spb, max_samps_per_packet)*uhd::convert::get_bytes_per_item(tx_cpu));
     std::vector<const void *> buffs;
     for (size_t ch = 0; ch < tx_stream->get_num_channels(); ch++)
         buffs.push_back(&buff.front()); //same buffer for each channel
@@ -201,7 +205,7 @@ void benchmark_tx_rate(
     } else {
         //while (not burst_timer_elapsed.load(boost::memory_order_relaxed)) {
         while (not burst_timer_elapsed) {
-            num_tx_samps += tx_stream->send(buffs, max_samps_per_packet, md)*tx_stream->get_num_channels();
+            num_tx_samps += tx_stream->send(buffs, spb, md)*tx_stream->get_num_channels();
             md.has_time_spec = false;
         }
     }
@@ -269,6 +273,8 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     std::string rx_cpu, tx_cpu;
     std::string mode, ref, pps;
     std::string channel_list, rx_channel_list, tx_channel_list;
+    std::string tx_wait, tx_compare;
+    size_t tx_spb;
     bool random_nsamps = false;
     atomic_bool burst_timer_elapsed(false);
 
@@ -293,6 +299,9 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         ("channels", po::value<std::string>(&channel_list)->default_value("0"), "which channel(s) to use (specify \"0\", \"1\", \"0,1\", etc)")
         ("rx_channels", po::value<std::string>(&rx_channel_list), "which RX channel(s) to use (specify \"0\", \"1\", \"0,1\", etc)")
         ("tx_channels", po::value<std::string>(&tx_channel_list), "which TX channel(s) to use (specify \"0\", \"1\", \"0,1\", etc)")
+        ("tx_spb", po::value<size_t>(&tx_spb)->default_value(0), "samples per TX send() call (0 for one packet)")
+        ("tx_wait", po::value<std::string>(&tx_wait), "TX worker wait strategy (auto, spin, spin_block, inline)")
+        ("tx_compare", po::value<std::string>(&tx_compare), "run the TX test once per wait strategy and compare throughput and CPU time (specify \"spin,spin_block\", etc)")
     ;
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -305,10 +314,16 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         "    Specify --rx_rate for a receive-only test.\n"
         "    Specify --tx_rate for a transmit-only test.\n"
         "    Specify both options for a full-duplex test.\n"
+        "    Specify --tx_rate and --tx_compare to compare TX wait strategies.\n"
         << std::endl;
         return ~0;
     }
 
+    if (vm.count("tx_compare") and (vm.count("rx_rate") or not vm.count("tx_rate"))) {
+        std::cerr << "ERROR: --tx_compare requires --tx_rate and cannot be used with --rx_rate" << std::endl;
+        return -1;
+    }
+
     // Random number of samples?
     if (vm.count("random")) {
         std::cout << "Using random number of samples in send() and recv() calls." << std::endl;
@@ -455,24 +470,67 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         thread_group.create_thread(boost::bind(&benchmark_rx_rate, usrp, rx_cpu, rx_stream, random_nsamps, boost::ref(burst_timer_elapsed)));
     }
 
+    //the time to let each test run
+    const long secs = long(duration);
+    const long usecs = long((duration - secs)*1e6);
+    const boost::posix_time::time_duration test_time = boost::posix_time::seconds(secs)
+            + boost::posix_time::microseconds(usecs)
+            + boost::posix_time::milliseconds( (rx_channel_nums.size() <= 1 and tx_channel_nums.size() <= 1) ? 0 : (INIT_DELAY * 1000));
+
+    //run the transmit test once per wait strategy
+    if (vm.count("tx_compare")){
+        usrp->set_tx_rate(tx_rate);
+        std::vector<std::string> strategies;
+        boost::split(strategies, tx_compare, boost::is_any_of("\"',"));
+        std::vector<double> tx_msps, cpu_percent;
+        std::vector<unsigned long long> underflows;
+        for (size_t i = 0; i < strategies.size(); i++){
+            std::cout << boost::format("Testing TX wait strategy %s...") % strategies[i] << std::endl;
+            num_tx_samps = num_underflows = 0;
+            burst_timer_elapsed = false;
+            const std::clock_t cpu_start = std::clock();
+            {
+                uhd::stream_args_t stream_args(tx_cpu, tx_otw);
+                stream_args.channels = tx_channel_nums;
+                stream_args.args["send_wait"] = strategies[i];
+                uhd::tx_streamer::sptr tx_stream = usrp->get_tx_stream(stream_args);
+                thread_group.create_thread(boost::bind(&benchmark_tx_rate, usrp, tx_cpu, tx_stream, boost::ref(burst_timer_elapsed), random_nsamps, tx_spb));
+                thread_group.create_thread(boost::bind(&benchmark_tx_rate_async_helper, tx_stream, boost::ref(burst_timer_elapsed)));
+                boost::this_thread::sleep(test_time);
+                burst_timer_elapsed = true;
+                thread_group.join_all();
+            }
+            const double cpu_secs = double(std::clock() - cpu_start)/CLOCKS_PER_SEC;
+            const double test_secs = test_time.total_microseconds()/1e6;
+            tx_msps.push_back(num_tx_samps/test_secs/1e6);
+            cpu_percent.push_back(100*cpu_secs/test_secs);
+            underflows.push_back(num_underflows);
+        }
+
+        std::cout << std::endl << "TX wait strategy comparison:" << std::endl;
+        std::cout << boost::format("  %-12s %12s %10s %12s") % "strategy" % "Msps" % "CPU %" % "underflows" << std::endl;
+        for (size_t i = 0; i < strategies.size(); i++){
+            std::cout << boost::format("  %-12s %12.3f %10.1f %12u")
+                % strategies[i] % tx_msps[i] % cpu_percent[i] % underflows[i] << std::endl;
+        }
+        std::cout << std::endl << "Done!" << std::endl << std::endl;
+        return EXIT_SUCCESS;
+    }
+
     //spawn the transmit test thread
     if (vm.count("tx_rate")){
         usrp->set_tx_rate(tx_rate);
         //create a transmit streamer
         uhd::stream_args_t stream_args(tx_cpu, tx_otw);
         stream_args.channels = tx_channel_nums;
+        if (vm.count("tx_wait")) stream_args.args["send_wait"] = tx_wait;
         uhd::tx_streamer::sptr tx_stream = usrp->get_tx_stream(stream_args);
-        thread_group.create_thread(boost::bind(&benchmark_tx_rate, usrp, tx_cpu, tx_stream, boost::ref(burst_timer_elapsed), random_nsamps));
+        thread_group.create_thread(boost::bind(&benchmark_tx_rate, usrp, tx_cpu, tx_stream, boost::ref(burst_timer_elapsed), random_nsamps, tx_spb));
         thread_group.create_thread(boost::bind(&benchmark_tx_rate_async_helper, tx_stream, boost::ref(burst_timer_elapsed)));
     }
 
     //sleep for the required duration
-    const long secs = long(duration);
-    const long usecs = long((duration - secs)*1e6);
-    boost::this_thread::sleep(boost::posix_time::seconds(secs)
-            + boost::posix_time::microseconds(usecs)
-            + boost::posix_time::milliseconds( (rx_channel_nums.size() <= 1 and tx_channel_nums.size() <= 1) ? 0 : (INIT_DELAY * 1000))
-    );
+    boost::this_thread::sleep(test_time);
 
     //interrupt and join the threads
     //burst_timer_elapsed.store(true, boost::memory_order_relaxed);
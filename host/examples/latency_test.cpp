@@ -20,16 +20,24 @@
 #include <uhd/usrp/multi_usrp.hpp>
 #include <boost/program_options.hpp>
 #include <boost/format.hpp>
+#include <algorithm>
 #include <iostream>
 #include <complex>
 
 namespace po = boost::program_options;
 
+//! Get the value below which the given fraction of the sorted values falls
+static double get_percentile(const std::vector<double> &sorted, const double fraction){
+    if (sorted.empty()) return 0.0;
+    return sorted[size_t(fraction*(sorted.size() - 1) + 0.5)];
+}
+
 int UHD_SAFE_MAIN(int argc, char *argv[]){
     uhd::set_thread_priority_safe();
 
     //variables to be set by po
     std::string args;
+    std::string profile;
     size_t nsamps;
     double rate;
     double rtt;
@@ -44,6 +52,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         ("nruns",  po::value<size_t>(&nruns)->default_value(1000),   "number of tests to perform")
         ("rtt",    po::value<double>(&rtt)->default_value(0.001),    "delay between receive and transmit (seconds)")
         ("rate",   po::value<double>(&rate)->default_value(100e6/4), "sample rate for receive and transmit (sps)")
+        ("profile", po::value<std::string>(&profile)->default_value("default"), "stream profile (default or low_latency)")
         ("verbose", "specify to enable inner-loop verbose")
     ;
     po::variables_map vm;
@@ -58,6 +67,8 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         "    and tries to send a packet at time t + rtt,\n"
         "    where rtt is the round trip time sample time\n"
         "    from device to host and back to the device.\n"
+        "    It also reports the percentiles of the receive latency,\n"
+        "    from the last sample of a packet to recv() returning it.\n"
         << std::endl;
         return ~0;
     }
@@ -78,13 +89,15 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
 
     //set the rx sample rate
     usrp->set_rx_rate(rate);
-    std::cout << boost::format("Actual RX Rate: %f Msps...") % (usrp->get_rx_rate()/1e6) << std::endl;
+    const double rx_rate = usrp->get_rx_rate();
+    std::cout << boost::format("Actual RX Rate: %f Msps...") % (rx_rate/1e6) << std::endl;
 
     //allocate a buffer to use
     std::vector<std::complex<float> > buffer(nsamps);
 
     //create RX and TX streamers
     uhd::stream_args_t stream_args("fc32"); //complex floats
+    stream_args.args["profile"] = profile;
     uhd::rx_streamer::sptr rx_stream = usrp->get_rx_stream(stream_args);
     uhd::tx_streamer::sptr tx_stream = usrp->get_tx_stream(stream_args);
 
@@ -93,6 +106,19 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     int ack = 0;
     int underflow = 0;
     int other = 0;
+    std::vector<double> rx_latencies;
+
+    //relate the device time to the host time, use the reading with the shortest round trip
+    uhd::time_spec_t host_time_offset, best_read_time(1.0);
+    for (size_t i = 0; i < 10; i++){
+        const uhd::time_spec_t t0 = uhd::time_spec_t::get_system_time();
+        const uhd::time_spec_t device_time = usrp->get_time_now();
+        const uhd::time_spec_t t1 = uhd::time_spec_t::get_system_time();
+        if (t1 - t0 < best_read_time){
+            best_read_time = t1 - t0;
+            host_time_offset = t0 + uhd::time_spec_t((t1 - t0).get_real_secs()/2) - device_time;
+        }
+    }
 
     for(size_t nrun = 0; nrun < nruns; nrun++){
 
@@ -112,6 +138,14 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         size_t num_rx_samps = rx_stream->recv(
             &buffer.front(), buffer.size(), rx_md
         );
+        const uhd::time_spec_t recv_time = uhd::time_spec_t::get_system_time();
+
+        //the time from the last sample at the antenna to the samples in the application
+        if (rx_md.error_code == uhd::rx_metadata_t::ERROR_CODE_NONE and num_rx_samps > 0){
+            const uhd::time_spec_t last_sample_time = host_time_offset + rx_md.time_spec +
+                uhd::time_spec_t(double(num_rx_samps - 1)/rx_rate);
+            rx_latencies.push_back((recv_time - last_sample_time).get_real_secs());
+        }
 
         if(verbose) std::cout << boost::format("Got packet: %u samples, %u full secs, %f frac secs")
             % num_rx_samps % rx_md.time_spec.get_full_secs() % rx_md.time_spec.get_frac_secs() << std::endl;
@@ -164,5 +198,13 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
      **************************************************************/
     std::cout << boost::format("\nACK %d, UNDERFLOW %d, TIME_ERR %d, other %d")
         % ack % underflow % time_error % other << std::endl;
+    std::sort(rx_latencies.begin(), rx_latencies.end());
+    std::cout << boost::format("RX latency over %d runs (us): p50 %.1f, p90 %.1f, p99 %.1f, p99.9 %.1f, max %.1f")
+        % rx_latencies.size()
+        % (get_percentile(rx_latencies, 0.5)*1e6)
+        % (get_percentile(rx_latencies, 0.9)*1e6)
+        % (get_percentile(rx_latencies, 0.99)*1e6)
+        % (get_percentile(rx_latencies, 0.999)*1e6)
+        % (get_percentile(rx_latencies, 1.0)*1e6) << std::endl;
     return EXIT_SUCCESS;
 }
@@ -24,6 +24,7 @@
 #include <boost/function.hpp>
 #include <boost/operators.hpp>
 #include <string>
+#include <vector>
 
 namespace uhd{ namespace convert{
 
@@ -101,6 +102,21 @@ namespace uhd{ namespace convert{
         const priority_type prio = -1
     );
 
+    /*!
+     * Get the IDs of all registered converters.
+     * \return a list of converter IDs, in no particular order
+     */
+    UHD_API std::vector<id_type> get_converter_ids(void);
+
+    /*!
+     * Get the priorities registered for a converter ID.
+     * \param id identify the conversion
+     * \return a list of priorities, in ascending order
+     */
+    UHD_API std::vector<priority_type> get_converter_priorities(
+        const id_type &id
+    );
+
     /*!
      * Register the size of a particular item.
      * \param format the item format
@@ -29,6 +29,7 @@
 #include <uhd/rfnoc/stream_sig.hpp>
 #include <uhd/rfnoc/blockdef.hpp>
 #include <uhd/rfnoc/constants.hpp>
+#include <uhd/rfnoc/ctrl_transaction.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/lexical_cast.hpp>
 #include <stdint.h>
@@ -256,6 +257,43 @@ public:
      */
     uint32_t user_reg_read32(const std::string &reg, const size_t port = 0);
 
+    /*! Like sr_write(), but adds the write to \p transaction instead of
+     * executing it right away.
+     *
+     * \param transaction The transaction to add the write to.
+     * \param reg The settings register to write to.
+     * \param data New value of this register.
+     * \param port Port on which to write
+     */
+    void sr_write(ctrl_transaction::sptr transaction, const uint32_t reg, const uint32_t data, const size_t port = 0);
+
+    /*! Like sr_write(), but takes a register name and adds the write to
+     * \p transaction instead of executing it right away.
+     *
+     * \throw uhd::key_error if \p reg is not a valid register name
+     */
+    void sr_write(ctrl_transaction::sptr transaction, const std::string &reg, const uint32_t data, const size_t port = 0);
+
+    /*! Like sr_read64(), but adds the readback to \p transaction.
+     *
+     * \returns the index of the value in the results of ctrl_transaction::execute()
+     */
+    size_t sr_read64(ctrl_transaction::sptr transaction, const settingsbus_reg_t reg, const size_t port = 0);
+
+    /*! Like user_reg_read64(), but adds the readback to \p transaction.
+     *
+     * \returns the index of the value in the results of ctrl_transaction::execute()
+     */
+    size_t user_reg_read64(ctrl_transaction::sptr transaction, const uint32_t addr, const size_t port = 0);
+
+    /*! Like user_reg_read64(), but takes a register name and adds the
+     * readback to \p transaction.
+     *
+     * \returns the index of the value in the results of ctrl_transaction::execute()
+     * \throws uhd::key_error if \p reg is not a valid register name
+     */
+    size_t user_reg_read64(ctrl_transaction::sptr transaction, const std::string &reg, const size_t port = 0);
+
 
     /*! Sets a command time for all future command packets.
      *
@@ -406,6 +444,15 @@ private:
     //! Helper function to initialize the block args (used by ctor only)
     void _init_block_args();
 
+    //! Returns the address of a named settings register
+    uint32_t _get_sr_addr(const std::string &reg) const;
+
+    //! Returns the address of a named user readback register
+    uint32_t _get_user_reg_addr(const std::string &reg) const;
+
+    //! Returns the control interface of \p port, \p what names the caller in errors
+    wb_iface::sptr _get_ctrl_iface_checked(const size_t port, const std::string &what) const;
+
     /***********************************************************************
      * Private members
      **********************************************************************/
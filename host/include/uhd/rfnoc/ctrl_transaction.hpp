@@ -0,0 +1,102 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_RFNOC_CTRL_TRANSACTION_HPP
+#define INCLUDED_LIBUHD_RFNOC_CTRL_TRANSACTION_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/types/wb_iface.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace uhd { namespace rfnoc {
+
+/*! A batch of register writes and readbacks on one or more blocks.
+ *
+ * Commands are collected first, usually through the transaction versions of
+ * block_ctrl_base::sr_write() and block_ctrl_base::user_reg_read64().
+ * execute() then sends the commands of all blocks before it waits for any
+ * response, so a whole batch costs about one round trip instead of one per
+ * readback. Commands to the same block port keep their order.
+ *
+ * Example:
+ * \code{.cpp}
+ * ctrl_transaction::sptr t = ctrl_transaction::make();
+ * for (size_t i = 0; i < blocks.size(); i++) {
+ *     blocks[i]->sr_write(t, "DECIM_WORD", decim);
+ *     blocks[i]->user_reg_read64(t, RB_STATUS);
+ * }
+ * std::vector<uint64_t> readbacks = t->execute();
+ * \endcode
+ */
+class UHD_RFNOC_API ctrl_transaction : boost::noncopyable
+{
+public:
+    typedef boost::shared_ptr<ctrl_transaction> sptr;
+
+    virtual ~ctrl_transaction(void) = 0;
+
+    //! Make a new, empty transaction
+    static sptr make(void);
+
+    //! Add a 32-bit write of \p data to \p addr of a control interface
+    virtual void add_poke32(
+            wb_iface::sptr iface,
+            const wb_iface::wb_addr_type addr,
+            const uint32_t data
+    ) = 0;
+
+    /*! Add a 64-bit readback of \p addr of a control interface
+     *
+     * \returns the index of the value in the return value of execute()
+     */
+    virtual size_t add_peek64(
+            wb_iface::sptr iface,
+            const wb_iface::wb_addr_type addr
+    ) = 0;
+
+    /*! Execute all commands at a given time.
+     *
+     * Without a command time, the command time of the block ports applies.
+     * The time only applies to the next execute().
+     *
+     * \throws uhd::assertion_error on execute(), before any command is sent,
+     *         if an interface does not support timed commands.
+     */
+    virtual void set_command_time(const time_spec_t &time_spec) = 0;
+
+    //! Returns the number of commands added since the last execute()
+    virtual size_t size(void) const = 0;
+
+    /*! Send all commands and wait for their readbacks.
+     *
+     * Afterwards, the transaction is empty and has no command time, and it
+     * may be used again.
+     *
+     * \returns the readback values in the order they were added
+     * \throws uhd::io_error if a command fails
+     */
+    virtual std::vector<uint64_t> execute(void) = 0;
+};
+
+}} /* namespace uhd::rfnoc */
+
+#endif /* INCLUDED_LIBUHD_RFNOC_CTRL_TRANSACTION_HPP */
+// vim: sw=4 et:
@@ -26,6 +26,7 @@
 #include <boost/utility.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
 #include <map>
 #include <set>
 
@@ -168,7 +169,7 @@ protected:
     /***********************************************************************
      * Structors
      **********************************************************************/
-    node_ctrl_base(void) {}
+    node_ctrl_base(void) : _search_generation(0) {}
     virtual ~node_ctrl_base() { disconnect(); }
 
     /***********************************************************************
@@ -207,6 +208,13 @@ protected:
     /***********************************************************************
      * Connections
      **********************************************************************/
+    /*! Invalidates the cached search results of all nodes connected to this one.
+     *
+     * Must be called on one end of a connection after it is made, and
+     * before it is removed, so that both sides of it are reached.
+     */
+    void _topology_changed();
+
     /*! Registers another node as downstream of this node, connected to a given port.
      *
      * This implies that this node is a source node, and the downstream node is
@@ -256,6 +264,30 @@ private:
             const std::set< boost::shared_ptr<T> > &exclude_nodes
     );
 
+    //! A cached result of _find_child_node()
+    struct search_result_t {
+        //! The value of _search_generation when the search started
+        size_t generation;
+        //! For active_only searches, the streamer flags the search ran on
+        std::map<size_t, bool> streamer_active;
+        //! A std::vector< boost::weak_ptr<T> > of the found nodes
+        boost::shared_ptr<void> nodes;
+    };
+
+    /*! Results of _find_child_node() searches.
+     *
+     * Keyed by the searched type, the direction and active_only.
+     */
+    typedef std::map<
+        std::pair<std::string, std::pair<bool, bool> >,
+        search_result_t
+    > search_cache_t;
+    search_cache_t _search_cache;
+
+    //! Bumped by _topology_changed(), so that searches running meanwhile are not cached
+    size_t _search_generation;
+    boost::mutex _search_cache_mutex;
+
     /*! Stores the remote port number of a downstream connection.
      */
     std::map<size_t, size_t> _upstream_ports;
@@ -23,6 +23,8 @@
 #include <uhd/exception.hpp>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <typeinfo>
 #include <vector>
 
 namespace uhd {
@@ -32,6 +34,43 @@ namespace uhd {
     std::vector< boost::shared_ptr<T> > node_ctrl_base::_find_child_node(bool active_only)
     {
         typedef boost::shared_ptr<T> T_sptr;
+        typedef std::vector< boost::weak_ptr<T> > cached_nodes_t;
+        // Results are reused until a connection in this graph changes.
+        // Active searches skip ports by the streamer flags of this node. Blocks
+        // write those flags directly, so they are compared instead of tracked.
+        const std::map<size_t, bool> &streamer_active = downstream ? _tx_streamer_active : _rx_streamer_active;
+        const std::pair<std::string, std::pair<bool, bool> > cache_key(
+                typeid(T).name(), std::make_pair(downstream, active_only)
+        );
+        search_result_t search_result;
+        {
+            boost::mutex::scoped_lock lock(_search_cache_mutex);
+            search_cache_t::const_iterator it = _search_cache.find(cache_key);
+            if (it != _search_cache.end()
+                and it->second.generation == _search_generation
+                and (not active_only or it->second.streamer_active == streamer_active)) {
+                const cached_nodes_t &cached_nodes = *boost::static_pointer_cast<cached_nodes_t>(it->second.nodes);
+                std::vector< T_sptr > results;
+                results.reserve(cached_nodes.size());
+                BOOST_FOREACH(const boost::weak_ptr<T> &node, cached_nodes) {
+                    T_sptr node_sptr = node.lock();
+                    if (not node_sptr) {
+                        break;
+                    }
+                    results.push_back(node_sptr);
+                }
+                // Only valid if none of the nodes has gone away
+                if (results.size() == cached_nodes.size()) {
+                    return results;
+                }
+            }
+            // Read before searching, so a change during the search invalidates the result
+            search_result.generation = _search_generation;
+        }
+        if (active_only) {
+            search_result.streamer_active = streamer_active;
+        }
+
         static const size_t MAX_ITER = 20;
         size_t iters = 0;
         // List of return values:
@@ -86,6 +125,11 @@ namespace uhd {
         }
 
         std::vector< T_sptr > results(results_s.begin(), results_s.end());
+        search_result.nodes = boost::make_shared<cached_nodes_t>(results.begin(), results.end());
+        {
+            boost::mutex::scoped_lock lock(_search_cache_mutex);
+            _search_cache[cache_key] = search_result;
+        }
         return results;
     }
 
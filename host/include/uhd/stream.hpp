@@ -25,6 +25,8 @@
 #include <uhd/types/ref_vector.hpp>
 #include <boost/utility.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+#include <stdint.h>
 #include <vector>
 #include <string>
 
@@ -130,6 +132,17 @@ struct UHD_API stream_args_t{
      *
      * - noclear: Used by tx_dsp_core_200 and rx_dsp_core_200
      *
+     * - stats_timing: set to "1" to have the streamer time the sample conversions
+     * and every recv() or send() call (see stream_stats_t). This is off by default,
+     * because it reads the system clock on the fast path.
+     *
+     * - profile: "default" or "low_latency". The low latency profile
+     * defaults to small packets (spp), inline conversion on send
+     * (send_wait=inline), no receive offload thread (recv_offload=0) and
+     * busy polling sockets (busy_poll), see \ref stream_profiles.
+     * Options that are set explicitly take precedence over the profile.
+     * Only multi_usrp::get_rx_stream() and get_tx_stream() apply it.
+     *
      * The following are not implemented, but are listed for conceptual purposes:
      * - function: magnitude or phase/magnitude
      * - units: numeric units like counts or dBm
@@ -161,6 +174,61 @@ struct UHD_API stream_args_t{
     std::vector<size_t> channels;
 };
 
+/*!
+ * Streaming counters of an RX or TX streamer, summed over all channels.
+ * The counters are kept per thread by the streamer, so reading them
+ * does not slow down recv() or send().
+ */
+struct UHD_API stream_stats_t{
+    stream_stats_t(void);
+
+    //! Number of the call latency histogram buckets
+    static const size_t NUM_LATENCY_BUCKETS = 24;
+
+    //! Number of packets moved over the transport
+    uint64_t num_packets;
+
+    //! Number of payload bytes moved over the transport
+    uint64_t num_bytes;
+
+    //! Number of overflows (RX)
+    uint64_t num_overflows;
+
+    //! Number of underflows reported by the device (TX)
+    uint64_t num_underflows;
+
+    //! Number of sequence errors (dropped packets)
+    uint64_t num_seq_errors;
+
+    //! Number of late commands (RX) or late packets (TX)
+    uint64_t num_late_packets;
+
+    //! Number of times a packet had to wait for flow control credit (TX)
+    uint64_t num_fc_stalls;
+
+    //! Total time spent waiting for flow control credit in seconds (TX)
+    double fc_stall_time;
+
+    //! Total time spent converting samples in seconds (needs stats_timing)
+    double convert_time;
+
+    /*!
+     * Histogram of the recv() or send() call durations (needs stats_timing).
+     * Bucket 0 counts calls shorter than 1 us, bucket i counts calls
+     * of 2^(i-1) us up to 2^i us, the last bucket counts all longer calls.
+     */
+    std::vector<uint64_t> call_latency;
+
+    //! Number of frames the transport currently keeps in flight (0 if not reported)
+    size_t xport_frames_in_flight;
+
+    //! Size of a transport frame in bytes (0 if not reported)
+    size_t xport_frame_size;
+
+    //! Get a printable summary of the counters
+    std::string to_pp_string(void) const;
+};
+
 /*!
  * The RX streamer is the host interface to receiving samples.
  * It represents the layer between the samples on the host
@@ -235,6 +303,45 @@ public:
      * \param stream_cmd the stream command to issue
      */
     virtual void issue_stream_cmd(const stream_cmd_t &stream_cmd) = 0;
+
+    /*!
+     * Get the streaming counters since creation or the last reset_stats().
+     * Overflows, sequence errors and late commands are counted as
+     * recv() reports them.
+     * \return the counters summed over all channels
+     */
+    virtual stream_stats_t get_stats(void) const;
+
+    //! Restart the streaming counters from zero
+    virtual void reset_stats(void);
+
+    /*!
+     * Get a file descriptor that polls readable when recv() may return
+     * samples without waiting, so that an event loop can service many
+     * streams from one thread. The descriptor is owned by the streamer
+     * and cleared by it: do not read from it.
+     * When it polls readable, call recv() with a zero timeout until it
+     * returns with ERROR_CODE_TIMEOUT. Readiness may be spurious.
+     * \return the file descriptor, or -1 if the streamer or platform does not support it
+     */
+    virtual int get_recv_fd(void);
+};
+
+/*!
+ * Flow control counters for one channel of a TX streamer.
+ * Streamers without host-side flow control report all zeros.
+ */
+struct UHD_API tx_flow_ctrl_stats_t{
+    tx_flow_ctrl_stats_t(void);
+
+    //! Fraction of the flow control window in flight (0.0 to 1.0)
+    double credit_occupancy;
+
+    //! Number of times a packet had to wait for flow control credit
+    uint64_t num_stalls;
+
+    //! Total time spent waiting for flow control credit in seconds
+    double stall_time;
 };
 
 /*!
@@ -287,6 +394,8 @@ public:
 
     /*!
      * Receive and asynchronous message from this TX stream.
+     * The messages are queued in the streamer. When the queue is full,
+     * the oldest message is dropped to make room for the newest one.
      * \param async_metadata the metadata to be filled in
      * \param timeout the timeout in seconds to wait for a message
      * \return true when the async_metadata is valid, false for timeout
@@ -294,6 +403,57 @@ public:
     virtual bool recv_async_msg(
         async_metadata_t &async_metadata, double timeout = 0.1
     ) = 0;
+
+    //! Typedef for a function that receives the async messages
+    typedef boost::function<void(const async_metadata_t &)> async_callback_type;
+
+    /*!
+     * Deliver the async messages of this TX stream to a callback
+     * instead of queueing them for recv_async_msg().
+     * The callback is called from a UHD thread and should return quickly.
+     * Pass an empty function to go back to recv_async_msg().
+     * \param callback the function to call for every async message
+     * \throw uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual void set_async_callback(const async_callback_type &callback);
+
+    /*!
+     * Get a file descriptor that polls readable when async messages are queued.
+     * This lets an event loop wait on the TX status of many streams.
+     * When it is readable, read 8 bytes from it to clear it, then call
+     * recv_async_msg() with a zero timeout until it returns false.
+     * \return the file descriptor, or -1 if the streamer or platform does not support it
+     */
+    virtual int get_async_fd(void);
+
+    /*!
+     * Get a file descriptor that polls readable while the device has
+     * room for more samples, so that an event loop can service many
+     * streams from one thread. The descriptor is owned by the streamer
+     * and cleared by it when the device runs out of room:
+     * do not read from it. It is a hint: a send() that finds no room
+     * after all waits for it as usual.
+     * \return the file descriptor, or -1 if the streamer or platform does not support it
+     */
+    virtual int get_send_fd(void);
+
+    /*!
+     * Get the flow control counters of a channel of this TX stream.
+     * \param chan the channel index (0 to num channels - 1)
+     * \return the flow control counters
+     */
+    virtual tx_flow_ctrl_stats_t get_flow_ctrl_stats(const size_t chan = 0) const;
+
+    /*!
+     * Get the streaming counters since creation or the last reset_stats().
+     * Underflows, sequence errors and late packets are counted as
+     * recv_async_msg() reports them.
+     * \return the counters summed over all channels
+     */
+    virtual stream_stats_t get_stats(void) const;
+
+    //! Restart the streaming counters from zero
+    virtual void reset_stats(void);
 };
 
 } //namespace uhd
@@ -143,6 +143,14 @@ public:
     */
     nirio_status release(const size_t elements);
 
+    /*!
+    * Batches the releases of an input FIFO: released elements are given back to the device
+    * once at least this many are pending, and always before the FIFO waits for new elements.
+    * This saves a kernel transition per released frame. Output FIFOs release immediately.
+    * \param elements Number of elements to batch (0 or 1 to release immediately)
+    */
+    void set_release_batch_size(const size_t elements);
+
     /*!
     * Reads data from the DMA FIFO into the provided buffer
     * \param buf The buffer into which to read data from the DMA FIFO
@@ -210,6 +218,13 @@ private:    //Methods
         const fifo_optimization_option_t fifo_optimization_option,
         nirio_status& status);
 
+    /*!
+    * Gives elements back to the device, without batching
+    * \param elements Size (in elements) of the block to release.
+    * \return status
+    */
+    nirio_status _grant(const size_t elements);
+
 private:    //Members
     enum fifo_state_t {
         UNMAPPED, MAPPED, STARTED
@@ -234,6 +249,8 @@ private:    //Members
     boost::atomic<size_t>          _total_elements_acquired;
     size_t                         _frame_size_in_elements;
     fifo_optimization_option_t     _fifo_optimization_option;
+    size_t                         _release_batch_size;
+    size_t                         _pending_release;
 
     static const uint32_t FIFO_LOCK_TIMEOUT_IN_MS = 5000;
 };
@@ -44,7 +44,9 @@ nirio_fifo<data_t>::nirio_fifo(
     _actual_depth_in_elements(0),
     _total_elements_acquired(0),
     _frame_size_in_elements(0),
-    _fifo_optimization_option(MINIMIZE_LATENCY)
+    _fifo_optimization_option(MINIMIZE_LATENCY),
+    _release_batch_size(0),
+    _pending_release(0)
 {
     nirio_status status = 0;
     nirio_status_chain(_riok_proxy_ptr->set_attribute(RIO_ADDRESS_SPACE, BUS_INTERFACE), status);
@@ -160,9 +162,17 @@ bool nirio_fifo<data_t>::_acquire_block_from_rio_buffer(
         // (don't want to acquire partial frames)
         elements_to_request = elements_remaining_u32 - (elements_remaining_u32 % _frame_size_in_elements);
 
-        // the next call to wait_on_fifo can have a 0 timeout since we
-        // know there is at least as much data as we will request available
-        timeout_in_ms = 0;
+        if (elements_to_request < elements_requested)
+        {
+            // not enough there yet, wait for the requested amount
+            elements_to_request = elements_requested;
+        }
+        else
+        {
+            // the next call to wait_on_fifo can have a 0 timeout since we
+            // know there is at least as much data as we will request available
+            timeout_in_ms = 0;
+        }
     }
     else
     {
@@ -252,8 +262,9 @@ nirio_status nirio_fifo<data_t>::stop()
     if (_state == STARTED) {
 
         // release any remaining acquired elements
-        if (_total_elements_acquired > 0) release(_total_elements_acquired);
+        if (_total_elements_acquired > 0) _grant(_total_elements_acquired);
         _total_elements_acquired = 0;
+        _pending_release = 0;
         _remaining_in_claimed_block = 0;
         _remaining_acquirable_elements = 0;
 
@@ -282,7 +293,17 @@ nirio_status nirio_fifo<data_t>::acquire(
 
         if (_remaining_in_claimed_block == 0)
         {
-   
+            // give back batched elements first, the device may be waiting for them
+            if (_pending_release > 0) {
+                nirio_status_chain(_grant(_pending_release), status);
+                _pending_release = 0;
+                if (nirio_status_fatal(status)) {
+                    elements_acquired = 0;
+                    elements_remaining = _remaining_acquirable_elements;
+                    return status;
+                }
+            }
+
             // so acquire some now
             if (!_acquire_block_from_rio_buffer(
                      elements_requested,
@@ -333,10 +354,15 @@ nirio_status nirio_fifo<data_t>::release(const size_t elements)
     boost::unique_lock<boost::recursive_mutex> lock(_mutex);
 
     if (_state == STARTED) {
-        status = _riok_proxy_ptr->grant_fifo(
-            _fifo_channel,
-            static_cast<uint32_t>(elements));
-        _total_elements_acquired -= elements;
+        if (_release_batch_size > 1 && _fifo_direction == INPUT_FIFO) {
+            _pending_release += elements;
+            if (_pending_release >= _release_batch_size) {
+                status = _grant(_pending_release);
+                _pending_release = 0;
+            }
+        } else {
+            status = _grant(elements);
+        }
     } else {
         status = NiRio_Status_ResourceNotInitialized;
     }
@@ -344,6 +370,23 @@ nirio_status nirio_fifo<data_t>::release(const size_t elements)
     return status;
 }
 
+template <typename data_t>
+nirio_status nirio_fifo<data_t>::_grant(const size_t elements)
+{
+    nirio_status status = _riok_proxy_ptr->grant_fifo(
+        _fifo_channel,
+        static_cast<uint32_t>(elements));
+    _total_elements_acquired -= elements;
+    return status;
+}
+
+template <typename data_t>
+void nirio_fifo<data_t>::set_release_batch_size(const size_t elements)
+{
+    boost::unique_lock<boost::recursive_mutex> lock(_mutex);
+    _release_batch_size = elements;
+}
+
 template <typename data_t>
 nirio_status nirio_fifo<data_t>::read(
     data_t* buf,
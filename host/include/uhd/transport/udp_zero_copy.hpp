@@ -53,6 +53,11 @@ public:
      *
      * The address will be resolved, it can be a host name or ipv4.
      * The port will be resolved, it can be a port type or number.
+     * The local port is picked by the OS, unless the hint
+     * "local_port" is given (a uhd::io_error is thrown if it is taken).
+     * With the hint "busy_poll" set to a time in us, receive calls
+     * busy poll the socket for up to that time before they sleep
+     * until a packet arrives (Linux only).
      *
      * \param addr a string representing the destination address
      * \param port a string representing the destination port
@@ -52,6 +52,11 @@ public:
      * \param recv_endpoint an integer specifying an IN endpoint number
      * \param send_interface an integer specifying an OUT interface number
      * \param send_endpoint an integer specifying an OUT endpoint number
+     * With the hint num_frames_auto=1, the number of transfers in flight
+     * starts at num_recv_frames and num_send_frames, and is tuned while
+     * streaming up to max_num_recv_frames and max_num_send_frames
+     * (default: four times as many).
+     *
      * \param hints optional parameters to pass to the underlying transport
      * \return a new zero copy USB object
      */
@@ -63,6 +68,20 @@ public:
         const unsigned char send_endpoint,
         const device_addr_t &hints = device_addr_t()
     );
+
+    /*!
+     * Get the number of receive transfers currently kept in flight.
+     * This is less than get_num_recv_frames() when the transport
+     * tunes it while streaming (hint num_frames_auto).
+     */
+    virtual size_t get_num_recv_frames_in_flight(void) const{
+        return this->get_num_recv_frames();
+    }
+
+    //! Get the number of send transfers currently kept in flight
+    virtual size_t get_num_send_frames_in_flight(void) const{
+        return this->get_num_send_frames();
+    }
 };
 
 }} //namespace
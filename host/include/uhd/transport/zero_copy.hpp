@@ -200,6 +200,17 @@ namespace uhd{ namespace transport{
          */
         virtual size_t get_send_frame_size(void) const = 0;
 
+        /*!
+         * Get a file descriptor that polls readable when
+         * get_recv_buff() may return a buffer without waiting.
+         * Spurious readiness is allowed, so a caller must still
+         * handle a timeout. Do not read from the descriptor.
+         * \return the file descriptor, or -1 when not supported
+         */
+        virtual int get_recv_fd(void){
+            return -1;
+        }
+
     };
 
 }} //namespace
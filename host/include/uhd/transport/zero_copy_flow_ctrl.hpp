@@ -27,6 +27,9 @@ namespace uhd{ namespace transport{
 
 /*!
  * Flow control function.
+ * The function should block until the buffer may be sent or released,
+ * for example by waiting on a notification from the flow control response
+ * path. Returning false makes the caller yield and call it again.
  * \param buff buffer to be sent or receive buffer being released
  * \return true if OK, false if not
  */
@@ -186,6 +186,24 @@ namespace uhd{
             uint32_t data,
             size_t num_bits
         );
+
+        /*!
+        * Write a sequence of words to the SPI bus.
+        * Every word is its own SPI transaction, and the words are
+        * written in order. Implementations may combine the writes into
+        * fewer transport transactions than calling write_spi() for
+        * every word would take.
+        * \param which_slave the slave device number
+        * \param config spi config args
+        * \param data the words to write (be sure to set write bits)
+        * \param num_bits how many bits in each word
+        */
+        virtual void write_spi_batch(
+            int which_slave,
+            const spi_config_t &config,
+            const std::vector<uint32_t> &data,
+            size_t num_bits
+        );
     };
 
     /*!
@@ -265,7 +265,10 @@ public:
      * Upon completion, the times will be synchronized to the time provided.
      *
      * - Step1: wait for the last pps time to transition to catch the edge
-     * - Step2: set the time at the next pps (synchronous for all boards)
+     * - Step2: set the time at the next pps (all boards at once)
+     *
+     * The time offsets found after the second step are logged at debug
+     * level, see get_time_offsets().
      *
      * \param time_spec the time to latch at the next pps after catching the edge
      */
@@ -279,6 +282,15 @@ public:
      */
     virtual bool get_time_synchronized(void) = 0;
 
+    /*!
+     * Get the time offsets of all motherboards relative to motherboard 0.
+     * The time registers of all motherboards are read at the same time,
+     * so an offset includes the difference in readback latency between
+     * the motherboards, but not the latency itself.
+     * \return one offset per motherboard (zero for motherboard 0)
+     */
+    virtual std::vector<time_spec_t> get_time_offsets(void) = 0;
+
     /*!
      * Set the time at which the control commands will take effect.
      *
@@ -508,6 +520,39 @@ public:
      */
     virtual freq_range_t get_fe_rx_freq_range(size_t chan = 0) = 0;
 
+    /*!
+     * Store a RX frontend frequency in a fast lock profile.
+     *
+     * A fast lock profile holds the complete synthesizer state for one
+     * frequency, so switching to it with recall_rx_fast_lock_profile() is
+     * much faster than a regular tune: There is no synthesizer programming
+     * and no VCO calibration involved. This is useful for frequency hopping.
+     *
+     * Storing a profile tunes and calibrates the frontend for the given
+     * frequency, then returns it to its current frequency.
+     *
+     * \param profile the profile index
+     * \param freq the RF frontend frequency in Hz
+     * \param chan the channel index 0 to N-1
+     * \return the actual frequency stored in the profile
+     * \throws uhd::runtime_error if the device has no fast lock profiles
+     * \throws uhd::value_error if the profile index is out of range
+     */
+    virtual double store_rx_fast_lock_profile(size_t profile, double freq, size_t chan = 0) = 0;
+
+    /*!
+     * Switch the RX frontend to a stored fast lock profile.
+     *
+     * Only the frontend LO is changed; the DSP frequency is left untouched.
+     * When a command time is set, the switch happens at that time.
+     *
+     * \param profile the profile index
+     * \param chan the channel index 0 to N-1
+     * \throws uhd::runtime_error if the device has no fast lock profiles
+     * \throws uhd::value_error if the profile index is out of range
+     */
+    virtual void recall_rx_fast_lock_profile(size_t profile, size_t chan = 0) = 0;
+
     /*!
      * Get a list of possible LO stage names
      * \param chan the channel index 0 to N-1
@@ -878,6 +923,39 @@ public:
      */
     virtual freq_range_t get_fe_tx_freq_range(size_t chan = 0) = 0;
 
+    /*!
+     * Store a TX frontend frequency in a fast lock profile.
+     *
+     * A fast lock profile holds the complete synthesizer state for one
+     * frequency, so switching to it with recall_tx_fast_lock_profile() is
+     * much faster than a regular tune: There is no synthesizer programming
+     * and no VCO calibration involved. This is useful for frequency hopping.
+     *
+     * Storing a profile tunes and calibrates the frontend for the given
+     * frequency, then returns it to its current frequency.
+     *
+     * \param profile the profile index
+     * \param freq the RF frontend frequency in Hz
+     * \param chan the channel index 0 to N-1
+     * \return the actual frequency stored in the profile
+     * \throws uhd::runtime_error if the device has no fast lock profiles
+     * \throws uhd::value_error if the profile index is out of range
+     */
+    virtual double store_tx_fast_lock_profile(size_t profile, double freq, size_t chan = 0) = 0;
+
+    /*!
+     * Switch the TX frontend to a stored fast lock profile.
+     *
+     * Only the frontend LO is changed; the DSP frequency is left untouched.
+     * When a command time is set, the switch happens at that time.
+     *
+     * \param profile the profile index
+     * \param chan the channel index 0 to N-1
+     * \throws uhd::runtime_error if the device has no fast lock profiles
+     * \throws uhd::value_error if the profile index is out of range
+     */
+    virtual void recall_tx_fast_lock_profile(size_t profile, size_t chan = 0) = 0;
+
     /*!
      * Set the TX gain value for the specified gain element.
      * For an empty name, distribute across all gain elements.
@@ -22,6 +22,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
 #include <boost/utility.hpp>
+#include <string>
 
 namespace uhd{
 
@@ -41,9 +42,10 @@ namespace uhd{
          *  - The task polls the interrupt condition.
          *
          * \param task_fcn the task callback function
+         * \param role the thread role for uhd::apply_thread_placement()
          * \return a new task object
          */
-        static sptr make(const task_fcn_type &task_fcn);
+        static sptr make(const task_fcn_type &task_fcn, const std::string &role = "task");
 
     };
 } //namespace uhd
@@ -19,6 +19,9 @@
 #define INCLUDED_UHD_UTILS_THREAD_PRIORITY_HPP
 
 #include <uhd/config.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <string>
+#include <vector>
 
 namespace uhd{
 
@@ -53,6 +56,54 @@ namespace uhd{
         bool realtime = true
     );
 
+    /*!
+     * Set the CPU affinity of the current thread.
+     * \param cpus the indexes of the CPUs the thread may run on
+     * \throw exception on failure or when not supported
+     */
+    UHD_API void set_thread_affinity(const std::vector<size_t> &cpus);
+
+    /*!
+     * Set the name of the current thread, as shown by debuggers and top.
+     * The name may be truncated (15 characters on Linux).
+     * This is best effort and does nothing where not supported.
+     * \param name the new thread name
+     */
+    UHD_API void set_thread_name(const std::string &name);
+
+    /*!
+     * Set the placement policy for the threads UHD starts internally.
+     * The policy is per process, not per device: each call replaces the
+     * previous policy. uhd::device::make() calls this with the arguments of
+     * every new device, so the most recently created device decides the
+     * placement of all threads started afterwards, including those of
+     * devices created before it.
+     * It is read from these keys:
+     *
+     *  - thread_cpus: default CPUs for all roles, such as "2-3:6"
+     *  - thread_numa_node: default to the CPUs of this NUMA node (Linux)
+     *  - thread_priority: default priority for all roles (-1 to 1)
+     *  - thread_<role>_cpus and thread_<role>_priority: per role overrides
+     *
+     * CPU lists are ranges ("2-3") or single CPUs separated by colons.
+     * The roles are task, recv_offload, mux_recv, usb_event, send_worker
+     * and gps_reader.
+     * Threads without a configured priority keep the default scheduling.
+     * Arguments without any thread_ keys reset the policy to the defaults.
+     *
+     * \param args device arguments containing the keys above
+     * \throw uhd::value_error on malformed values
+     */
+    UHD_API void set_thread_placement(const device_addr_t &args);
+
+    /*!
+     * Apply the placement policy of a role to the current thread.
+     * Names the thread "uhd_<role>" and sets its affinity and priority
+     * when configured. Failures are logged, never thrown.
+     * \param role the role of the calling thread
+     */
+    UHD_API void apply_thread_placement(const std::string &role);
+
 } //namespace uhd
 
 #endif /* INCLUDED_UHD_UTILS_THREAD_PRIORITY_HPP */
@@ -0,0 +1,132 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_UTILS_TRACE_HPP
+#define INCLUDED_UHD_UTILS_TRACE_HPP
+
+#include <uhd/config.hpp>
+#include <stdint.h>
+#include <ostream>
+#include <string>
+
+/*!
+ * Tracepoints for the streaming hot path.
+ *
+ * When UHD is configured with -DUHD_TRACE=ON, the streamers record
+ * timestamped events into a per-thread in-memory ring. Recording takes
+ * no locks and never allocates after a thread's first event; when a
+ * ring is full the oldest events are overwritten.
+ * Without UHD_TRACE the tracepoint macros compile to nothing, and the
+ * functions below still exist but there is nothing to dump.
+ *
+ * The rings are written as Chrome trace event JSON, which can be loaded
+ * into chrome://tracing or https://ui.perfetto.dev.
+ * Set the environment variable UHD_TRACE_FILE to a path to have the
+ * trace dumped there when the process exits.
+ */
+namespace uhd{ namespace trace{
+
+    //! The instrumented points in the streaming stack
+    enum event_t{
+        RECV_CALL = 0,
+        RECV_GET_BUFF,
+        RECV_UNPACK,
+        RECV_CONVERT,
+        RECV_FC_SEND,
+        SEND_CALL,
+        SEND_GET_BUFF,
+        SEND_PACK,
+        SEND_CONVERT,
+        SEND_COMMIT,
+        SEND_FC_RECV,
+        NUM_EVENTS
+    };
+
+    //! How an event is recorded
+    enum phase_t{
+        PHASE_BEGIN = 'B',
+        PHASE_END = 'E',
+        PHASE_INSTANT = 'i'
+    };
+
+    //! Is the library built with tracepoints?
+    UHD_API bool is_enabled(void);
+
+    //! Get the name of an event as it appears in the dump
+    UHD_API std::string get_event_name(const event_t event);
+
+    /*!
+     * Record an event in the ring of the calling thread.
+     * This is what the tracepoint macros expand to.
+     * \param event the instrumented point
+     * \param phase begin, end or instant
+     * \param arg a value to show with the event, such as a size
+     */
+    UHD_API void record(const event_t event, const phase_t phase, const uint64_t arg = 0);
+
+    /*!
+     * Write all recorded events as Chrome trace event JSON.
+     * Threads that are still streaming may overwrite events while
+     * they are written, so stop streaming before dumping.
+     * \param os the stream to write to
+     * \return the number of events written
+     */
+    UHD_API size_t dump(std::ostream &os);
+
+    /*!
+     * Write all recorded events to a file.
+     * \param path the file to (over)write
+     * \return the number of events written
+     * \throws uhd::os_error if the file cannot be written
+     */
+    UHD_API size_t dump(const std::string &path);
+
+    //! Discard all recorded events
+    UHD_API void clear(void);
+
+    //! Records a begin event when constructed and an end event when destroyed
+    class scoped_event{
+    public:
+        scoped_event(const event_t event, const uint64_t arg = 0): _event(event){
+            record(_event, PHASE_BEGIN, arg);
+        }
+
+        ~scoped_event(void){
+            record(_event, PHASE_END);
+        }
+
+    private:
+        const event_t _event;
+    };
+
+}} //namespace uhd::trace
+
+#ifdef UHD_TRACE
+#define UHD_TRACE_NAME_CAT_(a, b) a ## b
+#define UHD_TRACE_NAME_CAT(a, b) UHD_TRACE_NAME_CAT_(a, b)
+//! Trace the rest of the enclosing scope as one event
+#define UHD_TRACE_SCOPE(event, arg) \
+    uhd::trace::scoped_event UHD_TRACE_NAME_CAT(_uhd_trace_, __LINE__)(uhd::trace::event, arg)
+//! Trace a single point in time
+#define UHD_TRACE_POINT(event, arg) \
+    uhd::trace::record(uhd::trace::event, uhd::trace::PHASE_INSTANT, arg)
+#else
+#define UHD_TRACE_SCOPE(event, arg)
+#define UHD_TRACE_POINT(event, arg)
+#endif
+
+#endif /* INCLUDED_UHD_UTILS_TRACE_HPP */
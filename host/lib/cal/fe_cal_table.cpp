@@ -0,0 +1,338 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "fe_cal_table.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/utils/csv.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/static.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace fs = boost::filesystem;
+using namespace uhd;
+using namespace uhd::cal;
+
+/***********************************************************************
+ * Helper routines
+ **********************************************************************/
+static bool fe_cal_comp(const fe_cal_table::point_t &a, const fe_cal_table::point_t &b){
+    return (a.lo_freq < b.lo_freq);
+}
+
+static bool is_same_freq(const double f1, const double f2)
+{
+    const double epsilon = 0.1;
+    return ((f1 - epsilon) < f2 and (f1 + epsilon) > f2);
+}
+
+//binary format: magic, byte order mark, version, number of points,
+//then lo_freq, real, imag as native doubles for every point
+static const char BINARY_MAGIC[8] = {'U', 'H', 'D', 'F', 'E', 'C', 'A', 'L'};
+static const boost::uint32_t BINARY_BOM = 0x01020304;
+static const boost::uint32_t BINARY_VERSION = 1;
+static const boost::uint64_t BINARY_MAX_POINTS = 1 << 20;
+
+/***********************************************************************
+ * Table implementation
+ **********************************************************************/
+fe_cal_table::fe_cal_table(const std::vector<point_t> &points)
+{
+    std::vector<point_t> sorted(points);
+    std::stable_sort(sorted.begin(), sorted.end(), fe_cal_comp);
+    _freqs.reserve(sorted.size());
+    _corrs.reserve(sorted.size());
+    for (size_t i = 0; i < sorted.size(); i++){
+        _freqs.push_back(sorted[i].lo_freq);
+        _corrs.push_back(sorted[i].corr);
+    }
+}
+
+fe_cal_table::sptr fe_cal_table::make(const std::vector<point_t> &points)
+{
+    return sptr(new fe_cal_table(points));
+}
+
+std::complex<double> fe_cal_table::get(const double lo_freq) const
+{
+    if (_freqs.empty()) throw uhd::runtime_error("empty calibration table");
+
+    //index of the first point above the lo freq
+    const size_t hi_index = std::upper_bound(_freqs.begin(), _freqs.end(), lo_freq) - _freqs.begin();
+
+    //a point at (almost) the lo freq is used as is
+    if (hi_index > 0 and is_same_freq(_freqs[hi_index-1], lo_freq)) return _corrs[hi_index-1];
+    if (hi_index < _freqs.size() and is_same_freq(_freqs[hi_index], lo_freq)) return _corrs[hi_index];
+
+    //outside of the table
+    if (hi_index == 0) return _corrs.front();
+    if (hi_index == _freqs.size()) return _corrs.back();
+
+    //interpolation time
+    const size_t lo_index = hi_index - 1;
+    const double frac = (lo_freq - _freqs[lo_index])/(_freqs[hi_index] - _freqs[lo_index]);
+    return _corrs[lo_index] + frac*(_corrs[hi_index] - _corrs[lo_index]);
+}
+
+fe_cal_table::sptr fe_cal_table::from_csv(std::istream &in)
+{
+    const uhd::csv::rows_type rows = uhd::csv::to_rows(in);
+
+    bool read_data = false, skip_next = false;
+    std::vector<point_t> points;
+    for(const uhd::csv::row_type &row:  rows){
+        if (not read_data and not row.empty() and row[0] == "DATA STARTS HERE"){
+            read_data = true;
+            skip_next = true;
+            continue;
+        }
+        if (not read_data) continue;
+        if (skip_next){
+            skip_next = false;
+            continue;
+        }
+        if (row.size() < 3) continue;
+        double lo_freq = 0.0, corr_real = 0.0, corr_imag = 0.0;
+        std::sscanf(row[0].c_str(), "%lf" , &lo_freq);
+        std::sscanf(row[1].c_str(), "%lf" , &corr_real);
+        std::sscanf(row[2].c_str(), "%lf" , &corr_imag);
+        point_t point;
+        point.lo_freq = lo_freq;
+        point.corr = std::complex<double>(corr_real, corr_imag);
+        points.push_back(point);
+    }
+    if (not read_data) throw uhd::value_error("calibration data has no data section");
+
+    return make(points);
+}
+
+fe_cal_table::sptr fe_cal_table::from_binary(std::istream &in)
+{
+    char magic[sizeof(BINARY_MAGIC)];
+    boost::uint32_t bom = 0, version = 0;
+    boost::uint64_t num_points = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&bom), sizeof(bom));
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    in.read(reinterpret_cast<char *>(&num_points), sizeof(num_points));
+    if (not in or std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0
+        or bom != BINARY_BOM or version != BINARY_VERSION){
+        throw uhd::value_error("not a binary calibration table");
+    }
+
+    if (num_points == 0 or num_points > BINARY_MAX_POINTS){
+        throw uhd::value_error("invalid binary calibration table size");
+    }
+
+    std::vector<double> values(3*size_t(num_points));
+    in.read(reinterpret_cast<char *>(&values.front()), values.size()*sizeof(double));
+    if (not in) throw uhd::value_error("truncated binary calibration table");
+
+    boost::shared_ptr<fe_cal_table> table(new fe_cal_table(std::vector<point_t>()));
+    table->_freqs.resize(size_t(num_points));
+    table->_corrs.resize(size_t(num_points));
+    for (size_t i = 0; i < table->_freqs.size(); i++){
+        table->_freqs[i] = values[3*i + 0];
+        table->_corrs[i] = std::complex<double>(values[3*i + 1], values[3*i + 2]);
+        if (i > 0 and table->_freqs[i] < table->_freqs[i-1]){
+            throw uhd::value_error("unsorted binary calibration table");
+        }
+    }
+    return table;
+}
+
+void fe_cal_table::to_binary(std::ostream &out) const
+{
+    const boost::uint64_t num_points = _freqs.size();
+    out.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    out.write(reinterpret_cast<const char *>(&BINARY_BOM), sizeof(BINARY_BOM));
+    out.write(reinterpret_cast<const char *>(&BINARY_VERSION), sizeof(BINARY_VERSION));
+    out.write(reinterpret_cast<const char *>(&num_points), sizeof(num_points));
+    for (size_t i = 0; i < _freqs.size(); i++){
+        const double values[3] = {_freqs[i], _corrs[i].real(), _corrs[i].imag()};
+        out.write(reinterpret_cast<const char *>(values), sizeof(values));
+    }
+}
+
+/***********************************************************************
+ * Table cache
+ **********************************************************************/
+//! Identifies the contents of a CSV file: its size and FNV-1a hash
+struct csv_stamp_t{
+    boost::uint64_t size;
+    boost::uint64_t hash;
+
+    bool operator==(const csv_stamp_t &other) const{
+        return size == other.size and hash == other.hash;
+    }
+};
+
+static csv_stamp_t get_csv_stamp(const std::string &csv_data)
+{
+    csv_stamp_t stamp;
+    stamp.size = csv_data.size();
+    stamp.hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < csv_data.size(); i++){
+        stamp.hash = (stamp.hash ^ boost::uint8_t(csv_data[i]))*0x100000001b3ULL;
+    }
+    return stamp;
+}
+
+//! Identifies a version of a file without reading it: its size and mtime.
+//! The mtime only has a resolution of one second, so a stamp taken in the
+//! same second as the last write cannot rule out later writes in it.
+struct file_stamp_t{
+    file_stamp_t(void): size(0), mtime(0), taken(0){}
+    boost::uintmax_t size;
+    std::time_t mtime;
+    std::time_t taken;
+
+    bool is_unchanged(const file_stamp_t &now) const{
+        return size == now.size and mtime == now.mtime and mtime < taken;
+    }
+};
+
+static bool get_file_stamp(const std::string &path, file_stamp_t &stamp)
+{
+    boost::system::error_code ec;
+    stamp.taken = std::time(NULL);
+    stamp.size = fs::file_size(path, ec);
+    if (ec) return false;
+    stamp.mtime = fs::last_write_time(path, ec);
+    return not ec;
+}
+
+struct fe_cal_cache_entry_t{
+    file_stamp_t file_stamp;
+    csv_stamp_t stamp;
+    fe_cal_table::sptr table;
+};
+
+typedef std::map<std::string, fe_cal_cache_entry_t> fe_cal_cache_t;
+UHD_SINGLETON_FCN(fe_cal_cache_t, get_fe_cal_cache);
+UHD_SINGLETON_FCN(boost::mutex, get_fe_cal_cache_mutex);
+
+//cache file: the stamp of the CSV file it was made from, then the table
+//in the binary format. It is only used when the stamp matches exactly.
+static fe_cal_table::sptr load_binary(const fs::path &bin_path, const csv_stamp_t &csv_stamp)
+{
+    std::ifstream bin_data(bin_path.string().c_str(), std::ifstream::binary);
+    if (not bin_data) return fe_cal_table::sptr();
+
+    csv_stamp_t bin_stamp;
+    bin_data.read(reinterpret_cast<char *>(&bin_stamp.size), sizeof(bin_stamp.size));
+    bin_data.read(reinterpret_cast<char *>(&bin_stamp.hash), sizeof(bin_stamp.hash));
+    if (not bin_data or not (bin_stamp == csv_stamp)){
+        UHD_LOGGER_DEBUG("CAL") << "Ignoring " << bin_path.string() << ": made from a different CSV file";
+        return fe_cal_table::sptr();
+    }
+
+    try{
+        return fe_cal_table::from_binary(bin_data);
+    }
+    catch(const uhd::value_error &e){
+        UHD_LOGGER_DEBUG("CAL") << "Ignoring " << bin_path.string() << ": " << e.what();
+        return fe_cal_table::sptr();
+    }
+}
+
+static void store_binary(const fs::path &bin_path, const csv_stamp_t &csv_stamp, fe_cal_table::sptr table)
+{
+    //write next to the final file and rename, other processes may be loading it.
+    //The calibration directory may well be read-only, that only costs the cache.
+    boost::system::error_code ec;
+    const fs::path tmp_path = bin_path.string() + fs::unique_path(".%%%%%%%%.tmp", ec).string();
+    {
+        std::ofstream bin_data(tmp_path.string().c_str(), std::ofstream::binary);
+        bin_data.write(reinterpret_cast<const char *>(&csv_stamp.size), sizeof(csv_stamp.size));
+        bin_data.write(reinterpret_cast<const char *>(&csv_stamp.hash), sizeof(csv_stamp.hash));
+        table->to_binary(bin_data);
+        bin_data.close();
+        if (ec or not bin_data){
+            fs::remove(tmp_path, ec);
+            UHD_LOGGER_DEBUG("CAL") << "Could not write " << tmp_path.string();
+            return;
+        }
+    }
+    fs::rename(tmp_path, bin_path, ec);
+    if (ec){
+        fs::remove(tmp_path, ec);
+        UHD_LOGGER_DEBUG("CAL") << "Could not write " << bin_path.string();
+        return;
+    }
+    UHD_LOGGER_INFO("CAL") << "Calibration cache written: " << bin_path.string();
+}
+
+fe_cal_table::sptr fe_cal_table::load(const std::string &csv_path)
+{
+    //this runs on every retune: while the size and mtime of the file are
+    //unchanged, don't even read it. Stamp before reading, so that a write
+    //in between shows up as a change next time.
+    file_stamp_t file_stamp;
+    const bool has_file_stamp = get_file_stamp(csv_path, file_stamp);
+    if (has_file_stamp){
+        boost::mutex::scoped_lock lock(get_fe_cal_cache_mutex());
+        fe_cal_cache_t::const_iterator it = get_fe_cal_cache().find(csv_path);
+        if (it != get_fe_cal_cache().end() and it->second.file_stamp.is_unchanged(file_stamp)){
+            return it->second.table;
+        }
+    }
+
+    //read the whole file, the stamp needs it and it is small next to parsing
+    std::ifstream csv_file(csv_path.c_str(), std::ifstream::binary);
+    if (not csv_file) return sptr(); //no such file
+    std::ostringstream csv_buff;
+    csv_buff << csv_file.rdbuf();
+    const std::string csv_data = csv_buff.str();
+    const csv_stamp_t csv_stamp = get_csv_stamp(csv_data);
+
+    boost::mutex::scoped_lock lock(get_fe_cal_cache_mutex());
+    fe_cal_cache_t::iterator it = get_fe_cal_cache().find(csv_path);
+    if (it != get_fe_cal_cache().end() and it->second.stamp == csv_stamp){
+        it->second.file_stamp = file_stamp;
+        return it->second.table;
+    }
+
+    const fs::path bin_path = fs::path(csv_path).replace_extension(".bin");
+    sptr table = load_binary(bin_path, csv_stamp);
+    if (not table){
+        std::istringstream cal_data(csv_data);
+        try{
+            table = from_csv(cal_data);
+        }
+        catch(const uhd::value_error &){
+            table = make(std::vector<point_t>());
+        }
+        if (table->size() > 0) store_binary(bin_path, csv_stamp, table);
+    }
+    if (table->size() == 0) throw uhd::runtime_error("empty calibration table " + csv_path);
+
+    fe_cal_cache_entry_t &entry = get_fe_cal_cache()[csv_path];
+    entry.file_stamp = file_stamp;
+    entry.stamp = csv_stamp;
+    entry.table = table;
+    UHD_LOGGER_INFO("CAL") << "Calibration data loaded: " << csv_path;
+    return table;
+}
@@ -0,0 +1,110 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_CAL_FE_CAL_TABLE_HPP
+#define INCLUDED_UHD_CAL_FE_CAL_TABLE_HPP
+
+#include <uhd/config.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <complex>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace uhd {
+namespace cal {
+
+/*!
+ * A frontend calibration table (IQ balance or DC offset vs. LO frequency).
+ *
+ * The points are kept sorted in flat arrays, so a lookup is a binary
+ * search plus one linear interpolation. Tables are immutable once made
+ * and can be shared between channels and threads.
+ */
+class UHD_API fe_cal_table : boost::noncopyable {
+public:
+    typedef boost::shared_ptr<const fe_cal_table> sptr;
+
+    struct point_t {
+        double lo_freq;
+        std::complex<double> corr;
+    };
+
+    /*!
+     * Make a table from a set of points (in any order).
+     */
+    static sptr make(const std::vector<point_t> &points);
+
+    /*!
+     * Parse a table from the CSV format written by the uhd_cal_* utilities.
+     * \throws uhd::value_error if there is no data section
+     */
+    static sptr from_csv(std::istream &in);
+
+    /*!
+     * Read a table in the binary format written by to_binary().
+     * \throws uhd::value_error if the data is not a valid table
+     */
+    static sptr from_binary(std::istream &in);
+
+    /*!
+     * Write the table in a binary format that loads without parsing.
+     */
+    void to_binary(std::ostream &out) const;
+
+    /*!
+     * Load the table for a CSV calibration file.
+     *
+     * Tables are cached per path until the file changes. The file is
+     * only read again when its size or modification time changed, or
+     * when it was modified within the second of the last check.
+     * A binary copy of the table is kept next to the CSV file (same name,
+     * ".bin" extension) and is used instead of parsing the CSV file as
+     * long as it was made from the same CSV contents (size and hash).
+     * The binary copy is skipped if the directory is not writable.
+     *
+     * \param csv_path path to the CSV calibration file
+     * \returns the table, or a null pointer if the file does not exist
+     * \throws uhd::runtime_error if the file holds no calibration data
+     */
+    static sptr load(const std::string &csv_path);
+
+    /*!
+     * Get the correction for an LO frequency.
+     * Values between points are linearly interpolated, values outside
+     * the table take the value of the nearest point.
+     */
+    std::complex<double> get(const double lo_freq) const;
+
+    //! Get the number of points in the table
+    size_t size(void) const{
+        return _freqs.size();
+    }
+
+private:
+    fe_cal_table(const std::vector<point_t> &points);
+
+    std::vector<double> _freqs;
+    std::vector<std::complex<double> > _corrs;
+};
+
+} // namespace cal
+} // namespace uhd
+
+#endif /* INCLUDED_UHD_CAL_FE_CAL_TABLE_HPP */
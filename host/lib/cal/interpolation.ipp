@@ -50,19 +50,19 @@ CAL_INTERP_METHOD(in_type, calc_dist, const ARGS_T &a, const ARGS_T &b)
 CAL_INTERP_METHOD(const out_type, nn_interp, CONTAINER_T &data, const ARGS_T &args)
 {
     // Check the cache for the output
-    if (data.find(args) != data.end()) {
-        return data[args];
+    typename container_t::const_iterator citer = data.find(args);
+    if (citer != data.end()) {
+        return citer->second;
     }
 
     out_type output = 0;
     in_type min_dist = 0;
-    typename container_t::const_iterator citer;
     for (citer = data.begin(); citer != data.end(); citer++)
     {
         in_type dist = calc_dist(citer->first, args);
         if (citer == data.begin() || dist < min_dist) {
             min_dist = dist;
-            output = data[citer->first];
+            output = citer->second;
         }
     }
 
@@ -85,33 +85,28 @@ CAL_INTERP_METHOD(const out_type, bl_interp, CONTAINER_T &data, const ARGS_T &ar
         ));
     }
 
-    // Locate the nearest 4 points
+    // Locate the nearest 4 points in a single pass,
+    // earlier points win on equal distance
     typedef std::pair<interp<in_type, out_type>::args_t, out_type> cal_pair_t;
-    typename std::vector<cal_pair_t> nearest;
+    typedef std::pair<in_type, typename container_t::const_iterator> dist_pair_t;
+    dist_pair_t nearest_dists[4];
+    size_t num_nearest = 0;
 
-    // Initialize the resulting pair to something
-    cal_pair_t pair = *data.begin();
+    typename container_t::const_iterator citer;
+    for (citer = data.begin(); citer != data.end(); citer++)
+    {
+        const in_type dist = calc_dist(citer->first, args);
+        if (num_nearest == 4 and not (dist < nearest_dists[3].first)) continue;
+        size_t i = (num_nearest < 4)? num_nearest++ : 3;
+        for (; i > 0 and dist < nearest_dists[i-1].first; i--) {
+            nearest_dists[i] = nearest_dists[i-1];
+        }
+        nearest_dists[i] = dist_pair_t(dist, citer);
+    }
 
+    typename std::vector<cal_pair_t> nearest;
     for (size_t i = 0; i < 4; i++) {
-        bool init = true;
-        in_type min_dist = 0;
-        typename container_t::const_iterator citer;
-        for (citer = data.begin(); citer != data.end(); citer++)
-        {
-            cal_pair_t temp = *citer;
-            if (std::find(nearest.begin(), nearest.end(), temp) == nearest.end())
-            {
-                in_type dist = calc_dist(citer->first, args);
-                if (dist < min_dist || init)
-                {
-                    min_dist = dist;
-                    pair = temp;
-                    init = false;
-                }
-            }
-        }
-        // Push back the nearest pair
-        nearest.push_back(pair);
+        nearest.push_back(*nearest_dists[i].second);
     }
 
     //
@@ -0,0 +1,167 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+#include <emmintrin.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace uhd::convert;
+
+/*
+ * These replace the lookup tables in convert_with_tables.cpp. The scaling is
+ * the same (out = round(in * scalar / 32767), rounding half away from zero),
+ * but out-of-range values saturate instead of wrapping around, like the other
+ * SSE2 sc8 converters.
+ */
+
+// scalar version of the conversion below, for the remainder samples
+UHD_INLINE uint8_t sc16_x1_to_sc8(const int16_t in, const float scalar)
+{
+    const float val = float(in) * scalar;
+    const float rounded = (val < 0) ? std::ceil(val - 0.5f) : std::floor(val + 0.5f);
+    return uint8_t(int8_t(std::max(-128.f, std::min(127.f, rounded))));
+}
+
+template <xtox_t to_wire>
+UHD_INLINE void sc16_to_item32_sc8(
+    const sc16_t *input,
+    item32_t *output,
+    const size_t nsamps,
+    const float scalar
+){
+    const size_t num_pairs = nsamps/2;
+    for (size_t i = 0, j = 0; i < num_pairs; i++, j+=2){
+        const item32_t item =
+            (item32_t(sc16_x1_to_sc8(input[j].real(), scalar)) << 24) |
+            (item32_t(sc16_x1_to_sc8(input[j].imag(), scalar)) << 16) |
+            (item32_t(sc16_x1_to_sc8(input[j+1].real(), scalar)) << 8) |
+            (item32_t(sc16_x1_to_sc8(input[j+1].imag(), scalar)) << 0);
+        output[i] = to_wire(item);
+    }
+
+    if (nsamps != num_pairs*2){
+        const item32_t item =
+            (item32_t(sc16_x1_to_sc8(input[nsamps-1].real(), scalar)) << 24) |
+            (item32_t(sc16_x1_to_sc8(input[nsamps-1].imag(), scalar)) << 16);
+        output[num_pairs] = to_wire(item);
+    }
+}
+
+// sign-extend, scale, and round half away from zero 4 values
+UHD_INLINE __m128i scale_sc16_4x(
+    const __m128i &in, const __m128 &scalar
+){
+    const __m128 sign_mask = _mm_set_ps1(-0.f);
+    const __m128 half = _mm_set_ps1(0.5f);
+    const __m128 val = _mm_mul_ps(_mm_cvtepi32_ps(in), scalar);
+    const __m128 offset = _mm_or_ps(half, _mm_and_ps(val, sign_mask));
+    return _mm_cvttps_epi32(_mm_add_ps(val, offset));
+}
+
+template <const int shuf>
+UHD_INLINE __m128i pack_sc16_8x(
+    const __m128i &in0, const __m128i &in1, const __m128 &scalar
+){
+    const __m128i zeroi = _mm_setzero_si128();
+
+    //sign-extend to 32 bits: move to upper half, shift back down
+    __m128i tmpi0 = scale_sc16_4x(_mm_srai_epi32(_mm_unpacklo_epi16(zeroi, in0), 16), scalar);
+    tmpi0 = _mm_shuffle_epi32(tmpi0, shuf);
+    __m128i tmpi1 = scale_sc16_4x(_mm_srai_epi32(_mm_unpackhi_epi16(zeroi, in0), 16), scalar);
+    tmpi1 = _mm_shuffle_epi32(tmpi1, shuf);
+    const __m128i lo = _mm_packs_epi32(tmpi0, tmpi1);
+
+    __m128i tmpi2 = scale_sc16_4x(_mm_srai_epi32(_mm_unpacklo_epi16(zeroi, in1), 16), scalar);
+    tmpi2 = _mm_shuffle_epi32(tmpi2, shuf);
+    __m128i tmpi3 = scale_sc16_4x(_mm_srai_epi32(_mm_unpackhi_epi16(zeroi, in1), 16), scalar);
+    tmpi3 = _mm_shuffle_epi32(tmpi3, shuf);
+    const __m128i hi = _mm_packs_epi32(tmpi2, tmpi3);
+
+    return _mm_packs_epi16(lo, hi);
+}
+
+DECLARE_CONVERTER(sc16, 1, sc8_item32_be, 1, PRIORITY_SIMD){
+    const sc16_t *input = reinterpret_cast<const sc16_t *>(inputs[0]);
+    item32_t *output = reinterpret_cast<item32_t *>(outputs[0]);
+
+    const float scalar_f = float(scale_factor/32767.);
+    const __m128 scalar = _mm_set_ps1(scalar_f);
+    const int shuf = _MM_SHUFFLE(3, 2, 1, 0);
+
+    #define convert_sc16_1_to_sc8_item32_1_bswap_guts(_al_)             \
+    for (size_t j = 0; i+7 < nsamps; i+=8, j+=4){                       \
+        /* load from input */                                           \
+        __m128i tmp0 = _mm_load ## _al_ ## si128(reinterpret_cast<const __m128i *>(input+i+0)); \
+        __m128i tmp1 = _mm_load ## _al_ ## si128(reinterpret_cast<const __m128i *>(input+i+4)); \
+                                                                        \
+        /* convert */                                                   \
+        const __m128i tmpi = pack_sc16_8x<shuf>(tmp0, tmp1, scalar);    \
+                                                                        \
+        /* store to output */                                           \
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output+j), tmpi);  \
+    }                                                                   \
+
+    size_t i = 0;
+
+    //dispatch according to alignment
+    if ((size_t(input) & 0xf) == 0){
+        convert_sc16_1_to_sc8_item32_1_bswap_guts(_)
+    }
+    else{
+        convert_sc16_1_to_sc8_item32_1_bswap_guts(u_)
+    }
+
+    //convert remainder
+    sc16_to_item32_sc8<uhd::htonx>(input+i, output+(i/2), nsamps-i, scalar_f);
+}
+
+DECLARE_CONVERTER(sc16, 1, sc8_item32_le, 1, PRIORITY_SIMD){
+    const sc16_t *input = reinterpret_cast<const sc16_t *>(inputs[0]);
+    item32_t *output = reinterpret_cast<item32_t *>(outputs[0]);
+
+    const float scalar_f = float(scale_factor/32767.);
+    const __m128 scalar = _mm_set_ps1(scalar_f);
+    const int shuf = _MM_SHUFFLE(0, 1, 2, 3);
+
+    #define convert_sc16_1_to_sc8_item32_1_nswap_guts(_al_)             \
+    for (size_t j = 0; i+7 < nsamps; i+=8, j+=4){                       \
+        /* load from input */                                           \
+        __m128i tmp0 = _mm_load ## _al_ ## si128(reinterpret_cast<const __m128i *>(input+i+0)); \
+        __m128i tmp1 = _mm_load ## _al_ ## si128(reinterpret_cast<const __m128i *>(input+i+4)); \
+                                                                        \
+        /* convert */                                                   \
+        const __m128i tmpi = pack_sc16_8x<shuf>(tmp0, tmp1, scalar);    \
+                                                                        \
+        /* store to output */                                           \
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output+j), tmpi);  \
+    }                                                                   \
+
+    size_t i = 0;
+
+    //dispatch according to alignment
+    if ((size_t(input) & 0xf) == 0){
+        convert_sc16_1_to_sc8_item32_1_nswap_guts(_)
+    }
+    else{
+        convert_sc16_1_to_sc8_item32_1_nswap_guts(u_)
+    }
+
+    //convert remainder
+    sc16_to_item32_sc8<uhd::htowx>(input+i, output+(i/2), nsamps-i, scalar_f);
+}
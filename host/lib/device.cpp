@@ -19,6 +19,7 @@
 #include <uhd/types/dict.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/utils/log.hpp>
+#include <uhd/utils/thread_priority.hpp>
 
 #include <uhd/utils/static.hpp>
 #include <uhd/utils/algorithm.hpp>
@@ -166,6 +167,9 @@ device::sptr device::make(const device_addr_t &hint, device_filter_t filter, siz
     }
     else {
         //create and register a new device
+        //the thread placement policy is per process: threads started from
+        //here on follow the args of the most recently created device
+        set_thread_placement(dev_addr);
         device::sptr dev = maker(dev_addr);
         hash_to_device[dev_hash] = dev;
         return dev;
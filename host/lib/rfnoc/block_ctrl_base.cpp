@@ -237,20 +237,23 @@ void block_ctrl_base::sr_write(const uint32_t reg, const uint32_t data, const si
     }
 }
 
-void block_ctrl_base::sr_write(const std::string &reg, const uint32_t data, const size_t port)
+uint32_t block_ctrl_base::_get_sr_addr(const std::string &reg) const
 {
-    uint32_t reg_addr = 255;
     if (DEFAULT_NAMED_SR.has_key(reg)) {
-        reg_addr = DEFAULT_NAMED_SR[reg];
-    } else {
-        if (not _tree->exists(_root_path / "registers" / "sr" / reg)) {
-            throw uhd::key_error(str(
-                    boost::format("Unknown settings register name: %s")
-                    % reg
-            ));
-        }
-        reg_addr = uint32_t(_tree->access<size_t>(_root_path / "registers" / "sr" / reg).get());
+        return DEFAULT_NAMED_SR[reg];
+    }
+    if (not _tree->exists(_root_path / "registers" / "sr" / reg)) {
+        throw uhd::key_error(str(
+                boost::format("Unknown settings register name: %s")
+                % reg
+        ));
     }
+    return uint32_t(_tree->access<size_t>(_root_path / "registers" / "sr" / reg).get());
+}
+
+void block_ctrl_base::sr_write(const std::string &reg, const uint32_t data, const size_t port)
+{
+    const uint32_t reg_addr = _get_sr_addr(reg);
     UHD_BLOCK_LOG() << "  ";
     UHD_RFNOC_BLOCK_TRACE() << boost::format("sr_write(%s, %08X) ==> ") % reg % data ;
     return sr_write(reg_addr, data, port);
@@ -295,7 +298,7 @@ uint64_t block_ctrl_base::user_reg_read64(const uint32_t addr, const size_t port
     }
 }
 
-uint64_t block_ctrl_base::user_reg_read64(const std::string &reg, const size_t port)
+uint32_t block_ctrl_base::_get_user_reg_addr(const std::string &reg) const
 {
     if (not _tree->exists(_root_path / "registers" / "rb" / reg)) {
         throw uhd::key_error(str(
@@ -303,9 +306,12 @@ uint64_t block_ctrl_base::user_reg_read64(const std::string &reg, const size_t p
                 % reg
         ));
     }
-    return user_reg_read64(uint32_t(
-        _tree->access<size_t>(_root_path / "registers" / "rb" / reg).get()
-    ), port);
+    return uint32_t(_tree->access<size_t>(_root_path / "registers" / "rb" / reg).get());
+}
+
+uint64_t block_ctrl_base::user_reg_read64(const std::string &reg, const size_t port)
+{
+    return user_reg_read64(_get_user_reg_addr(reg), port);
 }
 
 uint32_t block_ctrl_base::user_reg_read32(const uint32_t addr, const size_t port)
@@ -334,6 +340,41 @@ uint32_t block_ctrl_base::user_reg_read32(const std::string &reg, const size_t p
     ), port);
 }
 
+wb_iface::sptr block_ctrl_base::_get_ctrl_iface_checked(const size_t port, const std::string &what) const
+{
+    if (not _ctrl_ifaces.count(port)) {
+        throw uhd::key_error(str(boost::format("[%s] %s(): No such port: %d") % get_block_id().get() % what % port));
+    }
+    return _ctrl_ifaces.at(port);
+}
+
+void block_ctrl_base::sr_write(ctrl_transaction::sptr transaction, const uint32_t reg, const uint32_t data, const size_t port)
+{
+    transaction->add_poke32(_get_ctrl_iface_checked(port, "sr_write"), _sr_to_addr(reg), data);
+}
+
+void block_ctrl_base::sr_write(ctrl_transaction::sptr transaction, const std::string &reg, const uint32_t data, const size_t port)
+{
+    sr_write(transaction, _get_sr_addr(reg), data, port);
+}
+
+size_t block_ctrl_base::sr_read64(ctrl_transaction::sptr transaction, const settingsbus_reg_t reg, const size_t port)
+{
+    return transaction->add_peek64(_get_ctrl_iface_checked(port, "sr_read64"), _sr_to_addr64(reg));
+}
+
+size_t block_ctrl_base::user_reg_read64(ctrl_transaction::sptr transaction, const uint32_t addr, const size_t port)
+{
+    // Same as user_reg_read64(), but the readback waits for the transaction
+    sr_write(transaction, SR_READBACK_ADDR, addr, port);
+    return sr_read64(transaction, SR_READBACK_REG_USER, port);
+}
+
+size_t block_ctrl_base::user_reg_read64(ctrl_transaction::sptr transaction, const std::string &reg, const size_t port)
+{
+    return user_reg_read64(transaction, _get_user_reg_addr(reg), port);
+}
+
 void block_ctrl_base::set_command_time(
         const time_spec_t &time_spec,
         const size_t port
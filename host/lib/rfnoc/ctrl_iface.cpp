@@ -29,6 +29,8 @@
 #include <boost/format.hpp>
 #include <boost/bind.hpp>
 #include <queue>
+#include <map>
+#include <set>
 
 using namespace uhd;
 using namespace uhd::rfnoc;
@@ -126,6 +128,59 @@ public:
         _tick_rate = rate;
     }
 
+    /*******************************************************************
+     * Batched peeks and pokes
+     ******************************************************************/
+    void send_batch(std::vector<batch_op_t> &ops)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        std::vector<batch_op_t>::iterator op = ops.begin();
+        try {
+            for (; op != ops.end(); ++op) {
+                if (op->readback) {
+                    op->seq = _seq_out;
+                    _batch_seqs.insert(op->seq);
+                    this->send_pkt(_rb_address, op->addr/8);
+                } else {
+                    this->send_pkt(op->addr/4, op->data);
+                }
+                this->wait_for_ack(false);
+            }
+        }
+        catch(...) {
+            //forget about the readbacks sent so far, and the one that failed
+            _forget_batch(ops.begin(), (op == ops.end())? op : op + 1);
+            throw;
+        }
+    }
+
+    void recv_batch(std::vector<batch_op_t> &ops)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        try {
+            for(batch_op_t &op:  ops) {
+                if (not op.readback) continue;
+                while (not _batch_results.count(op.seq)) {
+                    UHD_ASSERT_THROW(not _outstanding_seqs.empty());
+                    this->recv_ack();
+                }
+                op.result = _batch_results[op.seq];
+                _batch_results.erase(op.seq);
+            }
+        }
+        catch(...) {
+            //forget about the rest of this batch
+            _forget_batch(ops.begin(), ops.end());
+            throw;
+        }
+    }
+
+    void cancel_batch(const std::vector<batch_op_t> &ops)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _forget_batch(ops.begin(), ops.end());
+    }
+
 private:
     // This is the buffer type for response messages
     struct resp_buff_type
@@ -136,6 +191,17 @@ private:
     /*******************************************************************
      * Primary control and interaction private methods
      ******************************************************************/
+    //! Stop keeping the readback values of these batch ops, needs the lock
+    template <typename iterator_type>
+    void _forget_batch(const iterator_type begin, const iterator_type end)
+    {
+        for (iterator_type op = begin; op != end; ++op) {
+            if (not op->readback) continue;
+            _batch_seqs.erase(op->seq);
+            _batch_results.erase(op->seq);
+        }
+    }
+
     inline void send_pkt(const uint32_t addr, const uint32_t data = 0)
     {
         managed_send_buffer::sptr buff = _ctrl_xport->get_send_buff(0.0);
@@ -180,92 +246,107 @@ private:
     {
         while (readback or (_outstanding_seqs.size() >= _resp_queue_size))
         {
-            //get seq to ack from outstanding packets list
             UHD_ASSERT_THROW(not _outstanding_seqs.empty());
-            const size_t seq_to_ack = _outstanding_seqs.front();
-            _outstanding_seqs.pop();
-
-            //parse the packet
-            vrt::if_packet_info_t packet_info;
-            resp_buff_type resp_buff;
-            memset(&resp_buff, 0x00, sizeof(resp_buff));
-            uint32_t const *pkt = NULL;
-            managed_recv_buffer::sptr buff;
-
-            buff = _resp_xport->get_recv_buff(_timeout);
-            try {
-                UHD_ASSERT_THROW(bool(buff));
-                UHD_ASSERT_THROW(buff->size() > 0);
-            }
-            catch(const std::exception &ex) {
-                throw uhd::io_error(str(boost::format("Block ctrl (%s) no response packet - %s") % _name % ex.what()));
-            }
-            pkt = buff->cast<const uint32_t *>();
-            packet_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
+            const uint64_t value = this->recv_ack();
 
-            //parse the buffer
-            try
+            //return the readback value
+            if (readback and _outstanding_seqs.empty())
             {
-                packet_info.link_type = _link_type;
-                if (_bige) vrt::chdr::if_hdr_unpack_be(pkt, packet_info);
-                else vrt::chdr::if_hdr_unpack_le(pkt, packet_info);
-            }
-            catch(const std::exception &ex)
-            {
-                UHD_LOGGER_ERROR("RFNOC") << "[" << _name << "] Block ctrl bad VITA packet: " << ex.what() ;
-                if (buff){
-                    UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[0] ;
-                    UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[1] ;
-                    UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[2] ;
-                    UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[3] ;
-                }
-                else{
-                    UHD_LOGGER_INFO("RFNOC") << "buff is NULL" ;
-                }
+                return value;
             }
+        }
 
-            //check the buffer
-            try
-            {
-                UHD_ASSERT_THROW(packet_info.has_sid);
-                if (packet_info.sid != uint32_t((_sid >> 16) | (_sid << 16))) {
-                    throw uhd::io_error(
-                        str(
-                            boost::format("Expected SID: %s  Received SID: %s")
-                            % uhd::sid_t(_sid).reversed().to_pp_string_hex()
-                            % uhd::sid_t(packet_info.sid).to_pp_string_hex()
-                        )
-                    );
-                }
+        return 0;
+    }
 
-                if (packet_info.packet_count != (seq_to_ack & 0xfff)) {
-                    throw uhd::io_error(
-                        str(
-                            boost::format("Expected packet index: %d  Received index: %d")
-                            % packet_info.packet_count
-                            % (seq_to_ack & 0xfff)
-                        )
-                    );
-                }
+    //! Receive the response to the oldest outstanding packet and return its value
+    UHD_INLINE uint64_t recv_ack(void)
+    {
+        //get seq to ack from outstanding packets list
+        const size_t seq_to_ack = _outstanding_seqs.front();
+        _outstanding_seqs.pop();
+
+        //parse the packet
+        vrt::if_packet_info_t packet_info;
+        resp_buff_type resp_buff;
+        memset(&resp_buff, 0x00, sizeof(resp_buff));
+        uint32_t const *pkt = NULL;
+        managed_recv_buffer::sptr buff;
+
+        buff = _resp_xport->get_recv_buff(_timeout);
+        try {
+            UHD_ASSERT_THROW(bool(buff));
+            UHD_ASSERT_THROW(buff->size() > 0);
+        }
+        catch(const std::exception &ex) {
+            throw uhd::io_error(str(boost::format("Block ctrl (%s) no response packet - %s") % _name % ex.what()));
+        }
+        pkt = buff->cast<const uint32_t *>();
+        packet_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
 
-                UHD_ASSERT_THROW(packet_info.num_payload_words32 == 2);
-                //UHD_ASSERT_THROW(packet_info.packet_type == _packet_type);
+        //parse the buffer
+        try
+        {
+            packet_info.link_type = _link_type;
+            if (_bige) vrt::chdr::if_hdr_unpack_be(pkt, packet_info);
+            else vrt::chdr::if_hdr_unpack_le(pkt, packet_info);
+        }
+        catch(const std::exception &ex)
+        {
+            UHD_LOGGER_ERROR("RFNOC") << "[" << _name << "] Block ctrl bad VITA packet: " << ex.what() ;
+            if (buff){
+                UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[0] ;
+                UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[1] ;
+                UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[2] ;
+                UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[3] ;
             }
-            catch(const std::exception &ex)
-            {
-                throw uhd::io_error(str(boost::format("Block ctrl (%s) packet parse error - %s") % _name % ex.what()));
+            else{
+                UHD_LOGGER_INFO("RFNOC") << "buff is NULL" ;
             }
+        }
 
-            //return the readback value
-            if (readback and _outstanding_seqs.empty())
-            {
-                const uint64_t hi = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+0]) : uhd::wtohx(pkt[packet_info.num_header_words32+0]);
-                const uint64_t lo = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+1]) : uhd::wtohx(pkt[packet_info.num_header_words32+1]);
-                return ((hi << 32) | lo);
+        //check the buffer
+        try
+        {
+            UHD_ASSERT_THROW(packet_info.has_sid);
+            if (packet_info.sid != uint32_t((_sid >> 16) | (_sid << 16))) {
+                throw uhd::io_error(
+                    str(
+                        boost::format("Expected SID: %s  Received SID: %s")
+                        % uhd::sid_t(_sid).reversed().to_pp_string_hex()
+                        % uhd::sid_t(packet_info.sid).to_pp_string_hex()
+                    )
+                );
+            }
+
+            if (packet_info.packet_count != (seq_to_ack & 0xfff)) {
+                throw uhd::io_error(
+                    str(
+                        boost::format("Expected packet index: %d  Received index: %d")
+                        % packet_info.packet_count
+                        % (seq_to_ack & 0xfff)
+                    )
+                );
             }
+
+            UHD_ASSERT_THROW(packet_info.num_payload_words32 == 2);
+            //UHD_ASSERT_THROW(packet_info.packet_type == _packet_type);
+        }
+        catch(const std::exception &ex)
+        {
+            throw uhd::io_error(str(boost::format("Block ctrl (%s) packet parse error - %s") % _name % ex.what()));
         }
 
-        return 0;
+        const uint64_t hi = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+0]) : uhd::wtohx(pkt[packet_info.num_header_words32+0]);
+        const uint64_t lo = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+1]) : uhd::wtohx(pkt[packet_info.num_header_words32+1]);
+        const uint64_t value = (hi << 32) | lo;
+
+        //keep the value for a batch readback, see recv_batch()
+        if (_batch_seqs.erase(seq_to_ack))
+        {
+            _batch_results[seq_to_ack] = value;
+        }
+        return value;
     }
 
     const vrt::if_packet_info_t::link_type_t _link_type;
@@ -283,6 +364,10 @@ private:
     double _timeout;
     std::queue<size_t> _outstanding_seqs;
     const size_t _resp_queue_size;
+    //! Sequence numbers of batch readbacks without a response yet
+    std::set<size_t> _batch_seqs;
+    //! Batch readback values not yet picked up by recv_batch()
+    std::map<size_t, uint64_t> _batch_results;
 
     const size_t _rb_address;
 };
@@ -25,6 +25,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/utility.hpp>
 #include <string>
+#include <vector>
 
 namespace uhd { namespace rfnoc {
 
@@ -49,6 +50,40 @@ public:
 
     //! Set the tick rate (converting time into ticks)
     virtual void set_tick_rate(const double rate) = 0;
+
+    //! One register access of a batch, see send_batch()
+    struct batch_op_t
+    {
+        batch_op_t(const bool readback_, const wb_addr_type addr_, const uint32_t data_ = 0) :
+            readback(readback_), addr(addr_), data(data_), seq(0), result(0)
+        {}
+
+        //! True for a 64-bit readback of addr, false to poke data to addr
+        bool readback;
+        wb_addr_type addr;
+        uint32_t data;
+        //! Filled in by send_batch()
+        size_t seq;
+        //! The readback value, filled in by recv_batch()
+        uint64_t result;
+    };
+
+    /*!
+     * Send all commands of a batch without waiting for their responses,
+     * unless the response queue is full. Readback values are kept until
+     * recv_batch() picks them up, even if other calls consume the responses.
+     */
+    virtual void send_batch(std::vector<batch_op_t> &ops) = 0;
+
+    //! Wait for the readback values of a batch given to send_batch()
+    virtual void recv_batch(std::vector<batch_op_t> &ops) = 0;
+
+    /*!
+     * Forget the readback values of a batch given to send_batch() that
+     * will not be passed to recv_batch(), e.g. because an error occurred.
+     * send_batch() and recv_batch() clean up after themselves when they throw.
+     */
+    virtual void cancel_batch(const std::vector<batch_op_t> &ops) = 0;
 };
 
 }} /* namespace uhd::rfnoc */
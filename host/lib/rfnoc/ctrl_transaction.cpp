@@ -0,0 +1,202 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ctrl_iface.hpp"
+#include <uhd/rfnoc/ctrl_transaction.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/safe_call.hpp>
+#include <boost/format.hpp>
+
+using namespace uhd;
+using namespace uhd::rfnoc;
+
+ctrl_transaction::~ctrl_transaction(void)
+{
+    /* NOP */
+}
+
+class ctrl_transaction_impl : public ctrl_transaction
+{
+public:
+    ctrl_transaction_impl(void) :
+        _has_time(false),
+        _num_ops(0),
+        _num_readbacks(0)
+    {
+        /* NOP */
+    }
+
+    void add_poke32(wb_iface::sptr iface, const wb_iface::wb_addr_type addr, const uint32_t data)
+    {
+        _get_group(iface).add(ctrl_iface::batch_op_t(false, addr, data), NO_READBACK);
+        _num_ops++;
+    }
+
+    size_t add_peek64(wb_iface::sptr iface, const wb_iface::wb_addr_type addr)
+    {
+        _get_group(iface).add(ctrl_iface::batch_op_t(true, addr), _num_readbacks);
+        _num_ops++;
+        return _num_readbacks++;
+    }
+
+    void set_command_time(const time_spec_t &time_spec)
+    {
+        _time = time_spec;
+        _has_time = true;
+    }
+
+    size_t size(void) const
+    {
+        return _num_ops;
+    }
+
+    std::vector<uint64_t> execute(void)
+    {
+        std::vector<uint64_t> results(_num_readbacks, 0);
+        std::vector<iface_ops_t> groups;
+        groups.swap(_groups);
+        _num_ops = 0;
+        _num_readbacks = 0;
+        const bool has_time = _has_time;
+        _has_time = false;
+
+        // Other interfaces can only do one command at a time, and not timed.
+        // Check that before anything is sent.
+        for(iface_ops_t &group:  groups) {
+            group.ctrl = boost::dynamic_pointer_cast<ctrl_iface>(group.iface);
+            if (has_time and not group.ctrl) {
+                throw uhd::assertion_error("ctrl_transaction: Interface does not support timed commands");
+            }
+        }
+
+        // If anything fails, don't leave readbacks behind in the interfaces
+        cancel_pending_t cancel_pending(groups);
+
+        try {
+            // Send everything first, so all blocks work on their commands at once
+            for(iface_ops_t &group:  groups) {
+                if (group.ctrl) {
+                    const time_spec_t prev_time = group.ctrl->get_time();
+                    if (has_time) group.ctrl->set_time(_time);
+                    try {
+                        group.ctrl->send_batch(group.ops);
+                    }
+                    catch(...) {
+                        if (has_time) group.ctrl->set_time(prev_time);
+                        throw;
+                    }
+                    group.pending = true;
+                    if (has_time) group.ctrl->set_time(prev_time);
+                    continue;
+                }
+                for(ctrl_iface::batch_op_t &op:  group.ops) {
+                    if (op.readback) {
+                        op.result = group.iface->peek64(op.addr);
+                    } else {
+                        group.iface->poke32(op.addr, op.data);
+                    }
+                }
+            }
+            // Then collect the readbacks
+            for(iface_ops_t &group:  groups) {
+                if (group.ctrl) {
+                    // recv_batch() cleans up after itself
+                    group.pending = false;
+                    group.ctrl->recv_batch(group.ops);
+                }
+                for (size_t i = 0; i < group.ops.size(); i++) {
+                    if (group.result_index[i] != NO_READBACK) {
+                        results[group.result_index[i]] = group.ops[i].result;
+                    }
+                }
+            }
+        }
+        catch(const uhd::assertion_error &) {
+            throw;
+        }
+        catch(const std::exception &ex) {
+            throw uhd::io_error(str(boost::format("ctrl_transaction: execute() failed: %s") % ex.what()));
+        }
+
+        return results;
+    }
+
+private:
+    static const size_t NO_READBACK = size_t(-1);
+
+    //! The commands for one control interface
+    struct iface_ops_t
+    {
+        iface_ops_t(void) : pending(false) {}
+
+        void add(const ctrl_iface::batch_op_t &op, const size_t index)
+        {
+            ops.push_back(op);
+            result_index.push_back(index);
+        }
+
+        wb_iface::sptr iface;
+        ctrl_iface::sptr ctrl;
+        std::vector<ctrl_iface::batch_op_t> ops;
+        //! For every op, its index in the results or NO_READBACK
+        std::vector<size_t> result_index;
+        //! True while the ops are sent but their readbacks not received
+        bool pending;
+    };
+
+    //! Cancels the batches that are still pending when it goes out of scope
+    struct cancel_pending_t
+    {
+        cancel_pending_t(std::vector<iface_ops_t> &groups_) : groups(groups_) {}
+
+        ~cancel_pending_t(void)
+        {
+            for(iface_ops_t &group:  groups) {
+                if (not group.pending) continue;
+                UHD_SAFE_CALL(group.ctrl->cancel_batch(group.ops);)
+            }
+        }
+
+        std::vector<iface_ops_t> &groups;
+    };
+
+    iface_ops_t &_get_group(wb_iface::sptr iface)
+    {
+        if (not iface) {
+            throw uhd::value_error("ctrl_transaction: Invalid control interface");
+        }
+        for(iface_ops_t &group:  _groups) {
+            if (group.iface == iface) return group;
+        }
+        _groups.push_back(iface_ops_t());
+        _groups.back().iface = iface;
+        return _groups.back();
+    }
+
+    //! In order of first use
+    std::vector<iface_ops_t> _groups;
+    time_spec_t _time;
+    bool _has_time;
+    size_t _num_ops;
+    size_t _num_readbacks;
+};
+
+ctrl_transaction::sptr ctrl_transaction::make(void)
+{
+    return sptr(new ctrl_transaction_impl());
+}
+// vim: sw=4 et:
@@ -117,8 +117,7 @@ void block_iface::run_and_check(const std::string &code, const std::string &erro
     boost::mutex::scoped_lock local_interpreter_lock(_lil_mutex);
 
     UHD_NOCSCRIPT_LOG() << "[NocScript] Executing and asserting code: " << code ;
-    expression::sptr e = _parser->create_expr_tree(code);
-    expression_literal result = e->eval();
+    expression_literal result = _get_expr_tree(code)->eval();
     if (not result.to_bool()) {
         if (error_message.empty()) {
             throw uhd::runtime_error(str(
@@ -137,6 +136,25 @@ void block_iface::run_and_check(const std::string &code, const std::string &erro
 }
 
 
+expression::sptr block_iface::get_expr_tree(const std::string &code)
+{
+    boost::mutex::scoped_lock local_interpreter_lock(_lil_mutex);
+    return _get_expr_tree(code);
+}
+
+expression::sptr block_iface::_get_expr_tree(const std::string &code)
+{
+    // Trees look up arguments and call functions at eval() time, so a tree
+    // parsed once can be evaluated again whenever the same code runs.
+    std::map<std::string, expression::sptr>::const_iterator it = _expr_cache.find(code);
+    if (it != _expr_cache.end()) {
+        return it->second;
+    }
+    expression::sptr e = _parser->create_expr_tree(code);
+    _expr_cache[code] = e;
+    return e;
+}
+
 expression_literal block_iface::_nocscript__sr_write(expression_container::expr_list_type args)
 {
     const std::string reg_name = args[0]->eval().get_string();
@@ -51,10 +51,20 @@ class block_iface {
      */
     void run_and_check(const std::string &code, const std::string &error_message="");
 
+    /*! Return the expression tree that run_and_check() evaluates for \p code.
+     *
+     * The code is only parsed the first time, after that the same tree is returned.
+     * \throws uhd::syntax_error if the expression is invalid.
+     */
+    expression::sptr get_expr_tree(const std::string &code);
+
   private:
     //! For the local interpreter lock (lil)
     boost::mutex _lil_mutex;
 
+    //! Return the expression tree for \p code, only parsing it the first time
+    expression::sptr _get_expr_tree(const std::string &code);
+
     //! Wrapper for block_ctrl_base::sr_write, so we can call it from within NocScript
     expression_literal _nocscript__sr_write(expression_container::expr_list_type);
 
@@ -86,6 +96,9 @@ class block_iface {
 
     //! Container for scoped variables
     std::map<std::string, expression_literal> _vars;
+
+    //! Parsed expression trees, indexed by their code
+    std::map<std::string, expression::sptr> _expr_cache;
 };
 
 }}} /* namespace uhd::rfnoc::nocscript */
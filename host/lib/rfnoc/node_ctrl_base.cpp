@@ -21,6 +21,42 @@
 
 using namespace uhd::rfnoc;
 
+void node_ctrl_base::_topology_changed()
+{
+    // Visit every node connected to this one, in either direction. This only
+    // reads the connection maps, so it also works from our destructor.
+    std::set<node_ctrl_base *> explored;
+    std::vector<node_ctrl_base *> search_q(1, this);
+    // Keeps the visited neighbours alive while we walk
+    std::vector<sptr> neighbours;
+    while (not search_q.empty()) {
+        node_ctrl_base *node = search_q.back();
+        search_q.pop_back();
+        if (not explored.insert(node).second) {
+            continue;
+        }
+        {
+            boost::mutex::scoped_lock lock(node->_search_cache_mutex);
+            node->_search_cache.clear();
+            node->_search_generation++;
+        }
+        for(const node_map_t::value_type &next:  node->_upstream_nodes) {
+            sptr next_node = next.second.lock();
+            if (next_node and not explored.count(next_node.get())) {
+                neighbours.push_back(next_node);
+                search_q.push_back(next_node.get());
+            }
+        }
+        for(const node_map_t::value_type &next:  node->_downstream_nodes) {
+            sptr next_node = next.second.lock();
+            if (next_node and not explored.count(next_node.get())) {
+                neighbours.push_back(next_node);
+                search_q.push_back(next_node.get());
+            }
+        }
+    }
+}
+
 std::string node_ctrl_base::unique_id() const
 {
     // Most instantiations will override this, so we don't need anything
@@ -32,6 +68,7 @@ void node_ctrl_base::clear()
 {
     UHD_RFNOC_BLOCK_TRACE() << "node_ctrl_base::clear() " ;
     // Reset connections:
+    _topology_changed();
     _upstream_nodes.clear();
     _downstream_nodes.clear();
 }
@@ -104,6 +141,7 @@ size_t node_ctrl_base::get_upstream_port(const size_t this_port)
 
 void node_ctrl_base::disconnect()
 {
+    _topology_changed();
     // Notify neighbours:
     for (node_map_t::iterator i = _downstream_nodes.begin(); i != _downstream_nodes.end(); ++i) {
         sptr downstream_node = i->second.lock();
@@ -134,6 +172,7 @@ void node_ctrl_base::disconnect_output_port(const size_t output_port)
         _downstream_ports.count(output_port) == 0) {
         throw uhd::assertion_error(str(boost::format("[%s] Attempting to disconnect output port %u, which is not registered as connected!") % unique_id() % output_port));
     }
+    _topology_changed();
     _downstream_nodes.erase(output_port);
     _downstream_ports.erase(output_port);
 }
@@ -144,6 +183,7 @@ void node_ctrl_base::disconnect_input_port(const size_t input_port)
         _upstream_ports.count(input_port) == 0) {
         throw uhd::assertion_error(str(boost::format("[%s] Attempting to disconnect input port %u, which is not registered as connected!") % unique_id() % input_port));
     }
+    _topology_changed();
     _upstream_nodes.erase(input_port);
     _upstream_ports.erase(input_port);
 }
@@ -89,4 +89,5 @@ void sink_node_ctrl::_register_upstream_node(
     // Alles klar, Herr Kommissar :)
 
     _upstream_nodes[port] = boost::weak_ptr<node_ctrl_base>(upstream_node);
+    _topology_changed();
 }
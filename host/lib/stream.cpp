@@ -16,15 +16,115 @@
 //
 
 #include <uhd/stream.hpp>
+#include <uhd/exception.hpp>
+#include <boost/format.hpp>
+#include <sstream>
 
 using namespace uhd;
 
+const size_t stream_stats_t::NUM_LATENCY_BUCKETS;
+
+stream_stats_t::stream_stats_t(void):
+    num_packets(0),
+    num_bytes(0),
+    num_overflows(0),
+    num_underflows(0),
+    num_seq_errors(0),
+    num_late_packets(0),
+    num_fc_stalls(0),
+    fc_stall_time(0.0),
+    convert_time(0.0),
+    call_latency(NUM_LATENCY_BUCKETS, 0),
+    xport_frames_in_flight(0),
+    xport_frame_size(0)
+{
+    //empty
+}
+
+std::string stream_stats_t::to_pp_string(void) const
+{
+    std::stringstream ss;
+    ss << boost::format("Packets: %u (%u bytes)\n") % num_packets % num_bytes;
+    ss << boost::format("Overflows: %u, underflows: %u\n") % num_overflows % num_underflows;
+    ss << boost::format("Sequence errors: %u, late packets: %u\n") % num_seq_errors % num_late_packets;
+    ss << boost::format("Flow control stalls: %u (%f s)\n") % num_fc_stalls % fc_stall_time;
+    ss << boost::format("Conversion time: %f s\n") % convert_time;
+    ss << "Call latency:";
+    for (size_t i = 0; i < call_latency.size(); i++){
+        if (call_latency[i] == 0) continue;
+        if (i+1 == call_latency.size()){
+            ss << boost::format(" >=%uus:%u") % (size_t(1) << (i-1)) % call_latency[i];
+        }
+        else{
+            ss << boost::format(" <%uus:%u") % (size_t(1) << i) % call_latency[i];
+        }
+    }
+    ss << std::endl;
+    if (xport_frames_in_flight != 0){
+        ss << boost::format("Transport: %u frames of %u bytes in flight\n") % xport_frames_in_flight % xport_frame_size;
+    }
+    return ss.str();
+}
+
 rx_streamer::~rx_streamer(void)
 {
     //empty
 }
 
+stream_stats_t rx_streamer::get_stats(void) const
+{
+    return stream_stats_t();
+}
+
+void rx_streamer::reset_stats(void)
+{
+    //empty
+}
+
+int rx_streamer::get_recv_fd(void)
+{
+    return -1;
+}
+
 tx_streamer::~tx_streamer(void)
 {
     //empty
 }
+
+void tx_streamer::set_async_callback(const async_callback_type &)
+{
+    throw uhd::not_implemented_error("this TX streamer does not support async callbacks");
+}
+
+int tx_streamer::get_async_fd(void)
+{
+    return -1;
+}
+
+int tx_streamer::get_send_fd(void)
+{
+    return -1;
+}
+
+stream_stats_t tx_streamer::get_stats(void) const
+{
+    return stream_stats_t();
+}
+
+void tx_streamer::reset_stats(void)
+{
+    //empty
+}
+
+tx_flow_ctrl_stats_t::tx_flow_ctrl_stats_t(void):
+    credit_occupancy(0.0),
+    num_stalls(0),
+    stall_time(0.0)
+{
+    //empty
+}
+
+tx_flow_ctrl_stats_t tx_streamer::get_flow_ctrl_stats(const size_t) const
+{
+    return tx_flow_ctrl_stats_t();
+}
@@ -0,0 +1,206 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "async_event_channel.hpp"
+#include "event_fd.hpp"
+#include <boost/atomic.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <cstddef>
+#include <stdint.h>
+
+using namespace uhd;
+using namespace uhd::transport;
+
+async_event_channel::~async_event_channel(void){
+    /* NOP */
+}
+
+/***********************************************************************
+ * Async event channel implementation:
+ * A bounded ring of cells, each with a sequence number that tells
+ * whose turn it is. Producers claim a cell by advancing the push
+ * position with a compare-and-swap. The consumer claims a cell the same
+ * way with the pop position, and so does a producer that finds the ring
+ * full and discards the oldest message. A consumer that runs out of
+ * messages may sleep on a condition variable, and producers only touch
+ * the mutex when it does.
+ **********************************************************************/
+class async_event_channel_impl : public async_event_channel{
+public:
+    async_event_channel_impl(const size_t capacity):
+        _size(1),
+        _push_pos(0),
+        _pop_pos(0),
+        _num_dropped(0),
+        _consumer_waiting(false),
+        _has_callback(false),
+        _fd_requested(false)
+    {
+        while (_size < capacity) _size <<= 1;
+        _cells.reset(new cell_type[_size]);
+        for (size_t i = 0; i < _size; i++){
+            _cells[i].seq = i;
+        }
+    }
+
+    bool push(const async_metadata_t &metadata){
+        if (_has_callback){
+            boost::mutex::scoped_lock lock(_callback_mutex);
+            if (_callback){
+                _callback(metadata);
+                return true;
+            }
+        }
+
+        //claim a cell
+        cell_type *cell = nullptr;
+        size_t pos = _push_pos.load(boost::memory_order_relaxed);
+        while (true){
+            cell = &_cells[pos & (_size-1)];
+            const ptrdiff_t diff = ptrdiff_t(cell->seq.load(boost::memory_order_acquire) - pos);
+            if (diff == 0){
+                if (_push_pos.compare_exchange_weak(pos, pos+1, boost::memory_order_relaxed)) break;
+            }
+            else if (diff < 0){
+                //the consumer did not free this cell yet: full,
+                //so make room by dropping the oldest message
+                async_metadata_t oldest;
+                _num_dropped++;
+                if (not this->pop(oldest)){
+                    //the oldest message is still being pushed or popped
+                    return false;
+                }
+                pos = _push_pos.load(boost::memory_order_relaxed);
+            }
+            else{
+                pos = _push_pos.load(boost::memory_order_relaxed);
+            }
+        }
+
+        //fill it and hand it to the consumer
+        cell->metadata = metadata;
+        cell->seq.store(pos+1, boost::memory_order_release);
+        this->notify();
+        return true;
+    }
+
+    bool pop(async_metadata_t &metadata){
+        //claim a cell
+        cell_type *cell = nullptr;
+        size_t pos = _pop_pos.load(boost::memory_order_relaxed);
+        while (true){
+            cell = &_cells[pos & (_size-1)];
+            const ptrdiff_t diff = ptrdiff_t(cell->seq.load(boost::memory_order_acquire) - (pos+1));
+            if (diff == 0){
+                if (_pop_pos.compare_exchange_weak(pos, pos+1, boost::memory_order_relaxed)) break;
+            }
+            else if (diff < 0){
+                //no message in this cell yet: empty
+                return false;
+            }
+            else{
+                pos = _pop_pos.load(boost::memory_order_relaxed);
+            }
+        }
+
+        //empty it and hand it back to the producers
+        metadata = cell->metadata;
+        cell->seq.store(pos+_size, boost::memory_order_release);
+        return true;
+    }
+
+    bool pop_with_timed_wait(async_metadata_t &metadata, const double timeout){
+        if (this->pop(metadata)) return true;
+        if (timeout <= 0.0) return false;
+
+        const boost::system_time exit_time = boost::get_system_time() +
+            boost::posix_time::microseconds(long(timeout*1e6));
+        boost::mutex::scoped_lock lock(_mutex);
+        _consumer_waiting = true;
+        bool popped = this->pop(metadata);
+        while (not popped){
+            if (not _cond.timed_wait(lock, exit_time)){
+                popped = this->pop(metadata);
+                break;
+            }
+            popped = this->pop(metadata);
+        }
+        _consumer_waiting = false;
+        return popped;
+    }
+
+    void set_callback(const callback_type &callback){
+        boost::mutex::scoped_lock lock(_callback_mutex);
+        _callback = callback;
+        _has_callback = bool(callback);
+    }
+
+    int get_fd(void){
+        boost::mutex::scoped_lock lock(_mutex);
+        if (not _event){
+            _event = event_fd::make();
+            _fd_requested = true;
+            //start out readable, in case messages were queued before
+            _event->signal();
+        }
+        return _event->get_fd();
+    }
+
+    size_t get_num_dropped(void) const{
+        return _num_dropped;
+    }
+
+private:
+    struct cell_type{
+        boost::atomic<size_t> seq;
+        async_metadata_t metadata;
+    };
+
+    UHD_INLINE void notify(void){
+        //make the cell visible before looking at the consumer state
+        boost::atomic_thread_fence(boost::memory_order_seq_cst);
+        if (_fd_requested) _event->signal();
+        if (_consumer_waiting){
+            boost::mutex::scoped_lock lock(_mutex);
+            _cond.notify_one();
+        }
+    }
+
+    size_t _size;
+    boost::scoped_array<cell_type> _cells;
+    boost::atomic<size_t> _push_pos;
+    boost::atomic<size_t> _pop_pos;
+    boost::atomic<size_t> _num_dropped;
+
+    boost::mutex _mutex;
+    boost::condition_variable _cond;
+    boost::atomic_bool _consumer_waiting;
+
+    boost::mutex _callback_mutex;
+    callback_type _callback;
+    boost::atomic_bool _has_callback;
+
+    event_fd::sptr _event;
+    boost::atomic_bool _fd_requested;
+};
+
+async_event_channel::sptr async_event_channel::make(const size_t capacity){
+    return sptr(new async_event_channel_impl(capacity));
+}
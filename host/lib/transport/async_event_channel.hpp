@@ -0,0 +1,108 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_ASYNC_EVENT_CHANNEL_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_ASYNC_EVENT_CHANNEL_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/metadata.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * A channel for async metadata from the device to the application.
+ *
+ * Any number of threads may push (one async handler per TX channel),
+ * one thread pops. Push and pop never take a lock, so an application
+ * that drains the channel from its own event loop does not contend
+ * with the async handlers. When the channel is full, the oldest message
+ * is dropped to make room for the new one, and counted.
+ *
+ * Instead of polling, the consumer can either register a callback,
+ * which then receives every message in the pushing thread,
+ * or wait on a file descriptor that becomes readable when messages
+ * are queued (an eventfd on Linux).
+ */
+class UHD_API async_event_channel : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<async_event_channel> sptr;
+    typedef boost::function<void(const async_metadata_t &)> callback_type;
+
+    virtual ~async_event_channel(void) = 0;
+
+    /*!
+     * Make a new async event channel.
+     * \param capacity the number of messages, rounded up to a power of two
+     * \return a new async event channel
+     */
+    static sptr make(const size_t capacity);
+
+    /*!
+     * Push a message into the channel, or hand it to the callback.
+     * This is safe to call from any number of threads.
+     * When the channel is full, the oldest message is dropped instead.
+     * \param metadata the message to push
+     * \return false in the rare case that the channel was full and the
+     *         oldest message was busy, so this message was dropped
+     */
+    virtual bool push(const async_metadata_t &metadata) = 0;
+
+    /*!
+     * Pop the oldest message without waiting.
+     * Only one thread may pop from a channel.
+     * \param metadata the message to fill in
+     * \return false when the channel is empty
+     */
+    virtual bool pop(async_metadata_t &metadata) = 0;
+
+    /*!
+     * Pop the oldest message, waiting until one arrives or timeout.
+     * Only one thread may pop from a channel.
+     * \param metadata the message to fill in
+     * \param timeout the timeout in seconds
+     * \return false when the operation times out
+     */
+    virtual bool pop_with_timed_wait(async_metadata_t &metadata, const double timeout) = 0;
+
+    /*!
+     * Deliver all future messages to a callback instead of the channel.
+     * The callback runs in the thread that pushes the message,
+     * so it should return quickly. Pass an empty function to go back
+     * to queueing the messages.
+     * \param callback the function to call for every message
+     */
+    virtual void set_callback(const callback_type &callback) = 0;
+
+    /*!
+     * Get a file descriptor that is readable while messages are queued.
+     * The descriptor is nonblocking and owned by the channel.
+     * After it polls readable, read() 8 bytes from it to clear it,
+     * and then pop() until the channel is empty.
+     * \return the file descriptor, or -1 when not supported on this platform
+     */
+    virtual int get_fd(void) = 0;
+
+    //! Get the number of messages dropped because the channel was full
+    virtual size_t get_num_dropped(void) const = 0;
+};
+
+}} //namespace
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_ASYNC_EVENT_CHANNEL_HPP */
@@ -0,0 +1,143 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "event_fd.hpp"
+#include <uhd/utils/log.hpp>
+#include <stdint.h>
+
+#if defined(HAVE_EVENTFD) || defined(HAVE_EPOLL)
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+#ifdef HAVE_EVENTFD
+#include <sys/eventfd.h>
+#endif
+
+#ifdef HAVE_EPOLL
+#include <sys/epoll.h>
+#endif
+
+using namespace uhd::transport;
+
+event_fd::~event_fd(void){
+    /* NOP */
+}
+
+event_fd_set::~event_fd_set(void){
+    /* NOP */
+}
+
+/***********************************************************************
+ * Event descriptor implementation
+ **********************************************************************/
+class event_fd_impl : public event_fd{
+public:
+    event_fd_impl(void): _fd(-1){
+        #ifdef HAVE_EVENTFD
+        _fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_fd < 0){
+            UHD_LOGGER_WARNING("XPORT") << "eventfd failed: " << std::strerror(errno);
+        }
+        #endif
+    }
+
+    ~event_fd_impl(void){
+        #ifdef HAVE_EVENTFD
+        if (_fd >= 0) ::close(_fd);
+        #endif
+    }
+
+    int get_fd(void) const{
+        return _fd;
+    }
+
+    void signal(void){
+        #ifdef HAVE_EVENTFD
+        if (_fd < 0) return;
+        const uint64_t one = 1;
+        //can only fail when the counter is about to overflow, it is readable then anyway
+        if (::write(_fd, &one, sizeof(one)) < 0) {/* NOP */}
+        #endif
+    }
+
+    void clear(void){
+        #ifdef HAVE_EVENTFD
+        if (_fd < 0) return;
+        uint64_t count;
+        //nonblocking, fails when it was not readable
+        if (::read(_fd, &count, sizeof(count)) < 0) {/* NOP */}
+        #endif
+    }
+
+private:
+    int _fd;
+};
+
+event_fd::sptr event_fd::make(void){
+    return sptr(new event_fd_impl());
+}
+
+/***********************************************************************
+ * Event descriptor set implementation
+ **********************************************************************/
+class event_fd_set_impl : public event_fd_set{
+public:
+    event_fd_set_impl(void): _fd(-1){
+        #ifdef HAVE_EPOLL
+        _fd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (_fd < 0){
+            UHD_LOGGER_WARNING("XPORT") << "epoll_create1 failed: " << std::strerror(errno);
+        }
+        #endif
+    }
+
+    ~event_fd_set_impl(void){
+        #ifdef HAVE_EPOLL
+        if (_fd >= 0) ::close(_fd);
+        #endif
+    }
+
+    int get_fd(void) const{
+        return _fd;
+    }
+
+    bool add(const int fd, const bool writable){
+        #ifdef HAVE_EPOLL
+        if (_fd < 0 or fd < 0) return false;
+        epoll_event event;
+        event.events = writable? EPOLLOUT : EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl(_fd, EPOLL_CTL_ADD, fd, &event) < 0){
+            UHD_LOGGER_WARNING("XPORT") << "epoll_ctl failed: " << std::strerror(errno);
+            return false;
+        }
+        return true;
+        #else
+        (void)fd; (void)writable;
+        return false;
+        #endif
+    }
+
+private:
+    int _fd;
+};
+
+event_fd_set::sptr event_fd_set::make(void){
+    return sptr(new event_fd_set_impl());
+}
@@ -0,0 +1,80 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_EVENT_FD_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_EVENT_FD_HPP
+
+#include <uhd/config.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * A file descriptor that UHD threads signal so that an application
+ * can wait for them in its own poll loop (an eventfd on Linux).
+ * Where this is not supported, get_fd() returns -1 and
+ * signal() and clear() do nothing.
+ */
+class UHD_API event_fd : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<event_fd> sptr;
+
+    virtual ~event_fd(void) = 0;
+
+    //! Make a new event descriptor, initially not readable
+    static sptr make(void);
+
+    //! Get the descriptor to poll, or -1 when not supported
+    virtual int get_fd(void) const = 0;
+
+    //! Make the descriptor readable (safe from any thread)
+    virtual void signal(void) = 0;
+
+    //! Make the descriptor not readable
+    virtual void clear(void) = 0;
+};
+
+/*!
+ * A file descriptor that polls readable when any descriptor
+ * in a set is ready (an epoll descriptor on Linux).
+ * Where this is not supported, get_fd() returns -1.
+ */
+class UHD_API event_fd_set : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<event_fd_set> sptr;
+
+    virtual ~event_fd_set(void) = 0;
+
+    //! Make a new, empty descriptor set
+    static sptr make(void);
+
+    //! Get the descriptor to poll, or -1 when not supported
+    virtual int get_fd(void) const = 0;
+
+    /*!
+     * Add a descriptor to the set.
+     * \param fd the descriptor
+     * \param writable true to wait for it to be writable instead of readable
+     * \return false if the descriptor could not be added
+     */
+    virtual bool add(const int fd, const bool writable = false) = 0;
+};
+
+}} //namespace
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_EVENT_FD_HPP */
@@ -25,6 +25,7 @@
 #include <boost/weak_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/bind.hpp>
+#include <boost/format.hpp>
 #include <cstdlib>
 #include <iostream>
 
@@ -43,7 +44,16 @@ public:
     libusb_session_impl(void){
         UHD_ASSERT_THROW(libusb_init(&_context) == 0);
         libusb_set_debug(_context, debug_level);
-        task_handler = task::make(boost::bind(&libusb_session_impl::libusb_event_handler_task, this, _context));
+
+        //set logging if envvar is set
+        const char *level_string = getenv("LIBUSB_DEBUG_LEVEL");
+        if (level_string != NULL)
+        {
+            const int level = int(level_string[0] - '0'); //easy conversion to integer
+            if (level >= 0 and level <= 3) libusb_set_debug(_context, level);
+        }
+
+        task_handler = task::make(boost::bind(&libusb_session_impl::libusb_event_handler_task, this, _context), "usb_event");
     }
 
     virtual ~libusb_session_impl(void);
@@ -87,6 +97,10 @@ libusb_session_impl::~libusb_session_impl(void){
     libusb_exit(_context);
 }
 
+libusb::session::sptr libusb::session::make(void){
+    return sptr(new libusb_session_impl());
+}
+
 libusb::session::sptr libusb::session::get_global_session(void){
     static boost::weak_ptr<session> global_session;
 
@@ -97,14 +111,6 @@ libusb::session::sptr libusb::session::get_global_session(void){
     sptr new_global_session(new libusb_session_impl());
     global_session = new_global_session;
 
-    //set logging if envvar is set
-    const char *level_string = getenv("LIBUSB_DEBUG_LEVEL");
-    if (level_string != NULL)
-    {
-        const int level = int(level_string[0] - '0'); //easy conversion to integer
-        if (level >= 0 and level <= 3) libusb_set_debug(new_global_session->get_context(), level);
-    }
-
     return new_global_session;
 }
 
@@ -117,8 +123,8 @@ libusb::device::~device(void) {
 
 class libusb_device_impl : public libusb::device{
 public:
-    libusb_device_impl(libusb_device *dev){
-        _session = libusb::session::get_global_session();
+    libusb_device_impl(libusb::session::sptr sess, libusb_device *dev){
+        _session = sess;
         _dev = dev;
     }
 
@@ -146,9 +152,7 @@ libusb::device_list::~device_list(void){
 
 class libusb_device_list_impl : public libusb::device_list{
 public:
-    libusb_device_list_impl(void){
-        libusb::session::sptr sess = libusb::session::get_global_session();
-
+    libusb_device_list_impl(libusb::session::sptr sess){
         //allocate a new list of devices
         libusb_device** dev_list;
         ssize_t ret = libusb_get_device_list(sess->get_context(), &dev_list);
@@ -156,7 +160,7 @@ public:
 
         //fill the vector of device references
         for (size_t i = 0; i < size_t(ret); i++) _devs.push_back(
-            libusb::device::sptr(new libusb_device_impl(dev_list[i]))
+            libusb::device::sptr(new libusb_device_impl(sess, dev_list[i]))
         );
 
         //free the device list but dont unref (done in ~device)
@@ -182,7 +186,25 @@ libusb_device_list_impl::~libusb_device_list_impl(void){
 }
 
 libusb::device_list::sptr libusb::device_list::make(void){
-    return sptr(new libusb_device_list_impl());
+    return sptr(new libusb_device_list_impl(libusb::session::get_global_session()));
+}
+
+libusb::device_list::sptr libusb::device_list::make(session::sptr sess){
+    return sptr(new libusb_device_list_impl(sess));
+}
+
+libusb::device::sptr libusb::find_device(device::sptr dev, session::sptr sess){
+    const uint8_t bus = libusb_get_bus_number(dev->get());
+    const uint8_t address = libusb_get_device_address(dev->get());
+    device_list::sptr dev_list = device_list::make(sess);
+    for (size_t i = 0; i < dev_list->size(); i++){
+        if (libusb_get_bus_number(dev_list->at(i)->get()) == bus and
+            libusb_get_device_address(dev_list->at(i)->get()) == address
+        ) return dev_list->at(i);
+    }
+    throw uhd::key_error(str(boost::format(
+        "USB device %u:%u not found in the new session") % int(bus) % int(address)
+    ));
 }
 
 /***********************************************************************
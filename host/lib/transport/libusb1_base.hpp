@@ -59,8 +59,10 @@ namespace uhd { namespace transport {
 namespace libusb {
 
     /*!
-     * This session class holds a global libusb context for this process.
+     * This session class holds a libusb context and the thread handling its events.
      * The get global session call will create a new context if none exists.
+     * A device may also use a private session, so that its transfers are
+     * completed by a thread of its own instead of the one shared by all devices.
      * When all references to session are destroyed, the context will be freed.
      */
     class session : boost::noncopyable {
@@ -81,6 +83,9 @@ namespace libusb {
         //! get a shared pointer to the global session
         static sptr get_global_session(void);
 
+        //! make a new private session with its own event thread
+        static sptr make(void);
+
         //! get the underlying libusb context pointer
         virtual libusb_context *get_context(void) const = 0;
     };
@@ -108,9 +113,12 @@ namespace libusb {
 
         virtual ~device_list(void);
 
-        //! make a new device list
+        //! make a new device list of the global session
         static sptr make(void);
 
+        //! make a new device list of the given session
+        static sptr make(session::sptr sess);
+
         //! the number of devices in this list
         virtual size_t size() const = 0;
 
@@ -181,6 +189,16 @@ namespace libusb {
         virtual device::sptr get_device(void) const = 0;
     };
 
+    /*!
+     * Find the same physical device in another session.
+     * Devices are matched by their bus number and address.
+     * \param dev a device of any session
+     * \param sess the session to search
+     * \return the device of the given session
+     * \throw uhd::key_error if the device is not found
+     */
+    device::sptr find_device(device::sptr dev, session::sptr sess);
+
 }
 
 }} //namespace
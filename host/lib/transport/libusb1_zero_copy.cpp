@@ -21,6 +21,7 @@
 #include <uhd/transport/bounded_buffer.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/exception.hpp>
+#include <boost/atomic.hpp>
 #include <boost/format.hpp>
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
@@ -42,6 +43,11 @@ using namespace uhd::transport;
 static const size_t DEFAULT_NUM_XFERS = 16;     //num xfers
 static const size_t DEFAULT_XFER_SIZE = 32*512; //bytes
 
+//! auto tuning: look at the transfers every this many buffers
+static const size_t TUNE_INTERVAL = 64;
+//! auto tuning: give back a transfer after this many looks with all of them busy
+static const size_t TUNE_SHRINK_SAMPLES = 16;
+
 //! type for sharing the release queue with managed buffers
 class libusb_zero_copy_mb;
 typedef boost::shared_ptr<bounded_buffer<libusb_zero_copy_mb *> > mb_queue_sptr;
@@ -49,12 +55,17 @@ typedef boost::shared_ptr<bounded_buffer<libusb_zero_copy_mb *> > mb_queue_sptr;
 /*!
  * The libusb docs state that status and actual length can only be read in the callback.
  * Therefore, this struct is intended to store data seen from the callback function.
+ *
+ * The completed flag is atomic so that a buffer which is already done can be taken
+ * without locking. The mutex and condition are only used when a thread has to sleep:
+ * the callback only takes the lock and notifies when the waiting flag is set.
  */
 struct lut_result_t
 {
     lut_result_t(void)
     {
         completed = 0;
+        waiting = false;
         status = LIBUSB_TRANSFER_COMPLETED;
         actual_length = 0;
 #ifdef UHD_TXRX_DEBUG_PRINTS
@@ -62,7 +73,8 @@ struct lut_result_t
         buff_num = -1;
 #endif
     }
-    int completed;
+    boost::atomic<int> completed;
+    boost::atomic<bool> waiting;
     libusb_transfer_status status;
     int actual_length;
     boost::mutex mut;
@@ -100,11 +112,15 @@ static void libusb1_zerocopy_dbg_print_err(std::string msg){
 static void LIBUSB_CALL libusb_async_cb(libusb_transfer *lut)
 {
     lut_result_t *r = (lut_result_t *)lut->user_data;
-    boost::lock_guard<boost::mutex> lock(r->mut);
     r->status = lut->status;
     r->actual_length = lut->actual_length;
     r->completed = 1;
-    r->usb_transfer_complete.notify_one();  // wake up thread waiting in wait_for_completion() member function below
+    //only wake up a thread sleeping in wait_for_completion() member function below
+    if (r->waiting)
+    {
+        boost::lock_guard<boost::mutex> lock(r->mut);
+        r->usb_transfer_complete.notify_one();
+    }
 #ifdef UHD_TXRX_DEBUG_PRINTS
     long end_time = boost::get_system_time().time_of_day().total_microseconds();
     libusb1_zerocopy_dbg_print_err( (boost::format("libusb_async_cb,%s,%i,%i,%i,%ld,%ld") % (r->is_recv ? "rx":"tx") % r->buff_num % r->actual_length % r->status % end_time % r->start_time).str() );
@@ -121,7 +137,6 @@ class libusb_zero_copy_mb : public managed_buffer
 public:
     libusb_zero_copy_mb(libusb_transfer *lut, const size_t frame_size, boost::function<void(libusb_zero_copy_mb *)> release_cb, const bool is_recv, const std::string &name):
         _release_cb(release_cb), _is_recv(is_recv), _name(name),
-        _ctx(libusb::session::get_global_session()->get_context()),
         _lut(lut), _frame_size(frame_size) { /* NOP */ }
 
     virtual ~libusb_zero_copy_mb(void);
@@ -161,6 +176,19 @@ public:
     // This is public because it is accessed from the libusb_zero_copy_single constructor
     lut_result_t result;
 
+    //! Check if the transfer completed, without waiting
+    UHD_INLINE bool is_completed(void)
+    {
+        return result.completed > 0;
+    }
+
+    //! Make an unused send buffer available as if its transfer completed
+    UHD_INLINE void set_completed(void)
+    {
+        result.status = LIBUSB_TRANSFER_COMPLETED;
+        result.completed = 1;
+    }
+
     /*!
      * Wait for a managed buffer to become complete.
      *
@@ -169,15 +197,23 @@ public:
      */
     UHD_INLINE bool wait_for_completion(const double timeout)
     {
+        //fast path: the transfer is done, no lock or wakeup involved
+        if (result.completed) return true;
+        if (timeout == 0.0) return false;
+
+        //announce the waiter before checking again, so the callback either
+        //sees the flag and notifies, or has completed before the check below
         boost::unique_lock<boost::mutex> lock(result.mut);
+        result.waiting = true;
         if (!result.completed) {
             if (timeout < 0.0) {
-                result.usb_transfer_complete.wait(lock);
+                result.usb_transfer_complete.wait(lock, lut_result_completed(result));
             } else {
                 const boost::system_time timeout_time = boost::get_system_time() + boost::posix_time::microseconds(long(timeout*1000000));
                 result.usb_transfer_complete.timed_wait(lock, timeout_time, lut_result_completed(result));
             }
         }
+        result.waiting = false;
         return (result.completed > 0);
     }
 
@@ -185,7 +221,6 @@ private:
     boost::function<void(libusb_zero_copy_mb *)> _release_cb;
     const bool _is_recv;
     const std::string _name;
-    libusb_context *_ctx;
     libusb_transfer *_lut;
     const size_t _frame_size;
 };
@@ -203,22 +238,29 @@ public:
     libusb_zero_copy_single(
         libusb::device_handle::sptr handle,
         const int interface, const unsigned char endpoint,
-        const size_t num_frames, const size_t frame_size
+        const size_t num_frames, const size_t frame_size,
+        const size_t num_frames_in_flight, const bool auto_tune
     ):
         _handle(handle),
         _num_frames(num_frames),
         _frame_size(frame_size),
+        _is_recv((endpoint & 0x80) != 0),
+        _name(str(boost::format("%s%d") % ((_is_recv)? "rx" : "tx") % int(endpoint & 0x7f))),
         _buffer_pool(buffer_pool::make(_num_frames, _frame_size)),
         _enqueued(_num_frames), _released(_num_frames),
-        _status(STATUS_RUNNING)
+        _status(STATUS_RUNNING),
+        _auto_tune(auto_tune),
+        _min_frames(std::min(num_frames_in_flight, std::max<size_t>(2, num_frames_in_flight/4))),
+        _target_frames(std::min(num_frames_in_flight, num_frames)),
+        _num_active(_target_frames),
+        _num_gets(0),
+        _num_busy_samples(0)
     {
-        const bool is_recv = (endpoint & 0x80) != 0;
-        const std::string name = str(boost::format("%s%d") % ((is_recv)? "rx" : "tx") % int(endpoint & 0x7f));
         _handle->claim_interface(interface);
 
         //flush the buffers out of the recv endpoint
         //limit the flushing to at most one second
-        if (is_recv) for (size_t i = 0; i < 100; i++)
+        if (_is_recv) for (size_t i = 0; i < 100; i++)
         {
             unsigned char buff[512];
             int transfered = 0;
@@ -240,7 +282,7 @@ public:
             UHD_ASSERT_THROW(lut != NULL);
 
             _mb_pool.push_back(boost::make_shared<libusb_zero_copy_mb>(
-                lut, this->get_frame_size(), boost::bind(&libusb_zero_copy_single::enqueue_buffer, this, _1), is_recv, name
+                lut, this->get_frame_size(), boost::bind(&libusb_zero_copy_single::enqueue_buffer, this, _1), _is_recv, _name
             ));
 
             libusb_fill_bulk_transfer(
@@ -257,11 +299,12 @@ public:
             _all_luts.push_back(lut);
         }
 
-        //initial release for all buffers
+        //initial release for the buffers in flight, the others wait until tuned in
         for (size_t i = 0; i < get_num_frames(); i++)
         {
             libusb_zero_copy_mb &mb = *(_mb_pool[i]);
-            if (is_recv) mb.release();
+            if (i >= _target_frames) _idle.push_back(&mb);
+            else if (_is_recv) mb.release();
             else
             {
                 mb.result.completed = 1;
@@ -303,6 +346,7 @@ public:
         boost::mutex::scoped_lock get_buff_lock(_get_buff_mutex);
 
         boost::mutex::scoped_lock queue_lock(_queue_mutex);
+        if (_auto_tune) this->tune();
         if (_enqueued.empty())
         {
             _buff_ready_cond.timed_wait(queue_lock, boost::posix_time::microseconds(long(timeout*1e6)));
@@ -321,10 +365,13 @@ public:
 
     UHD_INLINE size_t get_num_frames(void) const { return _num_frames; }
     UHD_INLINE size_t get_frame_size(void) const { return _frame_size; }
+    UHD_INLINE size_t get_num_frames_in_flight(void) const { return _target_frames; }
 
 private:
     libusb::device_handle::sptr _handle;
     const size_t _num_frames, _frame_size;
+    const bool _is_recv;
+    const std::string _name;
 
     //! Storage for transfer related objects
     buffer_pool::sptr _buffer_pool;
@@ -339,10 +386,25 @@ private:
 
     enum {STATUS_RUNNING, STATUS_ERROR} _status;
 
+    //! Auto tuning: only _target_frames of the frames are in use, the others are idle
+    const bool _auto_tune;
+    const size_t _min_frames;
+    boost::atomic<size_t> _target_frames;
+    size_t _num_active;
+    std::vector<libusb_zero_copy_mb *> _idle;
+    size_t _num_gets;
+    size_t _num_busy_samples;
+
     void enqueue_buffer(libusb_zero_copy_mb *mb)
     {
         boost::mutex::scoped_lock l(_queue_mutex);
-        _released.push_back(mb);
+        if (_is_recv and _num_active > _target_frames)
+        {
+            //tuned down: retire this transfer rather than resubmit it
+            _idle.push_back(mb);
+            _num_active--;
+        }
+        else _released.push_back(mb);
         this->submit_what_we_can();
         _buff_ready_cond.notify_one();
     }
@@ -366,6 +428,72 @@ private:
         }
     }
 
+    /*!
+     * Tune the number of transfers in flight, called with the queue lock:
+     * When most transfers have completed by the time the host asks for
+     * one, the host is falling behind the device (overflow on RX, the
+     * device running dry on TX), so put more transfers in flight.
+     * When all of them stay busy for a while, fewer are enough, which
+     * also reduces the latency on TX.
+     */
+    void tune(void)
+    {
+        if (not _is_recv)
+        {
+            //tuned down: retire idle send buffers rather than hand them out
+            while (_num_active > _target_frames and _enqueued.size() > 1 and _enqueued.front()->is_completed())
+            {
+                _idle.push_back(_enqueued.front());
+                _enqueued.pop_front();
+                _num_active--;
+            }
+        }
+
+        if (++_num_gets % TUNE_INTERVAL != 0) return;
+
+        size_t num_ready = 0;
+        for (size_t i = 0; i < _enqueued.size(); i++)
+        {
+            if (_enqueued[i]->is_completed()) num_ready++;
+        }
+
+        const size_t target = _target_frames;
+        if (num_ready*4 >= target*3 and target < _num_frames)
+        {
+            this->set_target_frames(std::min(_num_frames, target + std::max<size_t>(1, target/4)));
+            _num_busy_samples = 0;
+        }
+        else if (num_ready == 0 and target > _min_frames)
+        {
+            if (++_num_busy_samples < TUNE_SHRINK_SAMPLES) return;
+            this->set_target_frames(target - 1);
+            _num_busy_samples = 0;
+        }
+        else _num_busy_samples = 0;
+    }
+
+    //! Change the number of transfers in flight, called with the queue lock
+    void set_target_frames(const size_t target)
+    {
+        UHD_LOGGER_DEBUG("USB") << boost::format("usb %s: %u transfers in flight") % _name % target;
+        _target_frames = target;
+
+        //bring idle transfers in, surplus ones are retired as they come back
+        while (_num_active < target and not _idle.empty())
+        {
+            libusb_zero_copy_mb *mb = _idle.back();
+            _idle.pop_back();
+            _num_active++;
+            if (_is_recv) _released.push_back(mb);
+            else
+            {
+                mb->set_completed();
+                _enqueued.push_back(mb);
+            }
+        }
+        this->submit_what_we_can();
+    }
+
     //! a list of all transfer structs we allocated
     std::list<libusb_transfer *> _all_luts;
 };
@@ -383,14 +511,20 @@ struct libusb_zero_copy_impl : usb_zero_copy
         const unsigned char send_endpoint,
         const device_addr_t &hints
     ){
+        //in auto mode, num_*_frames is where tuning starts, and more are allocated
+        const bool auto_tune = hints.cast<int>("num_frames_auto", 0) != 0;
+        const size_t num_recv_frames = size_t(hints.cast<double>("num_recv_frames", DEFAULT_NUM_XFERS));
+        const size_t num_send_frames = size_t(hints.cast<double>("num_send_frames", DEFAULT_NUM_XFERS));
         _recv_impl.reset(new libusb_zero_copy_single(
             handle, recv_interface, (recv_endpoint & 0x7f) | 0x80,
-            size_t(hints.cast<double>("num_recv_frames", DEFAULT_NUM_XFERS)),
-            size_t(hints.cast<double>("recv_frame_size", DEFAULT_XFER_SIZE))));
+            (auto_tune)? size_t(hints.cast<double>("max_num_recv_frames", 4*num_recv_frames)) : num_recv_frames,
+            size_t(hints.cast<double>("recv_frame_size", DEFAULT_XFER_SIZE)),
+            num_recv_frames, auto_tune));
         _send_impl.reset(new libusb_zero_copy_single(
             handle, send_interface, (send_endpoint & 0x7f) | 0x00,
-            size_t(hints.cast<double>("num_send_frames", DEFAULT_NUM_XFERS)),
-            size_t(hints.cast<double>("send_frame_size", DEFAULT_XFER_SIZE))));
+            (auto_tune)? size_t(hints.cast<double>("max_num_send_frames", 4*num_send_frames)) : num_send_frames,
+            size_t(hints.cast<double>("send_frame_size", DEFAULT_XFER_SIZE)),
+            num_send_frames, auto_tune));
     }
 
     virtual ~libusb_zero_copy_impl(void);
@@ -413,6 +547,9 @@ struct libusb_zero_copy_impl : usb_zero_copy
     size_t get_recv_frame_size(void) const { return _recv_impl->get_frame_size(); }
     size_t get_send_frame_size(void) const { return _send_impl->get_frame_size(); }
 
+    size_t get_num_recv_frames_in_flight(void) const { return _recv_impl->get_num_frames_in_flight(); }
+    size_t get_num_send_frames_in_flight(void) const { return _send_impl->get_num_frames_in_flight(); }
+
     boost::shared_ptr<libusb_zero_copy_single> _recv_impl, _send_impl;
     boost::mutex _recv_mutex, _send_mutex;
 };
@@ -439,9 +576,23 @@ usb_zero_copy::sptr usb_zero_copy::make(
     const unsigned char send_endpoint,
     const device_addr_t &hints
 ){
-    libusb::device_handle::sptr dev_handle(libusb::device_handle::get_cached_handle(
-        boost::static_pointer_cast<libusb::special_handle>(handle)->get_device()
+    libusb::device::sptr dev = boost::static_pointer_cast<libusb::special_handle>(handle)->get_device();
+
+    //a private session completes the transfers of this transport in its own event thread
+    const std::string event_thread = hints.get("usb_event_thread", "shared");
+    if (event_thread == "device") try
+    {
+        dev = libusb::find_device(dev, libusb::session::make());
+    }
+    catch(const uhd::exception &e)
+    {
+        UHD_LOGGER_WARNING("USB") << "Using the shared USB event thread, no private session: " << e.what();
+    }
+    else if (event_thread != "shared") throw uhd::value_error(str(boost::format(
+        "Invalid usb_event_thread \"%s\", expected shared or device") % event_thread
     ));
+
+    libusb::device_handle::sptr dev_handle(libusb::device_handle::get_cached_handle(dev));
     return sptr(new libusb_zero_copy_impl(
         dev_handle, recv_interface, recv_endpoint, send_interface, send_endpoint, hints
     ));
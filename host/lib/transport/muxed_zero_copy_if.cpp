@@ -19,6 +19,7 @@
 #include <uhd/transport/bounded_buffer.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/utils/safe_call.hpp>
+#include <uhd/utils/thread_priority.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/thread.hpp>
@@ -210,6 +211,7 @@ private:
 
     void _update_queues()
     {
+        apply_thread_placement("mux_recv");
         //Run forever:
         // - Pull packets from the base transport
         // - Classify them
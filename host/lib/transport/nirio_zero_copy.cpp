@@ -125,7 +125,8 @@ public:
     nirio_zero_copy_impl(
         uhd::niusrprio::niusrprio_session::sptr fpga_session,
         uint32_t instance,
-        const zero_copy_xport_params& xport_params
+        const zero_copy_xport_params& xport_params,
+        const size_t recv_batch_frames
     ):
         _fpga_session(fpga_session),
         _fifo_instance(instance),
@@ -138,6 +139,7 @@ public:
                     (_xport_params.recv_frame_size * _xport_params.num_recv_frames);
         UHD_LOGGER_TRACE("NIRIO") << boost::format("nirio zero-copy TX transport configured with frame size = %u, #frames = %u, buffer size = %u\n")
                     % _xport_params.send_frame_size % _xport_params.num_send_frames % (_xport_params.send_frame_size * _xport_params.num_send_frames);
+        UHD_LOGGER_TRACE("NIRIO") << boost::format("nirio zero-copy RX transport batching %u frames") % recv_batch_frames;
 
         _recv_buffer_pool = buffer_pool::make(_xport_params.num_recv_frames, _xport_params.recv_frame_size);
         _send_buffer_pool = buffer_pool::make(_xport_params.num_send_frames, _xport_params.send_frame_size);
@@ -180,12 +182,19 @@ public:
 
         if ((_recv_fifo.get() != NULL) && (_send_fifo.get() != NULL)) {
             //Initialize FIFOs
+            //In batch mode, acquire all frames that are available at once
+            //and give them back to the device in batches
             nirio_status_chain(
                 _recv_fifo->initialize(
                     (_xport_params.recv_frame_size*_xport_params.num_recv_frames)/sizeof(fifo_data_t),
                     _xport_params.recv_frame_size / sizeof(fifo_data_t),
-                    actual_depth, actual_size),
+                    actual_depth, actual_size,
+                    (recv_batch_frames > 1)
+                        ? nirio_fifo<fifo_data_t>::MAXIMIZE_THROUGHPUT
+                        : nirio_fifo<fifo_data_t>::MINIMIZE_LATENCY),
                 status);
+            _recv_fifo->set_release_batch_size(
+                recv_batch_frames * (_xport_params.recv_frame_size / sizeof(fifo_data_t)));
             nirio_status_chain(
                 _send_fifo->initialize(
                     (_xport_params.send_frame_size*_xport_params.num_send_frames)/sizeof(fifo_data_t),
@@ -423,6 +432,18 @@ nirio_zero_copy::sptr nirio_zero_copy::make(
         throw uhd::value_error((boost::format("num_send_frames * send_frame_size must be an even multiple of %d") % page_size).str());
     }
 
-    return nirio_zero_copy::sptr(new nirio_zero_copy_impl(fpga_session, instance, xport_params));
+    //RX batching: keep at least half of the frames with the device
+    size_t recv_batch_frames = static_cast<size_t>(hints.cast<double>("recv_batch_frames", 1));
+    if (recv_batch_frames == 0) {
+        throw uhd::value_error("recv_batch_frames must be at least 1");
+    }
+    const size_t max_recv_batch_frames = std::max<size_t>(1, xport_params.num_recv_frames/2);
+    if (recv_batch_frames > max_recv_batch_frames) {
+        UHD_LOGGER_WARNING("NIRIO") << boost::format(
+            "recv_batch_frames limited to %u (half of num_recv_frames)") % max_recv_batch_frames;
+        recv_batch_frames = max_recv_batch_frames;
+    }
+
+    return nirio_zero_copy::sptr(new nirio_zero_copy_impl(fpga_session, instance, xport_params, recv_batch_frames));
 }
 
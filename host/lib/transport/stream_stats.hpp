@@ -0,0 +1,134 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_STREAM_STATS_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_STREAM_STATS_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <boost/atomic.hpp>
+#include <stdint.h>
+
+namespace uhd {
+namespace transport {
+namespace sph {
+
+/***********************************************************************
+ * Stream stats counters
+ *
+ * One set of streaming counters, written by a single thread.
+ * The writer does a relaxed load and store instead of an atomic
+ * read-modify-write, so counting costs no more than a plain increment.
+ * Any thread may read the counters with accumulate().
+ **********************************************************************/
+class stream_stats_counters{
+public:
+    typedef boost::atomic<uint64_t> counter_type;
+
+    stream_stats_counters(void){
+        num_packets = 0;
+        num_bytes = 0;
+        num_overflows = 0;
+        num_underflows = 0;
+        num_seq_errors = 0;
+        num_late_packets = 0;
+        convert_time_ns = 0;
+        for (size_t i = 0; i < uhd::stream_stats_t::NUM_LATENCY_BUCKETS; i++){
+            call_latency[i] = 0;
+        }
+    }
+
+    //! Add to a counter (only from the thread that owns these counters)
+    static UHD_INLINE void add(counter_type &counter, const uint64_t n = 1){
+        counter.store(counter.load(boost::memory_order_relaxed) + n, boost::memory_order_relaxed);
+    }
+
+    //! Add the duration since start to a nanosecond counter
+    static UHD_INLINE void add_time_since(counter_type &counter, const uhd::time_spec_t &start){
+        add(counter, get_ns_since(start));
+    }
+
+    //! Count a recv() or send() call that started at start
+    UHD_INLINE void add_call_since(const uhd::time_spec_t &start){
+        uint64_t us = get_ns_since(start)/1000;
+        size_t bucket = 0;
+        while (us != 0 and bucket+1 < uhd::stream_stats_t::NUM_LATENCY_BUCKETS){
+            us >>= 1;
+            bucket++;
+        }
+        add(call_latency[bucket]);
+    }
+
+    //! Add these counters to the stats (safe from any thread)
+    void accumulate(uhd::stream_stats_t &stats) const{
+        stats.num_packets += num_packets.load(boost::memory_order_relaxed);
+        stats.num_bytes += num_bytes.load(boost::memory_order_relaxed);
+        stats.num_overflows += num_overflows.load(boost::memory_order_relaxed);
+        stats.num_underflows += num_underflows.load(boost::memory_order_relaxed);
+        stats.num_seq_errors += num_seq_errors.load(boost::memory_order_relaxed);
+        stats.num_late_packets += num_late_packets.load(boost::memory_order_relaxed);
+        stats.convert_time += convert_time_ns.load(boost::memory_order_relaxed)/1e9;
+        for (size_t i = 0; i < uhd::stream_stats_t::NUM_LATENCY_BUCKETS; i++){
+            stats.call_latency[i] += call_latency[i].load(boost::memory_order_relaxed);
+        }
+    }
+
+    counter_type num_packets;
+    counter_type num_bytes;
+    counter_type num_overflows;
+    counter_type num_underflows;
+    counter_type num_seq_errors;
+    counter_type num_late_packets;
+    counter_type convert_time_ns;
+    counter_type call_latency[uhd::stream_stats_t::NUM_LATENCY_BUCKETS];
+
+private:
+    static UHD_INLINE uint64_t get_ns_since(const uhd::time_spec_t &start){
+        const double elapsed = (uhd::time_spec_t::get_system_time() - start).get_real_secs();
+        return (elapsed > 0)? uint64_t(elapsed*1e9) : 0;
+    }
+};
+
+//! Subtract the baseline of a reset from the current totals
+UHD_INLINE uhd::stream_stats_t stream_stats_diff(
+    const uhd::stream_stats_t &total, const uhd::stream_stats_t &base
+){
+    uhd::stream_stats_t stats;
+    stats.num_packets = total.num_packets - base.num_packets;
+    stats.num_bytes = total.num_bytes - base.num_bytes;
+    stats.num_overflows = total.num_overflows - base.num_overflows;
+    stats.num_underflows = total.num_underflows - base.num_underflows;
+    stats.num_seq_errors = total.num_seq_errors - base.num_seq_errors;
+    stats.num_late_packets = total.num_late_packets - base.num_late_packets;
+    stats.num_fc_stalls = total.num_fc_stalls - base.num_fc_stalls;
+    stats.fc_stall_time = total.fc_stall_time - base.fc_stall_time;
+    stats.convert_time = total.convert_time - base.convert_time;
+    for (size_t i = 0; i < stats.call_latency.size(); i++){
+        stats.call_latency[i] = total.call_latency[i] - base.call_latency[i];
+    }
+    //these are current settings, not counters
+    stats.xport_frames_in_flight = total.xport_frames_in_flight;
+    stats.xport_frame_size = total.xport_frame_size;
+    return stats;
+}
+
+} // namespace sph
+} // namespace transport
+} // namespace uhd
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_STREAM_STATS_HPP */
@@ -19,16 +19,21 @@
 #define INCLUDED_LIBUHD_TRANSPORT_SUPER_RECV_PACKET_HANDLER_HPP
 
 #include "../rfnoc/rx_stream_terminator.hpp"
+#include "stream_stats.hpp"
+#include "event_fd.hpp"
 #include <uhd/config.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/convert.hpp>
 #include <uhd/stream.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/tasks.hpp>
+#include <uhd/utils/trace.hpp>
 #include <uhd/utils/byteswap.hpp>
 #include <uhd/types/metadata.hpp>
+#include <uhd/types/device_addr.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
 #include <uhd/transport/zero_copy.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/dynamic_bitset.hpp>
 #include <boost/function.hpp>
 #include <boost/format.hpp>
@@ -37,13 +42,6 @@
 #include <iostream>
 #include <vector>
 
-// Included for debugging
-#ifdef UHD_TXRX_DEBUG_PRINTS
-#include <boost/format.hpp>
-#include <boost/thread/thread.hpp>
-#include "boost/date_time/posix_time/posix_time.hpp"
-#endif
-
 namespace uhd{ namespace transport{ namespace sph{
 
 UHD_INLINE uint32_t get_context_code(
@@ -70,6 +68,8 @@ public:
     typedef boost::function<managed_recv_buffer::sptr(double)> get_buff_type;
     typedef boost::function<void(const size_t)> handle_flowctrl_type;
     typedef boost::function<void(const stream_cmd_t&)> issue_stream_cmd_type;
+    typedef boost::function<int(void)> get_ready_fd_type;
+    typedef boost::function<void(uhd::stream_stats_t &)> xport_stats_type;
     typedef void(*vrt_unpacker_type)(const uint32_t *, vrt::if_packet_info_t &);
     //typedef boost::function<void(const uint32_t *, vrt::if_packet_info_t &)> vrt_unpacker_type;
 
@@ -79,6 +79,9 @@ public:
      */
     recv_packet_handler(const size_t size = 1):
         _queue_error_for_next_call(false),
+        _stats_timing(false),
+        _ready_fd(-1),
+        _ready_fd_known(false),
         _buffers_infos_index(0)
     {
         #ifdef  ERROR_INJECT_DROPPED_PACKETS
@@ -170,6 +173,40 @@ public:
         _props.at(xport_chan).get_buff = get_buff;
     }
 
+    /*!
+     * Set the function to get the ready descriptor of a transport.
+     * \param xport_chan which transport channel
+     * \param get_ready_fd the getter, returning -1 when not supported
+     */
+    void set_xport_chan_ready_fd(const size_t xport_chan, const get_ready_fd_type &get_ready_fd){
+        _props.at(xport_chan).get_ready_fd = get_ready_fd;
+    }
+
+    /*!
+     * Get a descriptor that polls readable when recv() may return
+     * without waiting. With several transport channels, this is an
+     * epoll descriptor over all of them.
+     * \return the file descriptor, or -1 when a channel has none
+     */
+    int get_ready_fd(void){
+        boost::lock_guard<boost::mutex> lock(_ready_mutex);
+        if (not _ready_fd_known){
+            _ready_fd = this->make_ready_fd();
+            _ready_fd_known = true;
+        }
+        return _ready_fd;
+    }
+
+    /*!
+     * Set the function that reports the transport settings in the stats,
+     * for transports that tune them while streaming.
+     * \param xport_chan which transport channel
+     * \param xport_stats fills in the xport_* fields of the stats
+     */
+    void set_xport_chan_xport_stats(const size_t xport_chan, const xport_stats_type &xport_stats){
+        _props.at(xport_chan).xport_stats = xport_stats;
+    }
+
     /*!
      * Flush all transports in the streamer:
      * The packet payload is discarded.
@@ -193,6 +230,41 @@ public:
         if (do_init) handle_flowctrl(0);
     }
 
+    /*!
+     * Apply the receive options from the stream args.
+     * Recognized keys: stats_timing = 0 or 1.
+     * \param args the stream args (args.args)
+     */
+    void set_recv_args(const uhd::device_addr_t &args){
+        this->set_stats_timing(args.cast<int>("stats_timing", 0) != 0);
+    }
+
+    /*!
+     * Enable timing of the conversions and recv() calls for the stats.
+     * \param enb true to read the system clock on the fast path
+     */
+    void set_stats_timing(const bool enb){
+        _stats_timing = enb;
+    }
+
+    //! Get the streaming counters since the last reset
+    uhd::stream_stats_t get_stream_stats(void) const{
+        boost::lock_guard<boost::mutex> lock(_stats_mutex);
+        uhd::stream_stats_t stats;
+        _stats.accumulate(stats);
+        for (size_t i = 0; i < _props.size(); i++){
+            if (_props[i].xport_stats) _props[i].xport_stats(stats);
+        }
+        return stream_stats_diff(stats, _stats_base);
+    }
+
+    //! Restart the streaming counters from zero
+    void reset_stream_stats(void){
+        boost::lock_guard<boost::mutex> lock(_stats_mutex);
+        _stats_base = uhd::stream_stats_t();
+        _stats.accumulate(_stats_base);
+    }
+
     //! Set the conversion routine for all channels
     void set_converter(const uhd::convert::id_type &id){
         _num_outputs = id.num_outputs;
@@ -245,6 +317,29 @@ public:
         uhd::rx_metadata_t &metadata,
         const double timeout,
         const bool one_packet
+    ){
+        UHD_TRACE_SCOPE(RECV_CALL, nsamps_per_buff);
+        if (not _stats_timing){
+            return this->recv_samps(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+        }
+        const time_spec_t start = time_spec_t::get_system_time();
+        const size_t nsamps_recvd = this->recv_samps(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+        _stats.add_call_since(start);
+        return nsamps_recvd;
+    }
+
+private:
+
+    /*******************************************************************
+     * Receive samples:
+     * Fill the buffers from one or more packets.
+     ******************************************************************/
+    UHD_INLINE size_t recv_samps(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout,
+        const bool one_packet
     ){
         //handle metadata queued from a previous receive
         if (_queue_error_for_next_call){
@@ -260,9 +355,6 @@ public:
         );
 
         if (one_packet or metadata.end_of_burst){
-#ifdef UHD_TXRX_DEBUG_PRINTS
-            dbg_gather_data(nsamps_per_buff, accum_num_samps, metadata, timeout, one_packet);
-#endif
             return accum_num_samps;
         }
 
@@ -291,19 +383,44 @@ public:
                 break;
             }
         }
-#ifdef UHD_TXRX_DEBUG_PRINTS
-        dbg_gather_data(nsamps_per_buff, accum_num_samps, metadata, timeout, one_packet);
-#endif
         return accum_num_samps;
     }
 
-private:
     vrt_unpacker_type _vrt_unpacker;
     size_t _header_offset_words32;
     double _tick_rate, _samp_rate;
     bool _queue_error_for_next_call;
     size_t _alignment_failure_threshold;
     rx_metadata_t _queue_metadata;
+
+    //! Streaming counters, only written by the thread in recv()
+    stream_stats_counters _stats;
+    bool _stats_timing;
+    uhd::stream_stats_t _stats_base;
+    mutable boost::mutex _stats_mutex;
+
+    //! Readiness notification, made on the first request
+    boost::mutex _ready_mutex;
+    int _ready_fd;
+    bool _ready_fd_known;
+    event_fd_set::sptr _ready_set;
+
+    int make_ready_fd(void){
+        std::vector<int> fds;
+        for (size_t i = 0; i < _props.size(); i++){
+            if (not _props[i].get_ready_fd) return -1;
+            const int fd = _props[i].get_ready_fd();
+            if (fd < 0) return -1;
+            fds.push_back(fd);
+        }
+        if (fds.size() == 1) return fds.front();
+        _ready_set = event_fd_set::make();
+        for (size_t i = 0; i < fds.size(); i++){
+            if (not _ready_set->add(fds[i])) return -1;
+        }
+        return _ready_set->get_fd();
+    }
+
     struct xport_chan_props_type{
         xport_chan_props_type(void):
             packet_count(0),
@@ -316,6 +433,8 @@ private:
         handle_overflow_type handle_overflow;
         handle_flowctrl_type handle_flowctrl;
         size_t fc_update_window;
+        get_ready_fd_type get_ready_fd;
+        xport_stats_type xport_stats;
 	/////// RFNOC ///////////
         bool has_sid;
         uint32_t sid;
@@ -408,7 +527,10 @@ private:
     ){
         //get a single packet from the transport layer
         managed_recv_buffer::sptr &buff = curr_buffer_info.buff;
-        buff = _props[index].get_buff(timeout);
+        {
+            UHD_TRACE_SCOPE(RECV_GET_BUFF, index);
+            buff = _props[index].get_buff(timeout);
+        }
         if (buff.get() == nullptr) return PACKET_TIMEOUT_ERROR;
 
         #ifdef  ERROR_INJECT_DROPPED_PACKETS
@@ -431,7 +553,10 @@ private:
         per_buffer_info_type &info = curr_buffer_info;
         info.ifpi.num_packet_words32 = num_packet_words32 - _header_offset_words32;
         info.vrt_hdr = buff->cast<const uint32_t *>() + _header_offset_words32;
-        _vrt_unpacker(info.vrt_hdr, info.ifpi);
+        {
+            UHD_TRACE_SCOPE(RECV_UNPACK, info.ifpi.num_packet_words32);
+            _vrt_unpacker(info.vrt_hdr, info.ifpi);
+        }
         info.time = time_spec_t::from_ticks(info.ifpi.tsf, _tick_rate); //assumes has_tsf is true
         info.copy_buff = reinterpret_cast<const char *>(info.vrt_hdr + info.ifpi.num_header_words32);
 
@@ -440,6 +565,7 @@ private:
         {
             if ((info.ifpi.packet_count % _props[index].fc_update_window) == 0)
             {
+                UHD_TRACE_SCOPE(RECV_FC_SEND, info.ifpi.packet_count);
                 _props[index].handle_flowctrl(info.ifpi.packet_count);
             }
         }
@@ -453,6 +579,8 @@ private:
         if (info.ifpi.packet_type != vrt::if_packet_info_t::PACKET_TYPE_DATA){
             return PACKET_INLINE_MESSAGE;
         }
+        stream_stats_counters::add(_stats.num_packets);
+        stream_stats_counters::add(_stats.num_bytes, info.ifpi.num_payload_bytes);
 
         //2) check for sequence errors
         #ifndef SRPH_DONT_CHECK_SEQUENCE
@@ -465,6 +593,7 @@ private:
                 // Always update flow control in this case, because we don't
                 // know which packet was dropped and what state the upstream
                 // flow control is in.
+                UHD_TRACE_SCOPE(RECV_FC_SEND, info.ifpi.packet_count);
                 _props[index].handle_flowctrl(info.ifpi.packet_count);
             }
             return PACKET_SEQUENCE_ERROR;
@@ -607,14 +736,19 @@ private:
                     // Send first as the overrun handler may flush the receive buffers which could contain
                     // packets with sequence numbers after this packet's sequence number!
                     if(_props[index].handle_flowctrl) {
+                        UHD_TRACE_SCOPE(RECV_FC_SEND, next_info[index].ifpi.packet_count);
                         _props[index].handle_flowctrl(next_info[index].ifpi.packet_count);
                     }
 
                     rx_metadata_t metadata = curr_info.metadata;
                     _props[index].handle_overflow();
                     curr_info.metadata = metadata;
+                    stream_stats_counters::add(_stats.num_overflows);
                     UHD_LOG_FASTPATH("O")
                 }
+                else if (curr_info.metadata.error_code == rx_metadata_t::ERROR_CODE_LATE_COMMAND){
+                    stream_stats_counters::add(_stats.num_late_packets);
+                }
                 curr_info[index].buff.reset();
                 curr_info[index].copy_buff = nullptr;
                 return;
@@ -622,6 +756,7 @@ private:
             case PACKET_TIMEOUT_ERROR:
                 std::swap(curr_info, next_info); //save progress from curr -> next
                 if(_props[index].handle_flowctrl) {
+                    UHD_TRACE_SCOPE(RECV_FC_SEND, next_info[index].ifpi.packet_count);
                     _props[index].handle_flowctrl(next_info[index].ifpi.packet_count);
                 }
                 curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
@@ -635,6 +770,7 @@ private:
                     prev_info[index].ifpi.num_payload_words32*sizeof(uint32_t)/_bytes_per_otw_item, _samp_rate);
                 curr_info.metadata.out_of_sequence = true;
                 curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
+                stream_stats_counters::add(_stats.num_seq_errors);
                 UHD_LOG_FASTPATH("D")
                 return;
 
@@ -705,8 +841,17 @@ private:
         _convert_bytes_to_copy = bytes_to_copy;
 
         //perform N channels of conversion
-        for (size_t i = 0; i < this->size(); i++) {
-            convert_to_out_buff(i);
+        if (_stats_timing) {
+            const time_spec_t start = time_spec_t::get_system_time();
+            for (size_t i = 0; i < this->size(); i++) {
+                convert_to_out_buff(i);
+            }
+            _stats.add_time_since(_stats.convert_time_ns, start);
+        }
+        else {
+            for (size_t i = 0; i < this->size(); i++) {
+                convert_to_out_buff(i);
+            }
         }
 
         //update the copy buffer's availability
@@ -743,7 +888,10 @@ private:
         const ref_vector<void *> out_buffs(io_buffs, _num_outputs);
 
         //perform the conversion operation
-        _converter->conv(info.copy_buff, out_buffs, _convert_nsamps);
+        {
+            UHD_TRACE_SCOPE(RECV_CONVERT, _convert_nsamps);
+            _converter->conv(info.copy_buff, out_buffs, _convert_nsamps);
+        }
 
         //advance the pointer for the source buffer
         info.copy_buff += _convert_bytes_to_copy;
@@ -759,66 +907,6 @@ private:
     const rx_streamer::buffs_type *_convert_buffs;
     size_t _convert_buffer_offset_bytes;
     size_t _convert_bytes_to_copy;
-
-    /*
-     * This last section is only for debugging purposes.
-     * It causes a lot of prints to stderr which can be piped to a file.
-     * Gathered data can be used to post process it with external tools.
-     */
-#ifdef UHD_TXRX_DEBUG_PRINTS
-    struct dbg_recv_stat_t {
-        dbg_recv_stat_t(long wc, size_t nspb, size_t nsr, uhd::rx_metadata_t md, double to, bool op, double rate):
-        wallclock(wc), nsamps_per_buff(nspb), nsamps_recv(nsr), metadata(md), timeout(to), one_packet(op), samp_rate(rate)
-        {}
-        long wallclock;
-        size_t nsamps_per_buff;
-        size_t nsamps_recv;
-        uhd::rx_metadata_t metadata;
-        double timeout;
-        bool one_packet;
-        double samp_rate;
-        // Create a formatted print line for all the info gathered in this struct.
-        std::string print_line() {
-            boost::format fmt("recv,%ld,%f,%i,%i,%s,%i,%s,%s,%s,%i,%s,%ld");
-            fmt % wallclock;
-            fmt % timeout % (int)nsamps_per_buff % (int) nsamps_recv;
-            fmt % (one_packet ? "true":"false");
-            fmt % metadata.error_code;
-            fmt % (metadata.start_of_burst ? "true":"false") % (metadata.end_of_burst ? "true":"false");
-            fmt % (metadata.more_fragments ? "true":"false") % (int)metadata.fragment_offset;
-            fmt % (metadata.has_time_spec ? "true":"false") % metadata.time_spec.to_ticks(samp_rate);
-            return fmt.str();
-        }
-    };
-
-    void dbg_gather_data(const size_t nsamps_per_buff, const size_t nsamps_recv,
-            uhd::rx_metadata_t &metadata, const double timeout,
-            const bool one_packet,
-            bool dbg_print_directly = true
-        )
-    {
-        // Initialize a struct with all available data. It can return a formatted string with all infos if wanted.
-        dbg_recv_stat_t data(boost::get_system_time().time_of_day().total_microseconds(),
-                nsamps_per_buff,
-                nsamps_recv,
-                metadata,
-                timeout,
-                one_packet,
-                _samp_rate
-            );
-        if(dbg_print_directly) {
-            dbg_print_err(data.print_line());
-        }
-    }
-
-
-
-    void dbg_print_err(std::string msg) {
-        std::string dbg_prefix("super_recv_packet_handler,");
-        msg = dbg_prefix + msg;
-        fprintf(stderr, "%s\n", msg.c_str());
-    }
-#endif
 };
 
 class recv_packet_streamer : public recv_packet_handler, public rx_streamer{
@@ -850,6 +938,21 @@ public:
         return recv_packet_handler::issue_stream_cmd(stream_cmd);
     }
 
+    uhd::stream_stats_t get_stats(void) const
+    {
+        return recv_packet_handler::get_stream_stats();
+    }
+
+    void reset_stats(void)
+    {
+        recv_packet_handler::reset_stream_stats();
+    }
+
+    int get_recv_fd(void)
+    {
+        return recv_packet_handler::get_ready_fd();
+    }
+
 private:
     size_t _max_num_samps;
 };
@@ -19,6 +19,9 @@
 #define INCLUDED_LIBUHD_TRANSPORT_SUPER_SEND_PACKET_HANDLER_HPP
 
 #include "../rfnoc/tx_stream_terminator.hpp"
+#include "stream_stats.hpp"
+#include "async_event_channel.hpp"
+#include "event_fd.hpp"
 #include <uhd/config.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/convert.hpp>
@@ -27,26 +30,23 @@
 #include <uhd/utils/tasks.hpp>
 #include <uhd/utils/byteswap.hpp>
 #include <uhd/types/metadata.hpp>
+#include <uhd/types/device_addr.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
 #include <uhd/transport/zero_copy.hpp>
 #include <uhd/utils/safe_call.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <uhd/utils/trace.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/thread_time.hpp>
 #include <boost/function.hpp>
+#include <boost/bind.hpp>
 #include <boost/atomic.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
-#ifdef UHD_TXRX_DEBUG_PRINTS
-// Included for debugging
-#include <boost/format.hpp>
-#include <boost/thread/thread.hpp>
-#include "boost/date_time/posix_time/posix_time.hpp"
-#include <map>
-#include <fstream>
-#endif
-
 namespace uhd {
 namespace transport {
 namespace sph {
@@ -54,6 +54,14 @@ namespace sph {
 static const size_t MAX_INTERLEAVE = 4;
 static const double GET_BUFF_TIMEOUT = 0.1;
 
+//maximum number of cycles to spin before waiting on a condition variable
+//the value of 30000000 was derived from 15ms on a 10 GHz CPU divided by 5 cycles per loop
+//the assumption is that anything held up for 15ms can wait
+static const size_t MAX_SPIN_CYCLES = 30000000;
+
+//maximum amount of time a worker thread waits before checking the stop flag
+static const double MAX_WORKER_WAIT = 0.1;
+
 /***********************************************************************
  * Super send packet handler
  *
@@ -65,15 +73,35 @@ class send_packet_handler{
 public:
     typedef boost::function<managed_send_buffer::sptr(double)> get_buff_type;
     typedef boost::function<bool(uhd::async_metadata_t &, const double)> async_receiver_type;
+    typedef boost::function<uhd::tx_flow_ctrl_stats_t(void)> fc_stats_type;
+    typedef boost::function<int(void)> get_ready_fd_type;
+    typedef boost::function<void(uhd::stream_stats_t &)> xport_stats_type;
     typedef void(*vrt_packer_type)(uint32_t *, vrt::if_packet_info_t &);
     //typedef boost::function<void(uint32_t *, vrt::if_packet_info_t &)> vrt_packer_type;
 
+    /*!
+     * How send() hands packets to the per-channel worker threads and
+     * waits for them to finish.
+     */
+    enum wait_strategy_t {
+        //! Inline for a single channel, spin then block otherwise
+        WAIT_AUTO,
+        //! Busy wait only: lowest latency, but keeps every thread on a core
+        WAIT_SPIN,
+        //! Spin for a while, then sleep on a condition variable
+        WAIT_SPIN_BLOCK,
+        //! Convert in the calling thread (single channel only)
+        WAIT_INLINE
+    };
+
     /*!
      * Make a new packet handler for send
      * \param size the number of transport channels
      */
     send_packet_handler(const size_t size = 1):
-       _next_packet_seq(0), _cached_metadata(false)
+       _next_packet_seq(0), _cached_metadata(false),
+       _stats_timing(false), _wait_strategy(WAIT_AUTO), _master_sleeping(false),
+       _ready_fd(-1), _ready_fd_known(false)
     {
         this->set_enable_trailer(true);
         this->resize(size);
@@ -94,12 +122,11 @@ public:
         if (this->size() == size) return;
 
         // Stop all worker threads
-        for (size_t i = 0; i < _worker_data.size(); i++)
+        for (size_t i = 0; i < _worker_threads.size(); i++)
         {
-            _worker_data[i]->stop = true;
+            this->stop_worker(i);
         }
-        _worker_thread_group.join_all();
-        _worker_threads.resize(size);
+        _worker_threads.resize(size, NULL);
         _worker_data.resize(size);
         for (size_t i = 0; i < size; i++)
         {
@@ -170,15 +197,118 @@ public:
      * \param get_buff the getter function
      */
     void set_xport_chan_get_buff(const size_t xport_chan, const get_buff_type &get_buff){
-        if (_worker_threads[xport_chan])
+        this->stop_worker(xport_chan);
+        _props.at(xport_chan).get_buff = get_buff;
+        this->start_worker(xport_chan);
+    }
+
+    /*!
+     * Set how packets are handed to the worker threads.
+     * Restarts the worker threads when the strategy changes,
+     * so this is best called before the get buffer functions are set.
+     * \param strategy the new wait strategy
+     */
+    void set_wait_strategy(const wait_strategy_t strategy){
+        if (strategy == _wait_strategy) return;
+        for (size_t i = 0; i < _worker_threads.size(); i++)
         {
-            _worker_thread_group.remove_thread(_worker_threads[xport_chan]);
-            _worker_data[xport_chan]->stop = true;
-            _worker_threads[xport_chan]->join();
-            _worker_data[xport_chan]->stop = false;
+            this->stop_worker(i);
         }
-        _props.at(xport_chan).get_buff = get_buff;
-        _worker_threads[xport_chan] = _worker_thread_group.create_thread(boost::bind(&send_packet_handler::worker, this, xport_chan));
+        _wait_strategy = strategy;
+        for (size_t i = 0; i < _worker_threads.size(); i++)
+        {
+            this->start_worker(i);
+        }
+    }
+
+    /*!
+     * Apply the send options from the stream args.
+     * Recognized keys: send_wait = auto, spin, spin_block or inline,
+     * and stats_timing = 0 or 1.
+     * \param args the stream args (args.args)
+     */
+    void set_send_args(const uhd::device_addr_t &args){
+        this->set_stats_timing(args.cast<int>("stats_timing", 0) != 0);
+        const std::string wait = args.get("send_wait", "auto");
+        if      (wait == "auto")       this->set_wait_strategy(WAIT_AUTO);
+        else if (wait == "spin")       this->set_wait_strategy(WAIT_SPIN);
+        else if (wait == "spin_block") this->set_wait_strategy(WAIT_SPIN_BLOCK);
+        else if (wait == "inline")     this->set_wait_strategy(WAIT_INLINE);
+        else throw uhd::value_error(str(
+            boost::format("Unknown send_wait strategy \"%s\", expected auto, spin, spin_block or inline") % wait
+        ));
+    }
+
+    /*!
+     * Set the function that reports flow control counters.
+     * \param xport_chan which transport channel
+     * \param fc_stats the counter getter function
+     */
+    void set_xport_chan_fc_stats(const size_t xport_chan, const fc_stats_type &fc_stats){
+        _props.at(xport_chan).fc_stats = fc_stats;
+    }
+
+    /*!
+     * Set the function to get the ready descriptor of a transport:
+     * It polls readable while the device has room for more packets.
+     * \param xport_chan which transport channel
+     * \param get_ready_fd the getter, returning -1 when not supported
+     */
+    void set_xport_chan_ready_fd(const size_t xport_chan, const get_ready_fd_type &get_ready_fd){
+        _props.at(xport_chan).get_ready_fd = get_ready_fd;
+    }
+
+    /*!
+     * Get a descriptor that polls readable when send() may proceed
+     * without waiting. With several transport channels, this is an
+     * epoll descriptor over all of them.
+     * \return the file descriptor, or -1 when a channel has none
+     */
+    int get_ready_fd(void){
+        boost::lock_guard<boost::mutex> lock(_ready_mutex);
+        if (not _ready_fd_known){
+            _ready_fd = this->make_ready_fd();
+            _ready_fd_known = true;
+        }
+        return _ready_fd;
+    }
+
+    /*!
+     * Set the function that reports the transport settings in the stats,
+     * for transports that tune them while streaming.
+     * \param xport_chan which transport channel
+     * \param xport_stats fills in the xport_* fields of the stats
+     */
+    void set_xport_chan_xport_stats(const size_t xport_chan, const xport_stats_type &xport_stats){
+        _props.at(xport_chan).xport_stats = xport_stats;
+    }
+
+    //! Get the flow control counters for a channel
+    uhd::tx_flow_ctrl_stats_t get_xport_chan_fc_stats(const size_t xport_chan) const{
+        const fc_stats_type &fc_stats = _props.at(xport_chan).fc_stats;
+        if (fc_stats) return fc_stats();
+        return uhd::tx_flow_ctrl_stats_t();
+    }
+
+    /*!
+     * Enable timing of the conversions and send() calls for the stats.
+     * Call this before streaming starts.
+     * \param enb true to read the system clock on the fast path
+     */
+    void set_stats_timing(const bool enb){
+        _stats_timing = enb;
+    }
+
+    //! Get the streaming counters since the last reset
+    uhd::stream_stats_t get_stream_stats(void) const{
+        boost::lock_guard<boost::mutex> lock(_stats_mutex);
+        return stream_stats_diff(this->get_total_stream_stats(), _stats_base);
+    }
+
+    //! Restart the streaming counters from zero
+    void reset_stream_stats(void){
+        boost::lock_guard<boost::mutex> lock(_stats_mutex);
+        _stats_base = this->get_total_stream_stats();
     }
 
     //! Set the conversion routine for all channels
@@ -207,14 +337,50 @@ public:
     //! Set the callback to get async messages
     void set_async_receiver(const async_receiver_type &async_receiver)
     {
+        _async_channel.reset();
         _async_receiver = async_receiver;
     }
 
+    /*!
+     * Get async messages from a channel, which also supports
+     * callbacks and file descriptor notification.
+     * \param channel the channel the async handlers push into
+     */
+    void set_async_channel(const async_event_channel::sptr &channel)
+    {
+        _async_channel = channel;
+        _async_receiver = boost::bind(&async_event_channel::pop_with_timed_wait, channel, _1, _2);
+    }
+
+    //! Get the async channel (null when set_async_receiver() was used)
+    async_event_channel::sptr get_async_channel(void) const
+    {
+        return _async_channel;
+    }
+
     //! Overload call to get async metadata
     bool recv_async_msg(
         uhd::async_metadata_t &async_metadata, double timeout = 0.1
     ){
-        if (_async_receiver) return _async_receiver(async_metadata, timeout);
+        if (_async_receiver){
+            if (not _async_receiver(async_metadata, timeout)) return false;
+            switch (async_metadata.event_code){
+            case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW:
+            case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW_IN_PACKET:
+                stream_stats_counters::add(_async_stats.num_underflows);
+                break;
+            case uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR:
+            case uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR_IN_BURST:
+                stream_stats_counters::add(_async_stats.num_seq_errors);
+                break;
+            case uhd::async_metadata_t::EVENT_CODE_TIME_ERROR:
+                stream_stats_counters::add(_async_stats.num_late_packets);
+                break;
+            default:
+                break;
+            }
+            return true;
+        }
         boost::this_thread::sleep(boost::posix_time::microseconds(long(timeout*1e6)));
         return false;
     }
@@ -229,6 +395,28 @@ public:
         const size_t nsamps_per_buff,
         const uhd::tx_metadata_t &metadata,
         const double timeout
+    ){
+        UHD_TRACE_SCOPE(SEND_CALL, nsamps_per_buff);
+        if (not _stats_timing){
+            return this->send_samps(buffs, nsamps_per_buff, metadata, timeout);
+        }
+        const time_spec_t start = time_spec_t::get_system_time();
+        const size_t nsamps_sent = this->send_samps(buffs, nsamps_per_buff, metadata, timeout);
+        _stats.add_call_since(start);
+        return nsamps_sent;
+    }
+
+private:
+
+    /*******************************************************************
+     * Send samples:
+     * Split the buffers into packets and send them.
+     ******************************************************************/
+    UHD_INLINE size_t send_samps(
+        const uhd::tx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const uhd::tx_metadata_t &metadata,
+        const double timeout
     ){
         //translate the metadata to vrt if packet info
         vrt::if_packet_info_t if_packet_info;
@@ -282,51 +470,49 @@ public:
                 }
             #endif
 
-			size_t nsamps_sent = send_one_packet(buffs, nsamps_per_buff, if_packet_info, timeout);
-#ifdef UHD_TXRX_DEBUG_PRINTS
-			dbg_print_send(nsamps_per_buff, nsamps_sent, metadata, timeout);
-#endif
-			return nsamps_sent;        }
-        size_t total_num_samps_sent = 0;
-
-        //false until final fragment
-        if_packet_info.eob = false;
-
+            return send_one_packet(buffs, nsamps_per_buff, if_packet_info, timeout);
+        }
         const size_t num_fragments = (nsamps_per_buff-1)/_max_samples_per_packet;
         const size_t final_length = ((nsamps_per_buff-1)%_max_samples_per_packet)+1;
 
-        //loop through the following fragment indexes
-        for (size_t i = 0; i < num_fragments; i++){
-
-            //send a fragment with the helper function
-            const size_t num_samps_sent = send_one_packet(
-                buffs, _max_samples_per_packet,
-                if_packet_info, timeout,
-                total_num_samps_sent*_bytes_per_cpu_item
-            );
-            total_num_samps_sent += num_samps_sent;
-            if (num_samps_sent == 0) return total_num_samps_sent;
-
-            //setup metadata for the next fragment
-            const time_spec_t time_spec = metadata.time_spec + time_spec_t::from_ticks(total_num_samps_sent, _samp_rate);
-            if_packet_info.tsf = time_spec.to_ticks(_tick_rate);
-            if_packet_info.sob = false;
-
+        //describe every fragment up front so the workers get the whole batch at once
+        _packets.resize(num_fragments+1);
+        for (size_t i = 0; i <= num_fragments; i++){
+            const size_t samps_before = i*_max_samples_per_packet;
+            packet_t &packet = _packets[i];
+            packet.nsamps = (i == num_fragments)? final_length : _max_samples_per_packet;
+            packet.buffer_offset_bytes = samps_before*_bytes_per_cpu_item;
+            packet.if_packet_info = if_packet_info;
+            if (i != 0){
+                const time_spec_t time_spec = metadata.time_spec + time_spec_t::from_ticks(samps_before, _samp_rate);
+                packet.if_packet_info.tsf = time_spec.to_ticks(_tick_rate);
+                packet.if_packet_info.sob = false;
+            }
+            //false until final fragment
+            packet.if_packet_info.eob = (i == num_fragments)? metadata.end_of_burst : false;
         }
 
-        //send the final fragment with the helper function
-        if_packet_info.eob = metadata.end_of_burst;
-		size_t nsamps_sent = total_num_samps_sent
-				+ send_one_packet(buffs, final_length, if_packet_info, timeout,
-					total_num_samps_sent * _bytes_per_cpu_item);
-#ifdef UHD_TXRX_DEBUG_PRINTS
-		dbg_print_send(nsamps_per_buff, nsamps_sent, metadata, timeout);
-
-#endif
-		return nsamps_sent;
+        return send_packets(buffs, num_fragments+1, timeout);
     }
 
-private:
+    //! One packet of a send() call, as handed to the worker threads
+    struct packet_t {
+        size_t nsamps;
+        size_t buffer_offset_bytes;
+        vrt::if_packet_info_t if_packet_info;
+    };
+
+    struct worker_thread_data_t {
+        worker_thread_data_t() : go(false), done(false), stop(false), sleeping(false), num_sent(0) {}
+        boost::atomic_bool go;
+        boost::atomic_bool done;
+        boost::atomic_bool stop;
+        boost::atomic_bool sleeping;
+        size_t num_sent;
+        stream_stats_counters stats;
+        boost::mutex data_ready_lock;
+        boost::condition_variable data_ready;
+    };
 
     vrt_packer_type _vrt_packer;
     size_t _header_offset_words32;
@@ -334,6 +520,9 @@ private:
     struct xport_chan_props_type{
         xport_chan_props_type(void):has_sid(false),sid(0){}
         get_buff_type get_buff;
+        fc_stats_type fc_stats;
+        get_ready_fd_type get_ready_fd;
+        xport_stats_type xport_stats;
         bool has_sid;
         uint32_t sid;
         managed_send_buffer::sptr buff;
@@ -348,56 +537,12 @@ private:
     size_t _next_packet_seq;
     bool _has_tlr;
     async_receiver_type _async_receiver;
+    async_event_channel::sptr _async_channel;
     bool _cached_metadata;
     uhd::tx_metadata_t _metadata_cache;
 
     uhd::rfnoc::tx_stream_terminator::sptr _terminator;
 
-#ifdef UHD_TXRX_DEBUG_PRINTS
-    struct dbg_send_stat_t {
-        dbg_send_stat_t(long wc, size_t nspb, size_t nss, uhd::tx_metadata_t md, double to, double rate):
-            wallclock(wc), nsamps_per_buff(nspb), nsamps_sent(nss), metadata(md), timeout(to), samp_rate(rate)
-        {}
-        long wallclock;
-        size_t nsamps_per_buff;
-        size_t nsamps_sent;
-        uhd::tx_metadata_t metadata;
-        double timeout;
-        double samp_rate;
-        // Create a formatted print line for all the info gathered in this struct.
-        std::string print_line() {
-            boost::format fmt("send,%ld,%f,%i,%i,%s,%s,%s,%ld");
-            fmt % wallclock;
-            fmt % timeout % (int)nsamps_per_buff % (int) nsamps_sent;
-            fmt % (metadata.start_of_burst ? "true":"false") % (metadata.end_of_burst ? "true":"false");
-            fmt % (metadata.has_time_spec ? "true":"false") % metadata.time_spec.to_ticks(samp_rate);
-            return fmt.str();
-        }
-    };
-
-    void dbg_print_send(size_t nsamps_per_buff, size_t nsamps_sent,
-            const uhd::tx_metadata_t &metadata, const double timeout,
-            bool dbg_print_directly = true)
-    {
-        dbg_send_stat_t data(boost::get_system_time().time_of_day().total_microseconds(),
-            nsamps_per_buff,
-            nsamps_sent,
-            metadata,
-            timeout,
-            _samp_rate
-        );
-        if(dbg_print_directly){
-            dbg_print_err(data.print_line());
-        }
-    }
-    void dbg_print_err(std::string msg) {
-        msg = "super_send_packet_handler," + msg;
-        fprintf(stderr, "%s\n", msg.c_str());
-    }
-
-
-#endif
-
     /*******************************************************************
      * Send a single packet:
      ******************************************************************/
@@ -408,97 +553,305 @@ private:
         const double timeout,
         const size_t buffer_offset_bytes = 0
     ){
+        _packets.resize(1);
+        _packets[0].nsamps = nsamps_per_buff;
+        _packets[0].buffer_offset_bytes = buffer_offset_bytes;
+        _packets[0].if_packet_info = if_packet_info;
+        return send_packets(buffs, 1, timeout);
+    }
 
+    /*******************************************************************
+     * Send the first num_packets entries of _packets:
+     * Returns the number of samples per channel that were committed.
+     * A timeout stops the batch early, but all channels always
+     * commit the same number of packets.
+     ******************************************************************/
+    UHD_INLINE size_t send_packets(
+        const uhd::tx_streamer::buffs_type &buffs,
+        const size_t num_packets,
+        const double timeout
+    ){
         //load the rest of the if_packet_info in here
-        if_packet_info.num_payload_bytes = nsamps_per_buff*_num_inputs*_bytes_per_otw_item;
-        if_packet_info.num_payload_words32 = (if_packet_info.num_payload_bytes + 3/*round up*/)/sizeof(uint32_t);
-        if_packet_info.packet_count = _next_packet_seq;
+        for (size_t k = 0; k < num_packets; k++)
+        {
+            vrt::if_packet_info_t &if_packet_info = _packets[k].if_packet_info;
+            if_packet_info.num_payload_bytes = _packets[k].nsamps*_num_inputs*_bytes_per_otw_item;
+            if_packet_info.num_payload_words32 = (if_packet_info.num_payload_bytes + 3/*round up*/)/sizeof(uint32_t);
+            if_packet_info.packet_count = _next_packet_seq + k;
+        }
 
-        // wait for all worker threads to be ready or timeout
-        boost::system_time expiration = boost::get_system_time() + boost::posix_time::milliseconds(long(timeout * 1000));
-        for (size_t i = 0; i < this->size(); i++)
+        //setup the data to share with worker threads
+        _convert_buffs = &buffs;
+        _convert_num_packets = num_packets;
+        _convert_timeout = timeout;
+
+        size_t num_sent = 0;
+        if (this->is_inline())
+        {
+            num_sent = send_packets_inline(num_packets, timeout);
+        }
+        else
         {
-            while (not _worker_data[i]->ready)
+            _convert_num_acquired = 0;
+            _convert_abort = false;
+
+            //start N channels of conversion
+            for (size_t i = 0; i < this->size(); i++)
+            {
+                _worker_data[i]->go = true;
+            }
+
+            //wake up any worker threads that went to sleep waiting for work
+            for (size_t i = 0; i < this->size(); i++)
             {
-                if (boost::get_system_time() > expiration)
+                if (_worker_data[i]->sleeping)
                 {
-                    return 0;
+                    boost::lock_guard<boost::mutex> lock(_worker_data[i]->data_ready_lock);
+                    _worker_data[i]->data_ready.notify_one();
                 }
             }
-            _worker_data[i]->ready = false;
+
+            //wait for all worker threads to be done
+            for (size_t i = 0; i < this->size(); i++)
+            {
+                wait_for_worker(*_worker_data[i]);
+                _worker_data[i]->done = false;
+            }
+            num_sent = _worker_data[0]->num_sent;
         }
 
-        //setup the data to share with worker threads
-        _convert_nsamps = nsamps_per_buff;
-        _convert_buffs = &buffs;
-        _convert_buffer_offset_bytes = buffer_offset_bytes;
-        _convert_if_packet_info = &if_packet_info;
+        _next_packet_seq += num_sent; //increment sequence after commits
 
-        //start N channels of conversion
-        for (size_t i = 0; i < this->size(); i++)
+        size_t nsamps_sent = 0;
+        for (size_t k = 0; k < num_sent; k++)
         {
-            _worker_data[i]->go = true;
+            nsamps_sent += _packets[k].nsamps;
         }
+        return nsamps_sent;
+    }
 
-        //make sure any sleeping worker threads are woken up
-        for (size_t i = 0; i < this->size(); i++)
+    //! True when the calling thread does the conversion itself
+    UHD_INLINE bool is_inline(void) const
+    {
+        return this->size() == 1 and
+            (_wait_strategy == WAIT_AUTO or _wait_strategy == WAIT_INLINE);
+    }
+
+    //! Single channel send without the worker thread hand-off
+    UHD_INLINE size_t send_packets_inline(
+        const size_t num_packets,
+        const double timeout
+    ){
+        _inline_in_buffs.resize(MAX_INTERLEAVE);
+        for (size_t k = 0; k < num_packets; k++)
         {
-            // Acquiring the lock used by the condition variable
-            // takes too long, so do a spin wait.  If the go flag
-            // is not cleared by this point, it will be cleared
-            // immediately by the worker thread when it wakes up.
-            while (_worker_data[i]->go)
+            managed_send_buffer::sptr buff;
+            {
+                UHD_TRACE_SCOPE(SEND_GET_BUFF, 0);
+                buff = _props[0].get_buff(timeout);
+            }
+            if (not buff) return k;
+            const size_t num_bytes = this->convert_packet(0, _packets[k], buff, _inline_in_buffs, _stats);
             {
-                _worker_data[i]->data_ready.notify_one();
+                UHD_TRACE_SCOPE(SEND_COMMIT, num_bytes);
+                buff->commit(num_bytes);
             }
+            this->count_packet(_packets[k], _stats);
         }
+        return num_packets;
+    }
+
+    /*!
+     * Pack the header and convert the samples of one packet
+     * for one channel into the buffer.
+     * \return the number of bytes to commit
+     */
+    UHD_INLINE size_t convert_packet(
+        const size_t index,
+        const packet_t &packet,
+        managed_send_buffer::sptr &buff,
+        std::vector<const void *> &in_buffs,
+        stream_stats_counters &stats
+    ){
+        //pack metadata into a vrt header
+        uint32_t *otw_mem = buff->cast<uint32_t *>() + _header_offset_words32;
+        vrt::if_packet_info_t if_packet_info = packet.if_packet_info;
+        if_packet_info.has_sid = _props[index].has_sid;
+        if_packet_info.sid = _props[index].sid;
+        {
+            UHD_TRACE_SCOPE(SEND_PACK, if_packet_info.num_payload_words32);
+            _vrt_packer(otw_mem, if_packet_info);
+        }
+        otw_mem += if_packet_info.num_header_words32;
 
-        //wait for all worker threads to be done
+        //prepare the input buffers
+        for (size_t i = 0; i < _num_inputs; i++)
+        {
+            in_buffs[i] =
+                (reinterpret_cast<const char *>((*_convert_buffs)[index*_num_inputs + i]))
+                + packet.buffer_offset_bytes;
+        }
+
+        //perform the conversion operation
+        UHD_TRACE_SCOPE(SEND_CONVERT, packet.nsamps);
+        if (_stats_timing){
+            const time_spec_t start = time_spec_t::get_system_time();
+            _converter->conv(in_buffs, otw_mem, packet.nsamps);
+            stats.add_time_since(stats.convert_time_ns, start);
+        }
+        else{
+            _converter->conv(in_buffs, otw_mem, packet.nsamps);
+        }
+
+        return (_header_offset_words32 + if_packet_info.num_packet_words32)
+            * sizeof(uint32_t);
+    }
+
+    //! Count a committed packet in the stats
+    static UHD_INLINE void count_packet(const packet_t &packet, stream_stats_counters &stats)
+    {
+        stream_stats_counters::add(stats.num_packets);
+        stream_stats_counters::add(stats.num_bytes, packet.if_packet_info.num_payload_bytes);
+    }
+
+    //! Sum the counters of all threads and the flow control stats
+    uhd::stream_stats_t get_total_stream_stats(void) const
+    {
+        uhd::stream_stats_t stats;
+        _stats.accumulate(stats);
+        _async_stats.accumulate(stats);
+        for (size_t i = 0; i < _worker_data.size(); i++)
+        {
+            _worker_data[i]->stats.accumulate(stats);
+        }
         for (size_t i = 0; i < this->size(); i++)
         {
-            //TODO: Implement a better wait strategy
-            //busy loop give fastest response, but these are just wasted cycles
-            while (not _worker_data[i]->done) {}
-            _worker_data[i]->done = false;
+            const uhd::tx_flow_ctrl_stats_t fc_stats = this->get_xport_chan_fc_stats(i);
+            stats.num_fc_stalls += fc_stats.num_stalls;
+            stats.fc_stall_time += fc_stats.stall_time;
+            if (_props[i].xport_stats) _props[i].xport_stats(stats);
+        }
+        return stats;
+    }
+
+    //! Wait for a worker thread to finish its batch
+    UHD_INLINE void wait_for_worker(const worker_thread_data_t &worker_data)
+    {
+        size_t spins = 0;
+        while (not worker_data.done)
+        {
+            if (_wait_strategy == WAIT_SPIN or ++spins < MAX_SPIN_CYCLES) continue;
+            boost::unique_lock<boost::mutex> lock(_workers_done_lock);
+            _master_sleeping = true;
+            while (not worker_data.done)
+            {
+                _workers_done.timed_wait(lock, boost::posix_time::milliseconds(long(MAX_WORKER_WAIT*1000)));
+            }
+            _master_sleeping = false;
+        }
+    }
+
+    /*!
+     * Wait for the go signal from the controlling thread.
+     * \return false if the worker should check its stop flag first
+     */
+    UHD_INLINE bool wait_for_go(worker_thread_data_t &worker_data, size_t &spins)
+    {
+        while (not worker_data.go)
+        {
+            if (worker_data.stop) return false;
+            if (_wait_strategy == WAIT_SPIN or ++spins < MAX_SPIN_CYCLES) continue;
+            boost::unique_lock<boost::mutex> lock(worker_data.data_ready_lock);
+            worker_data.sleeping = true;
+            if (not worker_data.go)
+            {
+                worker_data.data_ready.timed_wait(lock, boost::posix_time::milliseconds(long(MAX_WORKER_WAIT*1000)));
+            }
+            worker_data.sleeping = false;
+            return worker_data.go;
         }
+        return true;
+    }
+
+    /*!
+     * Convert and commit one channel's share of the current batch.
+     * A packet is only committed once every channel holds a buffer
+     * for it, so a timeout on any channel stops all of them at the
+     * same packet. An uncommitted buffer is kept for the next batch.
+     * \return the number of packets committed
+     */
+    size_t send_batch(
+        const size_t index,
+        managed_send_buffer::sptr &buff,
+        std::vector<const void *> &in_buffs,
+        stream_stats_counters &stats
+    ){
+        const size_t num_chans = this->size();
+        for (size_t k = 0; k < _convert_num_packets; k++)
+        {
+            //get a buffer, giving up at the timeout or when another channel did
+            const boost::system_time expiration = boost::get_system_time() +
+                boost::posix_time::microseconds(long(_convert_timeout*1e6));
+            while (not buff and not _convert_abort)
+            {
+                const double remaining = double((expiration - boost::get_system_time()).total_microseconds())/1e6;
+                if (remaining <= 0)
+                {
+                    _convert_abort = true;
+                    break;
+                }
+                UHD_TRACE_SCOPE(SEND_GET_BUFF, index);
+                buff = _props[index].get_buff(std::min(remaining, MAX_WORKER_WAIT));
+            }
+            if (not buff) return k;
+
+            const size_t num_bytes = this->convert_packet(index, _packets[k], buff, in_buffs, stats);
+
+            //wait until every channel has a buffer for this packet
+            const size_t num_needed = (k+1)*num_chans;
+            if (++_convert_num_acquired < num_needed)
+            {
+                while (_convert_num_acquired < num_needed and not _convert_abort)
+                {
+                    if (_wait_strategy != WAIT_SPIN) boost::this_thread::yield();
+                }
+                if (_convert_num_acquired < num_needed) return k;
+            }
+
+            //commit the samples to the zero-copy interface
+            {
+                UHD_TRACE_SCOPE(SEND_COMMIT, num_bytes);
+                buff->commit(num_bytes);
+            }
+            this->count_packet(_packets[k], stats);
 
-        _next_packet_seq++; //increment sequence after commits
-        return nsamps_per_buff;
+            //release the buffer
+            buff.reset();
+        }
+        return _convert_num_packets;
     }
 
     /*! Worker thread routine.
      *
-     * - Gets an internal data buffer
-     * - Calls the converter
+     * - Gets internal data buffers
+     * - Calls the converter for every packet of the batch
      * - Releases internal data buffers
      */
     void worker(const size_t index)
     {
-        //maximum number of cycles to spin before waiting on condition variable
-        //the value of 30000000 was derived from 15ms on a 10 GHz CPU divided by 5 cycles per loop
-        //the assumption is that anything held up for 15ms can wait
-        static const size_t MAX_SPIN_CYCLES = 30000000;
-
-        //maximum amount of time to wait before checking the stop flag
-        static const double MAX_WAIT = 0.1;
-
         managed_send_buffer::sptr buff;
-        vrt::if_packet_info_t if_packet_info;
         std::vector<const void *> in_buffs(MAX_INTERLEAVE);
         boost::shared_ptr<worker_thread_data_t> worker_data = _worker_data[index];
-        boost::unique_lock<boost::mutex> lock(worker_data->data_ready_lock);
         size_t spins = 0;
 
+        apply_thread_placement("send_worker");
+
         while (not worker_data->stop)
         {
-            if (not buff)
+            //try to have the first buffer of the next batch ready
+            if (not buff and not worker_data->go)
             {
-                buff = _props[index].get_buff(MAX_WAIT);
-                if (not buff)
-                {
-                    continue;
-                }
-                worker_data->ready = true;
+                buff = _props[index].get_buff(0.0);
             }
 
             //make sure done flag is cleared by controlling thread before waiting on go signal
@@ -507,13 +860,7 @@ private:
                 continue;
             }
 
-            //partial spin lock before wait
-            while (not worker_data->go and spins < MAX_SPIN_CYCLES)
-            {
-                spins++;
-            }
-            if (not worker_data->go and
-                not worker_data->data_ready.timed_wait(lock, boost::posix_time::milliseconds(long(MAX_WAIT*1000))))
+            if (not wait_for_go(*worker_data, spins))
             {
                 continue;
             }
@@ -524,56 +871,82 @@ private:
             //reset the spin count
             spins = 0;
 
-            //pack metadata into a vrt header
-            uint32_t *otw_mem = buff->cast<uint32_t *>() + _header_offset_words32;
-            if_packet_info = *_convert_if_packet_info;
-            if_packet_info.has_sid = _props[index].has_sid;
-            if_packet_info.sid = _props[index].sid;
-            _vrt_packer(otw_mem, if_packet_info);
-            otw_mem += if_packet_info.num_header_words32;
+            worker_data->num_sent = send_batch(index, buff, in_buffs, worker_data->stats);
 
-            //prepare the input buffers
-            for (size_t i = 0; i < _num_inputs; i++)
+            //let the master know that the batch is finished
+            worker_data->done = true;
+            if (_master_sleeping)
             {
-                in_buffs[i] =
-                    (reinterpret_cast<const char *>((*_convert_buffs)[index*_num_inputs + i]))
-                    + _convert_buffer_offset_bytes;
+                boost::lock_guard<boost::mutex> lock(_workers_done_lock);
+                _workers_done.notify_all();
             }
+        }
+    }
 
-            //perform the conversion operation
-            _converter->conv(in_buffs, otw_mem, _convert_nsamps);
-
-            //let the master know that new data can be prepared
-            _worker_data[index]->done = true;
-
-            //commit the samples to the zero-copy interface
-            buff->commit(
-                (_header_offset_words32 + if_packet_info.num_packet_words32)
-                * sizeof(uint32_t)
-            );
+    //! Start the worker thread for a channel, unless it is not needed
+    void start_worker(const size_t index)
+    {
+        if (_worker_threads[index] or not _props.at(index).get_buff or this->is_inline()) return;
+        _worker_threads[index] = _worker_thread_group.create_thread(boost::bind(&send_packet_handler::worker, this, index));
+    }
 
-            //release the buffer
-            buff.reset();
-        }
+    //! Stop and join the worker thread for a channel
+    void stop_worker(const size_t index)
+    {
+        if (not _worker_threads[index]) return;
+        _worker_data[index]->stop = true;
+        _worker_threads[index]->join();
+        _worker_thread_group.remove_thread(_worker_threads[index]);
+        delete _worker_threads[index];
+        _worker_threads[index] = NULL;
+        _worker_data[index]->stop = false;
     }
 
     //! Shared variables for the worker threads
-    size_t _convert_nsamps;
+    std::vector<packet_t> _packets;
+    size_t _convert_num_packets;
     const tx_streamer::buffs_type *_convert_buffs;
-    size_t _convert_buffer_offset_bytes;
-    vrt::if_packet_info_t *_convert_if_packet_info;
-    struct worker_thread_data_t {
-        worker_thread_data_t() : ready(false), go(false), done(false), stop(false) {}
-        boost::atomic_bool ready;
-        boost::atomic_bool go;
-        boost::atomic_bool done;
-        boost::atomic_bool stop;
-        boost::mutex data_ready_lock;
-        boost::condition_variable data_ready;
-    };
+    double _convert_timeout;
+    boost::atomic<size_t> _convert_num_acquired;
+    boost::atomic_bool _convert_abort;
+    std::vector<const void *> _inline_in_buffs;
+
+    //! Streaming counters of the sending thread and of recv_async_msg()
+    stream_stats_counters _stats;
+    stream_stats_counters _async_stats;
+    bool _stats_timing;
+    uhd::stream_stats_t _stats_base;
+    mutable boost::mutex _stats_mutex;
+
+    wait_strategy_t _wait_strategy;
     std::vector< boost::shared_ptr<worker_thread_data_t> > _worker_data;
+    boost::atomic_bool _master_sleeping;
+    boost::mutex _workers_done_lock;
+    boost::condition_variable _workers_done;
     boost::thread_group _worker_thread_group;
     std::vector<boost::thread *> _worker_threads;
+
+    //! Readiness notification, made on the first request
+    boost::mutex _ready_mutex;
+    int _ready_fd;
+    bool _ready_fd_known;
+    event_fd_set::sptr _ready_set;
+
+    int make_ready_fd(void){
+        std::vector<int> fds;
+        for (size_t i = 0; i < _props.size(); i++){
+            if (not _props[i].get_ready_fd) return -1;
+            const int fd = _props[i].get_ready_fd();
+            if (fd < 0) return -1;
+            fds.push_back(fd);
+        }
+        if (fds.size() == 1) return fds.front();
+        _ready_set = event_fd_set::make();
+        for (size_t i = 0; i < fds.size(); i++){
+            if (not _ready_set->add(fds[i])) return -1;
+        }
+        return _ready_set->get_fd();
+    }
 };
 
 class send_packet_streamer : public send_packet_handler, public tx_streamer{
@@ -606,6 +979,33 @@ public:
         return send_packet_handler::recv_async_msg(async_metadata, timeout);
     }
 
+    uhd::tx_flow_ctrl_stats_t get_flow_ctrl_stats(const size_t chan = 0) const{
+        return send_packet_handler::get_xport_chan_fc_stats(chan);
+    }
+
+    void set_async_callback(const async_callback_type &callback){
+        async_event_channel::sptr channel = send_packet_handler::get_async_channel();
+        if (not channel) return tx_streamer::set_async_callback(callback);
+        channel->set_callback(callback);
+    }
+
+    int get_async_fd(void){
+        async_event_channel::sptr channel = send_packet_handler::get_async_channel();
+        return (channel)? channel->get_fd() : -1;
+    }
+
+    uhd::stream_stats_t get_stats(void) const{
+        return send_packet_handler::get_stream_stats();
+    }
+
+    int get_send_fd(void){
+        return send_packet_handler::get_ready_fd();
+    }
+
+    void reset_stats(void){
+        send_packet_handler::reset_stream_stats();
+    }
+
 private:
     size_t _max_num_samps;
 };
@@ -20,11 +20,15 @@
 #include <uhd/transport/udp_simple.hpp> //mtu
 #include <uhd/transport/buffer_pool.hpp>
 
+#include <uhd/exception.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/atomic.hpp>
+#include <uhd/types/time_spec.hpp>
 #include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/thread/thread.hpp> //sleep
+#include <algorithm>
 #include <vector>
 
 using namespace uhd;
@@ -68,14 +72,20 @@ static void check_registry_for_fast_send_threshold(const size_t mtu){
 class udp_zero_copy_asio_mrb : public managed_recv_buffer{
 public:
     udp_zero_copy_asio_mrb(void *mem, int sock_fd, const size_t frame_size):
-        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size), _len(0) { /*NOP*/ }
+        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size), _len(0), _busy_poll_time(0.0) { /*NOP*/ }
 
     void release(void){
         _claimer.release();
     }
 
+    //! Spin on non-blocking reads for up to this many seconds before sleeping in poll()
+    void set_busy_poll(const double secs){
+        _busy_poll_time = secs;
+    }
+
     UHD_INLINE sptr get_new(const double timeout, size_t &index){
         if (not _claimer.claim_with_wait(timeout)) return sptr();
+        double wait_timeout = timeout;
 
         #ifdef MSG_DONTWAIT //try a non-blocking recv() if supported
         _len = ::recv(_sock_fd, (char *)_mem, _frame_size, MSG_DONTWAIT);
@@ -83,9 +93,25 @@ public:
             index++; //advances the caller's buffer
             return make(this, _mem, size_t(_len));
         }
+
+        //spin for the busy poll time at most, then sleep for the rest of the timeout
+        if (_busy_poll_time > 0.0){
+            const time_spec_t start_time = time_spec_t::get_system_time();
+            const time_spec_t spin_end_time = start_time + time_spec_t(std::min(timeout, _busy_poll_time));
+            time_spec_t now;
+            do{
+                _len = ::recv(_sock_fd, (char *)_mem, _frame_size, MSG_DONTWAIT);
+                if (_len > 0){
+                    index++; //advances the caller's buffer
+                    return make(this, _mem, size_t(_len));
+                }
+                now = time_spec_t::get_system_time();
+            } while (now < spin_end_time);
+            wait_timeout = std::max(0.0, timeout - (now - start_time).get_real_secs());
+        }
         #endif
 
-        if (wait_for_recv_ready(_sock_fd, timeout)){
+        if (wait_for_recv_ready(_sock_fd, wait_timeout)){
             _len = ::recv(_sock_fd, (char *)_mem, _frame_size, 0);
             if (_len == 0)
                 throw uhd::io_error("socket closed");
@@ -104,6 +130,7 @@ private:
     int _sock_fd;
     size_t _frame_size;
     ssize_t _len;
+    double _busy_poll_time;
     simple_claimer _claimer;
 };
 
@@ -165,7 +192,8 @@ public:
     udp_zero_copy_asio_impl(
         const std::string &addr,
         const std::string &port,
-        const zero_copy_xport_params& xport_params
+        const zero_copy_xport_params& xport_params,
+        const std::string &local_port
     ):
         _recv_frame_size(xport_params.recv_frame_size),
         _num_recv_frames(xport_params.num_recv_frames),
@@ -189,6 +217,15 @@ public:
         //create, open, and connect the socket
         _socket = socket_sptr(new asio::ip::udp::socket(_io_service));
         _socket->open(asio::ip::udp::v4());
+        if (not local_port.empty()){
+            //a fixed local port lets NIC flow steering rules tell the sockets apart
+            const unsigned short local = boost::lexical_cast<unsigned short>(local_port);
+            boost::system::error_code ec;
+            _socket->bind(asio::ip::udp::endpoint(asio::ip::udp::v4(), local), ec);
+            if (ec) throw uhd::io_error(str(
+                boost::format("Cannot bind UDP port %s: %s") % local_port % ec.message()
+            ));
+        }
         _socket->connect(receiver_endpoint);
         _sock_fd = _socket->native();
 
@@ -207,6 +244,28 @@ public:
         }
     }
 
+    /*!
+     * Busy poll the NIC for up to usecs in socket reads (SO_BUSY_POLL),
+     * and spin on the reads for up to usecs before sleeping until a
+     * packet arrives.
+     */
+    void set_busy_poll(const int usecs){
+        #if defined(SO_BUSY_POLL) && defined(MSG_DONTWAIT)
+        if (::setsockopt(_sock_fd, SOL_SOCKET, SO_BUSY_POLL, &usecs, sizeof(usecs)) < 0){
+            UHD_LOGGER_WARNING("UDP") << boost::format(
+                "Cannot busy poll the socket for %d us: %s\n"
+                "Please run: sudo sysctl -w net.core.busy_read=%d"
+            ) % usecs % strerror(errno) % usecs;
+        }
+        for (size_t i = 0; i < _mrb_pool.size(); i++){
+            _mrb_pool[i]->set_busy_poll(usecs/1e6);
+        }
+        #else
+        UHD_LOGGER_WARNING("UDP") << "Busy polling sockets is not supported on this platform";
+        (void)usecs;
+        #endif
+    }
+
     //get size for internal socket buffer
     template <typename Opt> size_t get_buff_size(void) const{
         Opt option;
@@ -245,6 +304,8 @@ public:
     size_t get_num_send_frames(void) const {return _num_send_frames;}
     size_t get_send_frame_size(void) const {return _send_frame_size;}
 
+    int get_recv_fd(void) {return _sock_fd;}
+
 private:
     //memory management -> buffers and fifos
     const size_t _recv_frame_size, _num_recv_frames;
@@ -330,7 +391,7 @@ udp_zero_copy::sptr udp_zero_copy::make(
     }
 
     udp_zero_copy_asio_impl::sptr udp_trans(
-        new udp_zero_copy_asio_impl(addr, port, xport_params)
+        new udp_zero_copy_asio_impl(addr, port, xport_params, hints.get("local_port", ""))
     );
 
     //call the helper to resize send and recv buffers
@@ -339,5 +400,8 @@ udp_zero_copy::sptr udp_zero_copy::make(
     buff_params_out.send_buff_size =
         resize_buff_helper<asio::socket_base::send_buffer_size>   (udp_trans, usr_send_buff_size, "send");
 
+    const int busy_poll = hints.cast<int>("busy_poll", 0);
+    if (busy_poll > 0) udp_trans->set_busy_poll(busy_poll);
+
     return udp_trans;
 }
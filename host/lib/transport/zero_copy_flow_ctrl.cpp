@@ -53,7 +53,10 @@ public:
         if (_mb)
         {
             _mb->commit(size());
-            while (_flow_ctrl and not _flow_ctrl(_mb)) {}
+            //flow control functions block until ready, retry without spinning if not
+            while (_flow_ctrl and not _flow_ctrl(_mb)) {
+                boost::this_thread::yield();
+            }
             _mb.reset();
         }
     }
@@ -91,7 +94,10 @@ public:
         if (_mb)
         {
             _mb->commit(size());
-            while (_flow_ctrl and not _flow_ctrl(_mb)) {}
+            //flow control functions block until ready, retry without spinning if not
+            while (_flow_ctrl and not _flow_ctrl(_mb)) {
+                boost::this_thread::yield();
+            }
             _mb.reset();
         }
     }
@@ -170,6 +176,11 @@ public:
         return _transport->get_recv_frame_size();
     }
 
+    int get_recv_fd()
+    {
+        return _transport->get_recv_fd();
+    }
+
     /*******************************************************************
      * Send implementation:
      * Pass the send buffer pointer from the underlying transport
@@ -18,9 +18,12 @@
 #include <uhd/transport/zero_copy_recv_offload.hpp>
 #include <uhd/transport/bounded_buffer.hpp>
 #include <uhd/transport/buffer_pool.hpp>
+#include "event_fd.hpp"
 
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/safe_call.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <boost/atomic.hpp>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/thread/mutex.hpp>
@@ -45,6 +48,9 @@ public:
                           const double timeout) :
         _transport(transport), _timeout(timeout),
         _inbox(transport->get_num_recv_frames()),
+        _ready_event(event_fd::make()),
+        _ready_requested(false),
+        _ready_armed(false),
         _recv_done(false)
     {
         UHD_LOGGER_TRACE("XPORT") << "Created threaded transport" ;
@@ -84,10 +90,14 @@ public:
     // pulling pointers to managed receiver buffers quickly
     void enqueue_recv()
     {
+        apply_thread_placement("recv_offload");
         while (not is_recv_done()) {
             managed_recv_buffer::sptr buff = _transport->get_recv_buff(_timeout);
             if (not buff) continue;
-            _inbox.push_with_timed_wait(buff, _timeout);
+            if (not _inbox.push_with_timed_wait(buff, _timeout)) continue;
+            if (_ready_armed and _ready_armed.exchange(false)){
+                _ready_event->signal();
+            }
         }
     }
 
@@ -98,10 +108,30 @@ public:
     managed_recv_buffer::sptr get_recv_buff(double timeout)
     {
         managed_recv_buffer::sptr ptr;
+        if (_inbox.pop_with_haste(ptr)) return ptr;
+
+        //out of buffers: clear the ready descriptor until the next push,
+        //then look again in case the push happened before arming
+        if (_ready_requested){
+            _ready_event->clear();
+            _ready_armed = true;
+            if (_inbox.pop_with_haste(ptr)) return ptr;
+        }
+
         _inbox.pop_with_timed_wait(ptr, timeout);
         return ptr;
     }
 
+    int get_recv_fd(void)
+    {
+        if (_ready_event->get_fd() < 0) return -1;
+        if (not _ready_requested.exchange(true)){
+            //start out readable, buffers may be queued already
+            _ready_event->signal();
+        }
+        return _ready_event->get_fd();
+    }
+
     size_t get_num_recv_frames() const
     {
         return _transport->get_num_recv_frames();
@@ -140,6 +170,11 @@ private:
     // Shared buffers
     bounded_buffer_t _inbox;
 
+    // Readiness notification, only used once requested
+    event_fd::sptr _ready_event;
+    boost::atomic_bool _ready_requested;
+    boost::atomic_bool _ready_armed;
+
     // Threading
     bool _recv_done;
     boost::thread _recv_thread;
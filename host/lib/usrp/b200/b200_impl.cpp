@@ -530,6 +530,9 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     data_xport_args["num_recv_frames"] = device_addr.get("num_recv_frames", "16");
     data_xport_args["send_frame_size"] = device_addr.get("send_frame_size", "8192");
     data_xport_args["num_send_frames"] = device_addr.get("num_send_frames", "16");
+    for(const std::string &key: std::vector<std::string>{"num_frames_auto", "max_num_recv_frames", "max_num_send_frames", "usb_event_thread"}) {
+        if (device_addr.has_key(key)) data_xport_args[key] = device_addr[key];
+    }
 
     // This may throw a uhd::usb_error, which will be caught by b200_make().
     _data_transport = usb_zero_copy::make(
@@ -847,6 +850,10 @@ void b200_impl::setup_radio(const size_t dspno)
         _tree->access<double>(rf_fe_path / "freq" / "value")
             .add_coerced_subscriber(boost::bind(&b200_impl::update_bandsel, this, key, _1))
         ;
+        _tree->access<size_t>(rf_fe_path / "freq" / "fast_lock" / "recall")
+            .add_coerced_subscriber(boost::bind(&b200_impl::update_bandsel, this, key,
+                boost::bind(&ad9361_ctrl::get_freq, _codec_ctrl, key)))
+        ;
         if (dir == RX_DIRECTION)
         {
             static const std::vector<std::string> ants = boost::assign::list_of("TX/RX")("RX2");
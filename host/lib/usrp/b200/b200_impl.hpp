@@ -143,7 +143,7 @@ private:
     uhd::gps_ctrl::sptr _gps;
 
     //transports
-    uhd::transport::zero_copy_if::sptr _data_transport;
+    uhd::transport::usb_zero_copy::sptr _data_transport;
     uhd::transport::zero_copy_if::sptr _ctrl_transport;
     uhd::usrp::recv_packet_demuxer_3000::sptr _demux;
 
@@ -265,6 +265,18 @@ void b200_impl::update_subdev_spec(const std::string &tx_rx, const uhd::usrp::su
     this->update_enables();
 }
 
+/***********************************************************************
+ * Report the (possibly auto tuned) data transport settings in the stats
+ **********************************************************************/
+static void get_data_xport_stats(
+    usb_zero_copy::sptr xport, const bool is_recv, uhd::stream_stats_t &stats
+){
+    stats.xport_frames_in_flight = (is_recv)?
+        xport->get_num_recv_frames_in_flight() : xport->get_num_send_frames_in_flight();
+    stats.xport_frame_size = (is_recv)?
+        xport->get_recv_frame_size() : xport->get_send_frame_size();
+}
+
 static void b200_if_hdr_unpack_le(
     const uint32_t *packet_buff,
     vrt::if_packet_info_t &if_packet_info
@@ -422,6 +434,7 @@ rx_streamer::sptr b200_impl::get_rx_stream(const uhd::stream_args_t &args_)
         my_streamer->resize(args.channels.size());
 
         //init some streamer stuff
+        my_streamer->set_recv_args(args.args);
         my_streamer->set_vrt_unpacker(&b200_if_hdr_unpack_le);
 
         //set the converter
@@ -441,6 +454,9 @@ rx_streamer::sptr b200_impl::get_rx_stream(const uhd::stream_args_t &args_)
         my_streamer->set_xport_chan_get_buff(stream_i, boost::bind(
             &recv_packet_demuxer_3000::get_recv_buff, _demux, sid, _1
         ), true /*flush*/);
+        my_streamer->set_xport_chan_xport_stats(stream_i, boost::bind(
+            &get_data_xport_stats, _data_transport, true, _1
+        ));
         my_streamer->set_overflow_handler(stream_i, boost::bind(
             &b200_impl::handle_overflow, this, radio_index
         ));
@@ -543,9 +559,13 @@ tx_streamer::sptr b200_impl::get_tx_stream(const uhd::stream_args_t &args_)
         perif.deframer->setup(args);
         perif.duc->setup(args);
 
+        my_streamer->set_send_args(args.args);
         my_streamer->set_xport_chan_get_buff(stream_i, boost::bind(
             &zero_copy_if::get_send_buff, _data_transport, _1
         ));
+        my_streamer->set_xport_chan_xport_stats(stream_i, boost::bind(
+            &get_data_xport_stats, _data_transport, false, _1
+        ));
         my_streamer->set_async_receiver(boost::bind(
             &async_md_type::pop_with_timed_wait, _async_task_data->async_md, _1, _2
         ));
@@ -19,6 +19,7 @@
 #include <uhd/types/ranges.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/types/serial.hpp>
+#include <uhd/types/time_spec.hpp>
 #include <cstring>
 #include <boost/format.hpp>
 #include <boost/utility.hpp>
@@ -72,6 +73,23 @@ public:
         _spi_iface->write_spi(_slave_num, config, wr_word, AD9361_SPI_NUM_BITS);
     }
 
+    virtual void poke8_batch(const reg_writes_t &writes)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+
+        uhd::spi_config_t config;
+        config.mosi_edge = uhd::spi_config_t::EDGE_FALL;
+        config.miso_edge = uhd::spi_config_t::EDGE_FALL;    //TODO (Ashish): FPGA SPI workaround. This should be EDGE_RISE
+
+        std::vector<uint32_t> wr_words(writes.size());
+        for (size_t i = 0; i < writes.size(); i++) {
+            wr_words[i] = AD9361_SPI_WRITE_CMD |
+                          ((uint32_t(writes[i].first) << AD9361_SPI_ADDR_SHIFT) & AD9361_SPI_ADDR_MASK) |
+                          ((uint32_t(writes[i].second) << AD9361_SPI_DATA_SHIFT) & AD9361_SPI_DATA_MASK);
+        }
+        _spi_iface->write_spi_batch(_slave_num, config, wr_words, AD9361_SPI_NUM_BITS);
+    }
+
 private:
     uhd::spi_iface::sptr    _spi_iface;
     uint32_t         _slave_num;
@@ -95,7 +113,10 @@ public:
     ad9361_ctrl_impl(ad9361_params::sptr client_settings, ad9361_io::sptr io_iface):
         _device(client_settings, io_iface), _safe_spi(io_iface), _timed_spi(io_iface)
     {
+        const time_spec_t t0 = time_spec_t::get_system_time();
         _device.initialize();
+        UHD_LOGGER_DEBUG("AD936X") << boost::format("Initialization took %.1f ms")
+            % ((time_spec_t::get_system_time() - t0).get_real_secs() * 1e3);
     }
 
     void set_timed_spi(uhd::spi_iface::sptr spi_iface, uint32_t slave_num)
@@ -159,7 +180,10 @@ public:
             ) % (rate/1e6) % (clipped_rate/1e6) ;
         }
 
+        const time_spec_t t0 = time_spec_t::get_system_time();
         double return_rate = _device.set_clock_rate(clipped_rate);
+        UHD_LOGGER_DEBUG("AD936X") << boost::format("Clock rate change to %f MHz took %.1f ms")
+            % (return_rate/1e6) % ((time_spec_t::get_system_time() - t0).get_real_secs() * 1e3);
 
         _use_timed_spi();
 
@@ -202,6 +226,26 @@ public:
         return _device.get_freq(direction);
     }
 
+    //! store a frequency in a fast lock profile, return the exact value
+    double store_fast_lock_profile(const std::string &which, const size_t profile, const double freq)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+
+        const double value = ad9361_ctrl::get_rf_freq_range().clip(freq);
+
+        ad9361_device_t::direction_t direction = _get_direction_from_antenna(which);
+        return _device.store_fast_lock_profile(direction, profile, value);
+    }
+
+    //! switch to a stored fast lock profile, return the exact value
+    double recall_fast_lock_profile(const std::string &which, const size_t profile)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+
+        ad9361_device_t::direction_t direction = _get_direction_from_antenna(which);
+        return _device.recall_fast_lock_profile(direction, profile);
+    }
+
     //! turn on/off data port loopback
     void data_port_loopback(const bool on)
     {
@@ -145,6 +145,32 @@ public:
     //! get the current frequency for the given frontend
     virtual double get_freq(const std::string &which) = 0;
 
+    //! get the number of fast lock profiles available per direction
+    static size_t get_num_fast_lock_profiles(void)
+    {
+        return ad9361_device_t::AD9361_NUM_FAST_LOCK_PROFILES;
+    }
+
+    /*! Store a frequency in one of the fast lock profiles of the given frontend.
+     *
+     * The frontend is tuned and calibrated for \p value, the resulting
+     * synthesizer state is stored in the profile, and the frontend is then
+     * returned to its current frequency.
+     *
+     * \return the exact frequency stored in the profile
+     */
+    virtual double store_fast_lock_profile(const std::string &which, const size_t profile, const double value) = 0;
+
+    /*! Switch the given frontend to a previously stored fast lock profile.
+     *
+     * This is much faster than tune(), as there is no synthesizer programming
+     * or VCO calibration involved.
+     *
+     * \return the exact frequency of the profile
+     * \throws uhd::value_error if the profile was never stored
+     */
+    virtual double recall_fast_lock_profile(const std::string &which, const size_t profile) = 0;
+
     //! turn on/off Catalina's data port loopback
     virtual void data_port_loopback(const bool on) = 0;
 
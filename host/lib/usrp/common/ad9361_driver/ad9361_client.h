@@ -19,6 +19,9 @@
 #define INCLUDED_AD9361_CLIENT_H
 
 #include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <utility>
+#include <vector>
 
 namespace uhd { namespace usrp {
 
@@ -73,11 +76,26 @@ class ad9361_io
 {
 public:
     typedef boost::shared_ptr<ad9361_io> sptr;
+    typedef std::pair<uint32_t, uint8_t> reg_write_t;
+    typedef std::vector<reg_write_t> reg_writes_t;
 
     virtual ~ad9361_io() {}
 
     virtual uint8_t peek8(uint32_t reg) = 0;
     virtual void poke8(uint32_t reg, uint8_t val) = 0;
+
+    /*!
+     * Write a list of registers, in order.
+     *
+     * Implementations should send the whole list in as few transactions
+     * as the transport allows. The default is one poke8() per register.
+     */
+    virtual void poke8_batch(const reg_writes_t &writes)
+    {
+        for (size_t i = 0; i < writes.size(); i++) {
+            poke8(writes[i].first, writes[i].second);
+        }
+    }
 };
 
 
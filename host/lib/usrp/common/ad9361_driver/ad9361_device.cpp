@@ -67,6 +67,18 @@ int freq_is_nearly_equal(double a, double b) {
     return std::max(a,b) - std::min(a,b) < 1;
 }
 
+/* Rate plans and filter calibrations are cached by frequency, rounded to the
+ * nearest Hz so that 'nearly equal' requests share an entry. */
+static int64_t cal_cache_key(const double freq)
+{
+    return static_cast<int64_t>(boost::math::round(freq));
+}
+
+/* Upper bound on the number of cached rate plans and filter calibrations per
+ * direction. Applications cycle through a handful of rates, so this is
+ * plenty; the cache is simply flushed if it is ever exceeded. */
+static const size_t MAX_CAL_CACHE_ENTRIES = 32;
+
 /***********************************************************************
  * Filter functions
  **********************************************************************/
@@ -101,6 +113,9 @@ const double ad9361_device_t::AD9361_RECOMMENDED_MAX_BANDWIDTH = 56e6;
 const double ad9361_device_t::DEFAULT_RX_FREQ = 800e6;
 const double ad9361_device_t::DEFAULT_TX_FREQ = 850e6;
 
+/* Number of fast lock profiles per synthesizer */
+const size_t ad9361_device_t::AD9361_NUM_FAST_LOCK_PROFILES = 8;
+
 /* Program either the RX or TX FIR filter.
  *
  * The process is the same for both filters, but the function must be told
@@ -138,25 +153,30 @@ void ad9361_device_t::_program_fir_filter(direction_t direction, chain_t chain,
     _io_iface->poke8(base + 5, reg_numtaps | reg_chain | 0x02);
     boost::this_thread::sleep(boost::posix_time::milliseconds(1));
 
+    /* The table is programmed through a handful of indirect registers, so
+     * all of the writes below go out as one batch. */
+    ad9361_io::reg_writes_t writes;
+    writes.reserve(128 * 6 + 3);
+
     /* Zero the unused taps just in case they have stale data */
     int addr;
     for (addr = num_taps; addr < 128; addr++) {
-        _io_iface->poke8(base + 0, addr);
-        _io_iface->poke8(base + 1, 0x0);
-        _io_iface->poke8(base + 2, 0x0);
-        _io_iface->poke8(base + 5, reg_numtaps | reg_chain | (1 << 1) | (1 << 2));
-        _io_iface->poke8(base + 4, 0x00);
-        _io_iface->poke8(base + 4, 0x00);
+        writes.push_back(ad9361_io::reg_write_t(base + 0, addr));
+        writes.push_back(ad9361_io::reg_write_t(base + 1, 0x0));
+        writes.push_back(ad9361_io::reg_write_t(base + 2, 0x0));
+        writes.push_back(ad9361_io::reg_write_t(base + 5, reg_numtaps | reg_chain | (1 << 1) | (1 << 2)));
+        writes.push_back(ad9361_io::reg_write_t(base + 4, 0x00));
+        writes.push_back(ad9361_io::reg_write_t(base + 4, 0x00));
     }
 
     /* Iterate through indirect programming of filter coeffs using ADI recomended procedure */
     for (addr = 0; addr < num_taps; addr++) {
-        _io_iface->poke8(base + 0, addr);
-        _io_iface->poke8(base + 1, (coeffs[addr]) & 0xff);
-        _io_iface->poke8(base + 2, (coeffs[addr] >> 8) & 0xff);
-        _io_iface->poke8(base + 5, reg_numtaps | reg_chain | (1 << 1) | (1 << 2));
-        _io_iface->poke8(base + 4, 0x00);
-        _io_iface->poke8(base + 4, 0x00);
+        writes.push_back(ad9361_io::reg_write_t(base + 0, addr));
+        writes.push_back(ad9361_io::reg_write_t(base + 1, (coeffs[addr]) & 0xff));
+        writes.push_back(ad9361_io::reg_write_t(base + 2, (coeffs[addr] >> 8) & 0xff));
+        writes.push_back(ad9361_io::reg_write_t(base + 5, reg_numtaps | reg_chain | (1 << 1) | (1 << 2)));
+        writes.push_back(ad9361_io::reg_write_t(base + 4, 0x00));
+        writes.push_back(ad9361_io::reg_write_t(base + 4, 0x00));
     }
 
     /* UG-671 states (page 25) (paraphrased and clarified):
@@ -165,19 +185,21 @@ void ad9361_device_t::_program_fir_filter(direction_t direction, chain_t chain,
      before the clock stops. Wait 4 sample clock periods after setting D2 high while that data writes into the table"
      */
 
-    _io_iface->poke8(base + 5, reg_numtaps | reg_chain | (1 << 1));
+    writes.push_back(ad9361_io::reg_write_t(base + 5, reg_numtaps | reg_chain | (1 << 1)));
     if (direction == RX) {
-        _io_iface->poke8(base + 5, reg_numtaps | reg_chain );
+        writes.push_back(ad9361_io::reg_write_t(base + 5, reg_numtaps | reg_chain ));
         /* Rx Gain, set to prevent digital overflow/saturation in filters
            0:+6dB, 1:0dB, 2:-6dB, 3:-12dB
            page 35 of UG-671 */
-        _io_iface->poke8(base + 6, 0x02); /* Also turn on -6dB Rx gain here, to stop filter overfow.*/
+        writes.push_back(ad9361_io::reg_write_t(base + 6, 0x02)); /* Also turn on -6dB Rx gain here, to stop filter overfow.*/
     } else {
         /* Tx Gain. bit[0]. set to prevent digital overflow/saturation in filters
            0: 0dB, 1:-6dB
            page 25 of UG-671 */
-        _io_iface->poke8(base + 5, reg_numtaps | reg_chain );
+        writes.push_back(ad9361_io::reg_write_t(base + 5, reg_numtaps | reg_chain ));
     }
+
+    _io_iface->poke8_batch(writes);
 }
 
 
@@ -594,6 +616,93 @@ double ad9361_device_t::_calibrate_rx_TIAs(double req_rfbw)
     return bbbw;
 }
 
+/* Registers written by the analog filter calibrations in set_bw_filter(),
+ * either by the tuners themselves or derived from their results. */
+static const uint16_t RX_BW_FILTER_CAL_REGS[] = {
+    0x1e0, 0x1e1, 0x1e4, 0x1e5, 0x1e6, // BBF R1A, R5, R2346
+    0x1e7, 0x1e8, 0x1e9, 0x1ea, 0x1eb, 0x1ec, // BBF C1, C2, C3
+    0x1fb, 0x1fc, 0x1f8, 0x1f9, // BBF corner and tune divider
+    0x1db, 0x1dd, 0x1df, 0x1dc, 0x1de // TIAs
+};
+static const uint16_t TX_BW_FILTER_CAL_REGS[] = {
+    0x0c2, 0x0c3, 0x0c4, 0x0c5, 0x0c6, 0x0c7, 0x0c8, 0x0c9, // BBF R1-R4, RP, C1, C2, CP
+    0x0d6, 0x0d7, // BBF tune divider
+    0x0d2, 0x0d1, 0x0d0 // Secondary filter
+};
+
+/* Build the filter calibration cache key for the current rate plan. The
+ * calibrations clip the requested bandwidth to the baseband bandwidth, so
+ * rates sharing a BBPLL rate may still need different results. */
+ad9361_device_t::bw_filter_cal_key_t ad9361_device_t::_get_bw_filter_cal_key(const double rf_bw)
+{
+    bw_filter_cal_key_t key;
+    key.bbpll_freq = cal_cache_key(_bbpll_freq);
+    key.baseband_bw = cal_cache_key(_baseband_bw);
+    key.rf_bw = cal_cache_key(rf_bw);
+    return key;
+}
+
+/* Store the results of the analog filter calibrations for the current rate
+ * plan, so a later set_bw_filter() with the same settings can skip them. */
+void ad9361_device_t::_store_bw_filter_cal(direction_t direction, const double rf_bw)
+{
+    bw_filter_cal_cache_t &cache = (direction == RX) ? _rx_bw_filter_cals : _tx_bw_filter_cals;
+    if (cache.size() >= MAX_CAL_CACHE_ENTRIES) {
+        cache.clear();
+    }
+
+    const uint16_t *regs = (direction == RX) ? RX_BW_FILTER_CAL_REGS : TX_BW_FILTER_CAL_REGS;
+    const size_t num_regs = (direction == RX)
+        ? sizeof(RX_BW_FILTER_CAL_REGS) / sizeof(RX_BW_FILTER_CAL_REGS[0])
+        : sizeof(TX_BW_FILTER_CAL_REGS) / sizeof(TX_BW_FILTER_CAL_REGS[0]);
+
+    bw_filter_cal_t cal;
+    if (direction == RX) {
+        cal.bb_lp_bw = _rx_bb_lp_bw;
+        cal.sec_lp_bw = _rx_tia_lp_bw;
+        cal.rx_bbf_tunediv = _rx_bbf_tunediv;
+        cal.bbftune = _regs.bbftune_config;
+    } else {
+        cal.bb_lp_bw = _tx_bb_lp_bw;
+        cal.sec_lp_bw = _tx_sec_lp_bw;
+        cal.bbftune = _regs.bbftune_mode;
+    }
+    cal.regs.reserve(num_regs);
+    for (size_t i = 0; i < num_regs; i++) {
+        cal.regs.push_back(ad9361_io::reg_write_t(regs[i], _io_iface->peek8(regs[i])));
+    }
+
+    cache[_get_bw_filter_cal_key(rf_bw)] = cal;
+}
+
+/* Re-apply previously stored analog filter calibration results. Returns
+ * false if the filters have not been calibrated for this rate plan and
+ * bandwidth yet. */
+bool ad9361_device_t::_restore_bw_filter_cal(direction_t direction, const double rf_bw)
+{
+    const bw_filter_cal_cache_t &cache = (direction == RX) ? _rx_bw_filter_cals : _tx_bw_filter_cals;
+    bw_filter_cal_cache_t::const_iterator it = cache.find(_get_bw_filter_cal_key(rf_bw));
+    if (it == cache.end()) {
+        return false;
+    }
+
+    const bw_filter_cal_t &cal = it->second;
+    _io_iface->poke8_batch(cal.regs);
+    if (direction == RX) {
+        _rx_bb_lp_bw = cal.bb_lp_bw;
+        _rx_tia_lp_bw = cal.sec_lp_bw;
+        _rx_bbf_tunediv = cal.rx_bbf_tunediv;
+        _regs.bbftune_config = cal.bbftune;
+    } else {
+        _tx_bb_lp_bw = cal.bb_lp_bw;
+        _tx_sec_lp_bw = cal.sec_lp_bw;
+        _regs.bbftune_mode = cal.bbftune;
+    }
+    UHD_LOGGER_TRACE("AD936X") << boost::format("[ad9361_device_t::set_bw_filter] using cached %s filter calibration for %f\n")
+        % ((direction == RX) ? "RX" : "TX") % rf_bw;
+    return true;
+}
+
 /* Setup the AD9361 ADC.
  *
  * There are 40 registers that control the ADC's operation, most of the
@@ -717,9 +826,12 @@ void ad9361_device_t::_setup_adc()
     data[39] = 0x00;
 
     /* Program the registers! */
+    ad9361_io::reg_writes_t writes;
+    writes.reserve(40);
     for(size_t i = 0; i < 40; i++) {
-        _io_iface->poke8(0x200+i, data[i]);
+        writes.push_back(ad9361_io::reg_write_t(0x200+i, data[i]));
     }
+    _io_iface->poke8_batch(writes);
 }
 
 /* Calibrate the baseband DC offset.
@@ -956,26 +1068,31 @@ void ad9361_device_t::_program_mixer_gm_subtable()
     uint8_t gm[] = { 0x00, 0x0D, 0x15, 0x1B, 0x21, 0x25, 0x29, 0x2C, 0x2F, 0x31,
             0x33, 0x34, 0x35, 0x3A, 0x3D, 0x3E };
 
+    ad9361_io::reg_writes_t writes;
+    writes.reserve(16 * 7 + 5);
+
     /* Start the clock. */
-    _io_iface->poke8(0x13f, 0x02);
+    writes.push_back(ad9361_io::reg_write_t(0x13f, 0x02));
 
     /* Program the GM Sub-table. */
     int i;
     for (i = 15; i >= 0; i--) {
-        _io_iface->poke8(0x138, i);
-        _io_iface->poke8(0x139, gain[(15 - i)]);
-        _io_iface->poke8(0x13A, 0x00);
-        _io_iface->poke8(0x13B, gm[(15 - i)]);
-        _io_iface->poke8(0x13F, 0x06);
-        _io_iface->poke8(0x13C, 0x00);
-        _io_iface->poke8(0x13C, 0x00);
+        writes.push_back(ad9361_io::reg_write_t(0x138, i));
+        writes.push_back(ad9361_io::reg_write_t(0x139, gain[(15 - i)]));
+        writes.push_back(ad9361_io::reg_write_t(0x13A, 0x00));
+        writes.push_back(ad9361_io::reg_write_t(0x13B, gm[(15 - i)]));
+        writes.push_back(ad9361_io::reg_write_t(0x13F, 0x06));
+        writes.push_back(ad9361_io::reg_write_t(0x13C, 0x00));
+        writes.push_back(ad9361_io::reg_write_t(0x13C, 0x00));
     }
 
     /* Clear write bit and stop clock. */
-    _io_iface->poke8(0x13f, 0x02);
-    _io_iface->poke8(0x13C, 0x00);
-    _io_iface->poke8(0x13C, 0x00);
-    _io_iface->poke8(0x13f, 0x00);
+    writes.push_back(ad9361_io::reg_write_t(0x13f, 0x02));
+    writes.push_back(ad9361_io::reg_write_t(0x13C, 0x00));
+    writes.push_back(ad9361_io::reg_write_t(0x13C, 0x00));
+    writes.push_back(ad9361_io::reg_write_t(0x13f, 0x00));
+
+    _io_iface->poke8_batch(writes);
 }
 
 /* Program the gain table.
@@ -1007,38 +1124,43 @@ void ad9361_device_t::_program_gain_table() {
         _curr_gain_table = new_gain_table;
     }
 
+    ad9361_io::reg_writes_t writes;
+    writes.reserve(91 * 7 + 5);
+
     /* Okay, we have to program a new gain table. Sucks, brah. Start the
      * gain table clock. */
-    _io_iface->poke8(0x137, 0x1A);
+    writes.push_back(ad9361_io::reg_write_t(0x137, 0x1A));
 
     /* IT'S PROGRAMMING TIME. */
     uint8_t index = 0;
     for (; index < 77; index++) {
-        _io_iface->poke8(0x130, index);
-        _io_iface->poke8(0x131, gain_table[index][0]);
-        _io_iface->poke8(0x132, gain_table[index][1]);
-        _io_iface->poke8(0x133, gain_table[index][2]);
-        _io_iface->poke8(0x137, 0x1E);
-        _io_iface->poke8(0x134, 0x00);
-        _io_iface->poke8(0x134, 0x00);
+        writes.push_back(ad9361_io::reg_write_t(0x130, index));
+        writes.push_back(ad9361_io::reg_write_t(0x131, gain_table[index][0]));
+        writes.push_back(ad9361_io::reg_write_t(0x132, gain_table[index][1]));
+        writes.push_back(ad9361_io::reg_write_t(0x133, gain_table[index][2]));
+        writes.push_back(ad9361_io::reg_write_t(0x137, 0x1E));
+        writes.push_back(ad9361_io::reg_write_t(0x134, 0x00));
+        writes.push_back(ad9361_io::reg_write_t(0x134, 0x00));
     }
 
     /* Everything above the 77th index is zero. */
     for (; index < 91; index++) {
-        _io_iface->poke8(0x130, index);
-        _io_iface->poke8(0x131, 0x00);
-        _io_iface->poke8(0x132, 0x00);
-        _io_iface->poke8(0x133, 0x00);
-        _io_iface->poke8(0x137, 0x1E);
-        _io_iface->poke8(0x134, 0x00);
-        _io_iface->poke8(0x134, 0x00);
+        writes.push_back(ad9361_io::reg_write_t(0x130, index));
+        writes.push_back(ad9361_io::reg_write_t(0x131, 0x00));
+        writes.push_back(ad9361_io::reg_write_t(0x132, 0x00));
+        writes.push_back(ad9361_io::reg_write_t(0x133, 0x00));
+        writes.push_back(ad9361_io::reg_write_t(0x137, 0x1E));
+        writes.push_back(ad9361_io::reg_write_t(0x134, 0x00));
+        writes.push_back(ad9361_io::reg_write_t(0x134, 0x00));
     }
 
     /* Clear the write bit and stop the gain clock. */
-    _io_iface->poke8(0x137, 0x1A);
-    _io_iface->poke8(0x134, 0x00);
-    _io_iface->poke8(0x134, 0x00);
-    _io_iface->poke8(0x137, 0x00);
+    writes.push_back(ad9361_io::reg_write_t(0x137, 0x1A));
+    writes.push_back(ad9361_io::reg_write_t(0x134, 0x00));
+    writes.push_back(ad9361_io::reg_write_t(0x134, 0x00));
+    writes.push_back(ad9361_io::reg_write_t(0x137, 0x00));
+
+    _io_iface->poke8_batch(writes);
 }
 
 /* Setup gain control registers.
@@ -1132,107 +1254,76 @@ void ad9361_device_t::_setup_synth(direction_t direction, double vcorate)
     uint8_t loop_filter_r3 = synth_cal_lut[vcoindex][11];
 
     /* ... annnd program! */
+    ad9361_io::reg_writes_t writes;
     if (direction == RX) {
-        _io_iface->poke8(0x23a, 0x40 | vco_output_level);
-        _io_iface->poke8(0x239, 0xC0 | vco_varactor);
-        _io_iface->poke8(0x242, vco_bias_ref | (vco_bias_tcf << 3));
-        _io_iface->poke8(0x238, (vco_cal_offset << 3));
-        _io_iface->poke8(0x245, 0x00);
-        _io_iface->poke8(0x251, vco_varactor_ref);
-        _io_iface->poke8(0x250, 0x70);
-        _io_iface->poke8(0x23b, 0x80 | charge_pump_curr);
-        _io_iface->poke8(0x23e, loop_filter_c1 | (loop_filter_c2 << 4));
-        _io_iface->poke8(0x23f, loop_filter_c3 | (loop_filter_r1 << 4));
-        _io_iface->poke8(0x240, loop_filter_r3);
+        writes.push_back(ad9361_io::reg_write_t(0x23a, 0x40 | vco_output_level));
+        writes.push_back(ad9361_io::reg_write_t(0x239, 0xC0 | vco_varactor));
+        writes.push_back(ad9361_io::reg_write_t(0x242, vco_bias_ref | (vco_bias_tcf << 3)));
+        writes.push_back(ad9361_io::reg_write_t(0x238, (vco_cal_offset << 3)));
+        writes.push_back(ad9361_io::reg_write_t(0x245, 0x00));
+        writes.push_back(ad9361_io::reg_write_t(0x251, vco_varactor_ref));
+        writes.push_back(ad9361_io::reg_write_t(0x250, 0x70));
+        writes.push_back(ad9361_io::reg_write_t(0x23b, 0x80 | charge_pump_curr));
+        writes.push_back(ad9361_io::reg_write_t(0x23e, loop_filter_c1 | (loop_filter_c2 << 4)));
+        writes.push_back(ad9361_io::reg_write_t(0x23f, loop_filter_c3 | (loop_filter_r1 << 4)));
+        writes.push_back(ad9361_io::reg_write_t(0x240, loop_filter_r3));
     } else if (direction == TX) {
-        _io_iface->poke8(0x27a, 0x40 | vco_output_level);
-        _io_iface->poke8(0x279, 0xC0 | vco_varactor);
-        _io_iface->poke8(0x282, vco_bias_ref | (vco_bias_tcf << 3));
-        _io_iface->poke8(0x278, (vco_cal_offset << 3));
-        _io_iface->poke8(0x285, 0x00);
-        _io_iface->poke8(0x291, vco_varactor_ref);
-        _io_iface->poke8(0x290, 0x70);
-        _io_iface->poke8(0x27b, 0x80 | charge_pump_curr);
-        _io_iface->poke8(0x27e, loop_filter_c1 | (loop_filter_c2 << 4));
-        _io_iface->poke8(0x27f, loop_filter_c3 | (loop_filter_r1 << 4));
-        _io_iface->poke8(0x280, loop_filter_r3);
+        writes.push_back(ad9361_io::reg_write_t(0x27a, 0x40 | vco_output_level));
+        writes.push_back(ad9361_io::reg_write_t(0x279, 0xC0 | vco_varactor));
+        writes.push_back(ad9361_io::reg_write_t(0x282, vco_bias_ref | (vco_bias_tcf << 3)));
+        writes.push_back(ad9361_io::reg_write_t(0x278, (vco_cal_offset << 3)));
+        writes.push_back(ad9361_io::reg_write_t(0x285, 0x00));
+        writes.push_back(ad9361_io::reg_write_t(0x291, vco_varactor_ref));
+        writes.push_back(ad9361_io::reg_write_t(0x290, 0x70));
+        writes.push_back(ad9361_io::reg_write_t(0x27b, 0x80 | charge_pump_curr));
+        writes.push_back(ad9361_io::reg_write_t(0x27e, loop_filter_c1 | (loop_filter_c2 << 4)));
+        writes.push_back(ad9361_io::reg_write_t(0x27f, loop_filter_c3 | (loop_filter_r1 << 4)));
+        writes.push_back(ad9361_io::reg_write_t(0x280, loop_filter_r3));
     } else {
         throw uhd::runtime_error("[ad9361_device_t] [_setup_synth] INVALID_CODE_PATH");
     }
+    _io_iface->poke8_batch(writes);
 }
 
 
 /* Tune the baseband VCO.
  *
  * This clock signal is what gets fed to the ADCs and DACs. This function is
- * not exported outside of this file, and is invoked based on the rate
- * fed to the public set_clock_rate function. */
-double ad9361_device_t::_tune_bbvco(const double rate)
+ * not exported outside of this file, and is invoked based on the rate plan
+ * computed for the rate fed to the public set_clock_rate function. */
+double ad9361_device_t::_tune_bbvco(const rate_plan_t &plan)
 {
-    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_tune_bbvco] rate=%.10f\n") % rate;
+    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_tune_bbvco] rate=%.10f\n") % plan.coreclk;
 
     /* Let's not re-tune to the same frequency over and over... */
-    if (freq_is_nearly_equal(rate, _req_coreclk)) {
+    if (freq_is_nearly_equal(plan.coreclk, _req_coreclk)) {
         return _adcclock_freq;
     }
 
-    _req_coreclk = rate;
-
-    const double fref = 40e6;
-    const int modulus = 2088960;
-    const double vcomax = 1430e6;
-    const double vcomin = 672e6;
-    double vcorate;
-    int vcodiv;
-
-    /* Iterate over VCO dividers until appropriate divider is found. */
-    int i = 1;
-    for (; i <= 6; i++) {
-        vcodiv = 1 << i;
-        vcorate = rate * vcodiv;
-
-        if (vcorate >= vcomin && vcorate <= vcomax)
-            break;
-    }
-    if (i == 7)
-        throw uhd::runtime_error("[ad9361_device_t] _tune_bbvco: wrong vcorate");
-
-    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_tune_bbvco] vcodiv=%d vcorate=%.10f\n") % vcodiv % vcorate;
-    /* Fo = Fref * (Nint + Nfrac / mod) */
-    int nint = static_cast<int>(vcorate / fref);
-    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_tune_bbvco] (nint)=%.10f\n") % (vcorate / fref);
-    int nfrac = static_cast<int>(boost::math::round(((vcorate / fref) - (double) nint) * (double) modulus));
-    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_tune_bbvco] (nfrac)=%.10f\n") % (((vcorate / fref) - (double) nint) * (double) modulus);
-    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_tune_bbvco] nint=%d nfrac=%d\n") % nint % nfrac;
-    double actual_vcorate = fref
-            * ((double) nint + ((double) nfrac / (double) modulus));
-
-    /* Scale CP current according to VCO rate */
-    const double icp_baseline = 150e-6;
-    const double freq_baseline = 1280e6;
-    double icp = icp_baseline * (actual_vcorate / freq_baseline);
-    int icp_reg = static_cast<int>(icp / 25e-6) - 1;
+    _req_coreclk = plan.coreclk;
 
-    _io_iface->poke8(0x045, 0x00);            // REFCLK / 1 to BBPLL
-    _io_iface->poke8(0x046, icp_reg & 0x3F);  // CP current
-    _io_iface->poke8(0x048, 0xe8);            // BBPLL loop filters
-    _io_iface->poke8(0x049, 0x5b);            // BBPLL loop filters
-    _io_iface->poke8(0x04a, 0x35);            // BBPLL loop filters
+    ad9361_io::reg_writes_t writes;
+    writes.push_back(ad9361_io::reg_write_t(0x045, 0x00));            // REFCLK / 1 to BBPLL
+    writes.push_back(ad9361_io::reg_write_t(0x046, plan.bbpll_icp & 0x3F));  // CP current
+    writes.push_back(ad9361_io::reg_write_t(0x048, 0xe8));            // BBPLL loop filters
+    writes.push_back(ad9361_io::reg_write_t(0x049, 0x5b));            // BBPLL loop filters
+    writes.push_back(ad9361_io::reg_write_t(0x04a, 0x35));            // BBPLL loop filters
 
-    _io_iface->poke8(0x04b, 0xe0);
-    _io_iface->poke8(0x04e, 0x10);            // Max accuracy
+    writes.push_back(ad9361_io::reg_write_t(0x04b, 0xe0));
+    writes.push_back(ad9361_io::reg_write_t(0x04e, 0x10));            // Max accuracy
 
-    _io_iface->poke8(0x043, nfrac & 0xFF);         // Nfrac[7:0]
-    _io_iface->poke8(0x042, (nfrac >> 8) & 0xFF);  // Nfrac[15:8]
-    _io_iface->poke8(0x041, (nfrac >> 16) & 0xFF); // Nfrac[23:16]
-    _io_iface->poke8(0x044, nint);                 // Nint
+    writes.push_back(ad9361_io::reg_write_t(0x043, plan.bbpll_nfrac & 0xFF));         // Nfrac[7:0]
+    writes.push_back(ad9361_io::reg_write_t(0x042, (plan.bbpll_nfrac >> 8) & 0xFF));  // Nfrac[15:8]
+    writes.push_back(ad9361_io::reg_write_t(0x041, (plan.bbpll_nfrac >> 16) & 0xFF)); // Nfrac[23:16]
+    writes.push_back(ad9361_io::reg_write_t(0x044, plan.bbpll_nint));                 // Nint
+    _io_iface->poke8_batch(writes);
 
     _calibrate_lock_bbpll();
 
-    _regs.bbpll = (_regs.bbpll & 0xF8) | i;
+    _regs.bbpll = (_regs.bbpll & 0xF8) | plan.bbpll_vcodiv;
 
-    _bbpll_freq = actual_vcorate;
-    _adcclock_freq = (actual_vcorate / vcodiv);
+    _bbpll_freq = plan.bbpll_freq;
+    _adcclock_freq = plan.adcclk;
 
     return _adcclock_freq;
 }
@@ -1256,6 +1347,10 @@ void ad9361_device_t::_reprogram_gains()
  * tune the RX or TX VCO. */
 double ad9361_device_t::_tune_helper(direction_t direction, const double value)
 {
+    /* The synthesizer only follows the SPI-programmed words while it is not
+     * running off a fast lock profile. */
+    _disable_fast_lock(direction);
+
     /* The RFPLL runs from 6 GHz - 12 GHz */
     const double fref = 80e6;
     const int modulus = 8388593;
@@ -1310,12 +1405,14 @@ double ad9361_device_t::_tune_helper(direction_t direction, const double value)
         _setup_synth(RX, actual_vcorate);
 
         /* Tune!!!! */
-        _io_iface->poke8(0x233, nfrac & 0xFF);
-        _io_iface->poke8(0x234, (nfrac >> 8) & 0xFF);
-        _io_iface->poke8(0x235, (nfrac >> 16) & 0xFF);
-        _io_iface->poke8(0x232, (nint >> 8) & 0xFF);
-        _io_iface->poke8(0x231, nint & 0xFF);
-        _io_iface->poke8(0x005, _regs.vcodivs);
+        ad9361_io::reg_writes_t writes;
+        writes.push_back(ad9361_io::reg_write_t(0x233, nfrac & 0xFF));
+        writes.push_back(ad9361_io::reg_write_t(0x234, (nfrac >> 8) & 0xFF));
+        writes.push_back(ad9361_io::reg_write_t(0x235, (nfrac >> 16) & 0xFF));
+        writes.push_back(ad9361_io::reg_write_t(0x232, (nint >> 8) & 0xFF));
+        writes.push_back(ad9361_io::reg_write_t(0x231, nint & 0xFF));
+        writes.push_back(ad9361_io::reg_write_t(0x005, _regs.vcodivs));
+        _io_iface->poke8_batch(writes);
 
         /* Lock the PLL! */
         boost::this_thread::sleep(boost::posix_time::milliseconds(2));
@@ -1351,12 +1448,14 @@ double ad9361_device_t::_tune_helper(direction_t direction, const double value)
         _setup_synth(TX, actual_vcorate);
 
         /* Tune it, homey. */
-        _io_iface->poke8(0x273, nfrac & 0xFF);
-        _io_iface->poke8(0x274, (nfrac >> 8) & 0xFF);
-        _io_iface->poke8(0x275, (nfrac >> 16) & 0xFF);
-        _io_iface->poke8(0x272, (nint >> 8) & 0xFF);
-        _io_iface->poke8(0x271, nint & 0xFF);
-        _io_iface->poke8(0x005, _regs.vcodivs);
+        ad9361_io::reg_writes_t writes;
+        writes.push_back(ad9361_io::reg_write_t(0x273, nfrac & 0xFF));
+        writes.push_back(ad9361_io::reg_write_t(0x274, (nfrac >> 8) & 0xFF));
+        writes.push_back(ad9361_io::reg_write_t(0x275, (nfrac >> 16) & 0xFF));
+        writes.push_back(ad9361_io::reg_write_t(0x272, (nint >> 8) & 0xFF));
+        writes.push_back(ad9361_io::reg_write_t(0x271, nint & 0xFF));
+        writes.push_back(ad9361_io::reg_write_t(0x005, _regs.vcodivs));
+        _io_iface->poke8_batch(writes);
 
         /* Lock the PLL! */
         boost::this_thread::sleep(boost::posix_time::milliseconds(2));
@@ -1370,127 +1469,136 @@ double ad9361_device_t::_tune_helper(direction_t direction, const double value)
     }
 }
 
-/* Configure the various clock / sample rates in the RX and TX chains.
+/* Compute the rate plan for a requested clock rate.
  *
- * Functionally, this function configures AD9361's RX and TX rates. For
- * a requested TX & RX rate, it sets the interpolation & decimation filters,
- * and tunes the VCO that feeds the ADCs and DACs.
+ * This works out the decimation / interpolation filter selections, the BBPLL
+ * settings and the FIR lengths for the requested rate. It does not touch the
+ * hardware, so the result can be cached and re-applied by _setup_rates().
  */
-double ad9361_device_t::_setup_rates(const double rate)
+ad9361_device_t::rate_plan_t ad9361_device_t::_compute_rate_plan(const double rate)
 {
-    /* If we make it into this function, then we are tuning to a new rate.
-     * Store the new rate. */
-    _req_clock_rate = rate;
-    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_setup_rates] rate=%.6d\n") % rate;
-
-    /* Set the decimation and interpolation values in the RX and TX chains.
-     * This also switches filters in / out. Note that all transmitters and
-     * receivers have to be turned on for the calibration portion of
-     * bring-up, and then they will be switched out to reflect the actual
-     * user-requested antenna selections. */
+    rate_plan_t plan;
     int divfactor = 0;
-    _tfir_factor = 0;
-    _rfir_factor = 0;
 
     if (rate < 0.33e6) {
         // RX1 + RX2 enabled, 3, 2, 2, 4
-        _regs.rxfilt = B8(11101111);
+        plan.rxfilt = B8(11101111);
 
         // TX1 + TX2 enabled, 3, 2, 2, 4
-        _regs.txfilt = B8(11101111);
+        plan.txfilt = B8(11101111);
 
         divfactor = 48;
-        _tfir_factor = 4;
-        _rfir_factor = 4;
+        plan.tfir_factor = 4;
+        plan.rfir_factor = 4;
     } else if (rate < 0.66e6) {
         // RX1 + RX2 enabled, 2, 2, 2, 4
-        _regs.rxfilt = B8(11011111);
+        plan.rxfilt = B8(11011111);
 
         // TX1 + TX2 enabled, 2, 2, 2, 4
-        _regs.txfilt = B8(11011111);
+        plan.txfilt = B8(11011111);
 
         divfactor = 32;
-        _tfir_factor = 4;
-        _rfir_factor = 4;
+        plan.tfir_factor = 4;
+        plan.rfir_factor = 4;
     } else if (rate <= 20e6) {
         // RX1 + RX2 enabled, 2, 2, 2, 2
-        _regs.rxfilt = B8(11011110);
+        plan.rxfilt = B8(11011110);
 
         // TX1 + TX2 enabled, 2, 2, 2, 2
-        _regs.txfilt = B8(11011110);
+        plan.txfilt = B8(11011110);
 
         divfactor = 16;
-        _tfir_factor = 2;
-        _rfir_factor = 2;
+        plan.tfir_factor = 2;
+        plan.rfir_factor = 2;
     } else if ((rate > 20e6) && (rate < 23e6)) {
         // RX1 + RX2 enabled, 3, 2, 2, 2
-        _regs.rxfilt = B8(11101110);
+        plan.rxfilt = B8(11101110);
 
         // TX1 + TX2 enabled, 3, 1, 2, 2
-        _regs.txfilt = B8(11100110);
+        plan.txfilt = B8(11100110);
 
         divfactor = 24;
-        _tfir_factor = 2;
-        _rfir_factor = 2;
+        plan.tfir_factor = 2;
+        plan.rfir_factor = 2;
     } else if ((rate >= 23e6) && (rate < 41e6)) {
         // RX1 + RX2 enabled, 2, 2, 2, 2
-        _regs.rxfilt = B8(11011110);
+        plan.rxfilt = B8(11011110);
 
         // TX1 + TX2 enabled, 1, 2, 2, 2
-        _regs.txfilt = B8(11001110);
+        plan.txfilt = B8(11001110);
 
         divfactor = 16;
-        _tfir_factor = 2;
-        _rfir_factor = 2;
+        plan.tfir_factor = 2;
+        plan.rfir_factor = 2;
     } else if ((rate >= 41e6) && (rate <= 58e6)) {
         // RX1 + RX2 enabled, 3, 1, 2, 2
-        _regs.rxfilt = B8(11100110);
+        plan.rxfilt = B8(11100110);
 
         // TX1 + TX2 enabled, 3, 1, 1, 2
-        _regs.txfilt = B8(11100010);
+        plan.txfilt = B8(11100010);
 
         divfactor = 12;
-        _tfir_factor = 2;
-        _rfir_factor = 2;
+        plan.tfir_factor = 2;
+        plan.rfir_factor = 2;
     } else if ((rate > 58e6) && (rate <= 61.44e6)) {
         // RX1 + RX2 enabled, 2, 1, 2, 2
-        _regs.rxfilt = B8(11010110);
+        plan.rxfilt = B8(11010110);
 
         // TX1 + TX2 enabled, 2, 1, 1, 2
-        _regs.txfilt = B8(11010010);
+        plan.txfilt = B8(11010010);
 
         divfactor = 8;
-        _tfir_factor = 2;
-        _rfir_factor = 2;
+        plan.tfir_factor = 2;
+        plan.rfir_factor = 2;
     } else {
         // should never get in here
-        throw uhd::runtime_error("[ad9361_device_t] [_setup_rates] INVALID_CODE_PATH");
+        throw uhd::runtime_error("[ad9361_device_t] [_compute_rate_plan] INVALID_CODE_PATH");
     }
 
-    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_setup_rates] divfactor=%d\n") % divfactor;
+    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_compute_rate_plan] divfactor=%d\n") % divfactor;
 
-    /* Tune the BBPLL to get the ADC and DAC clocks. */
-    const double adcclk = _tune_bbvco(rate * divfactor);
-    double dacclk = adcclk;
+    /* Work out the BBPLL settings that give us the ADC and DAC clocks. */
+    const double fref = 40e6;
+    const int modulus = 2088960;
+    const double vcomax = 1430e6;
+    const double vcomin = 672e6;
+    plan.coreclk = rate * divfactor;
+    double vcorate = 0.0;
+    int vcodiv = 0;
 
-    /* The DAC clock must be <= 336e6, and is either the ADC clock or 1/2 the
-     * ADC clock.*/
-    if (adcclk > 336e6) {
-        /* Make the DAC clock = ADC/2 */
-        _regs.bbpll = _regs.bbpll | 0x08;
-        dacclk = adcclk / 2.0;
-    } else {
-        _regs.bbpll = _regs.bbpll & 0xF7;
+    /* Iterate over VCO dividers until appropriate divider is found. */
+    int i = 1;
+    for (; i <= 6; i++) {
+        vcodiv = 1 << i;
+        vcorate = plan.coreclk * vcodiv;
+
+        if (vcorate >= vcomin && vcorate <= vcomax)
+            break;
     }
+    if (i == 7)
+        throw uhd::runtime_error("[ad9361_device_t] _compute_rate_plan: wrong vcorate");
 
-    /* Set the dividers / interpolators in AD9361. */
-    _io_iface->poke8(0x002, _regs.txfilt);
-    _io_iface->poke8(0x003, _regs.rxfilt);
-    _io_iface->poke8(0x004, _regs.inputsel);
-    _io_iface->poke8(0x00A, _regs.bbpll);
+    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_compute_rate_plan] vcodiv=%d vcorate=%.10f\n") % vcodiv % vcorate;
+    /* Fo = Fref * (Nint + Nfrac / mod) */
+    plan.bbpll_vcodiv = i;
+    plan.bbpll_nint = static_cast<int>(vcorate / fref);
+    plan.bbpll_nfrac = static_cast<int>(boost::math::round(((vcorate / fref) - (double) plan.bbpll_nint) * (double) modulus));
+    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_compute_rate_plan] nint=%d nfrac=%d\n") % plan.bbpll_nint % plan.bbpll_nfrac;
+    plan.bbpll_freq = fref
+            * ((double) plan.bbpll_nint + ((double) plan.bbpll_nfrac / (double) modulus));
+    plan.adcclk = plan.bbpll_freq / vcodiv;
 
-    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_setup_rates] adcclk=%f\n") % adcclk;
-    _baseband_bw = (adcclk / divfactor);
+    /* Scale CP current according to VCO rate */
+    const double icp_baseline = 150e-6;
+    const double freq_baseline = 1280e6;
+    double icp = icp_baseline * (plan.bbpll_freq / freq_baseline);
+    plan.bbpll_icp = static_cast<int>(icp / 25e-6) - 1;
+
+    /* The DAC clock must be <= 336e6, and is either the ADC clock or 1/2 the
+     * ADC clock.*/
+    plan.dac_half_rate = (plan.adcclk > 336e6);
+    const double dacclk = plan.dac_half_rate ? (plan.adcclk / 2.0) : plan.adcclk;
+    plan.baseband_bw = plan.adcclk / divfactor;
 
     /*
      The Tx & Rx FIR calculate 16 taps per clock cycle. This limits the number of available taps to the ratio of DAC_CLK/ADC_CLK
@@ -1502,15 +1610,74 @@ double ad9361_device_t::_setup_rates(const double rate)
      */
     const size_t max_tx_taps = std::min<size_t>(
             std::min<size_t>((16 * (int)((dacclk / rate) + 0.5)), 128),
-            (_tfir_factor == 1) ? 64 : 128);
-    const size_t max_rx_taps = std::min<size_t>((16 * (size_t)((adcclk / rate) + 0.5)),
+            (plan.tfir_factor == 1) ? 64 : 128);
+    const size_t max_rx_taps = std::min<size_t>((16 * (size_t)((plan.adcclk / rate) + 0.5)),
             128);
 
-    const size_t num_tx_taps = get_num_taps(max_tx_taps);
-    const size_t num_rx_taps = get_num_taps(max_rx_taps);
+    plan.num_tx_taps = get_num_taps(max_tx_taps);
+    plan.num_rx_taps = get_num_taps(max_rx_taps);
+
+    return plan;
+}
+
+/* Configure the various clock / sample rates in the RX and TX chains.
+ *
+ * Functionally, this function configures AD9361's RX and TX rates. For
+ * a requested TX & RX rate, it sets the interpolation & decimation filters,
+ * and tunes the VCO that feeds the ADCs and DACs.
+ *
+ * Rate plans are cached per requested rate, so switching between a small set
+ * of rates only pays for the hardware accesses.
+ */
+double ad9361_device_t::_setup_rates(const double rate)
+{
+    /* If we make it into this function, then we are tuning to a new rate.
+     * Store the new rate. */
+    _req_clock_rate = rate;
+    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_setup_rates] rate=%.6d\n") % rate;
+
+    const int64_t key = cal_cache_key(rate);
+    if (_rate_plans.count(key) == 0) {
+        if (_rate_plans.size() >= MAX_CAL_CACHE_ENTRIES) {
+            _rate_plans.clear();
+        }
+        _rate_plans[key] = _compute_rate_plan(rate);
+    } else {
+        UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_setup_rates] using cached rate plan for %f\n") % rate;
+    }
+    const rate_plan_t &plan = _rate_plans[key];
+
+    /* Set the decimation and interpolation values in the RX and TX chains.
+     * This also switches filters in / out. Note that all transmitters and
+     * receivers have to be turned on for the calibration portion of
+     * bring-up, and then they will be switched out to reflect the actual
+     * user-requested antenna selections. */
+    _regs.rxfilt = plan.rxfilt;
+    _regs.txfilt = plan.txfilt;
+    _tfir_factor = plan.tfir_factor;
+    _rfir_factor = plan.rfir_factor;
 
-    _setup_tx_fir(num_tx_taps,_tfir_factor);
-    _setup_rx_fir(num_rx_taps,_rfir_factor);
+    /* Tune the BBPLL to get the ADC and DAC clocks. */
+    const double adcclk = _tune_bbvco(plan);
+
+    if (plan.dac_half_rate) {
+        /* Make the DAC clock = ADC/2 */
+        _regs.bbpll = _regs.bbpll | 0x08;
+    } else {
+        _regs.bbpll = _regs.bbpll & 0xF7;
+    }
+
+    /* Set the dividers / interpolators in AD9361. */
+    _io_iface->poke8(0x002, _regs.txfilt);
+    _io_iface->poke8(0x003, _regs.rxfilt);
+    _io_iface->poke8(0x004, _regs.inputsel);
+    _io_iface->poke8(0x00A, _regs.bbpll);
+
+    UHD_LOGGER_TRACE("AD936X")<< boost::format("[ad9361_device_t::_setup_rates] adcclk=%f\n") % adcclk;
+    _baseband_bw = plan.baseband_bw;
+
+    _setup_tx_fir(plan.num_tx_taps, _tfir_factor);
+    _setup_rx_fir(plan.num_rx_taps, _rfir_factor);
 
     return _baseband_bw;
 }
@@ -1558,7 +1725,14 @@ void ad9361_device_t::initialize()
     _rx_tia_lp_bw = 0;
     _tx_sec_lp_bw = 0;
     _rx_bb_lp_bw = 0;
+    _rx_fast_lock_profiles.assign(AD9361_NUM_FAST_LOCK_PROFILES, fast_lock_profile_t());
+    _tx_fast_lock_profiles.assign(AD9361_NUM_FAST_LOCK_PROFILES, fast_lock_profile_t());
+    _rx_fast_lock_active = -1;
+    _tx_fast_lock_active = -1;
     _tx_bb_lp_bw = 0;
+    _rate_plans.clear();
+    _rx_bw_filter_cals.clear();
+    _tx_bw_filter_cals.clear();
 
     /* Reset the device. */
     _io_iface->poke8(0x000, 0x01);
@@ -2002,22 +2176,31 @@ void ad9361_device_t::set_active_chains(bool tx1, bool tx2, bool rx1, bool rx2)
 double ad9361_device_t::tune(direction_t direction, const double value)
 {
     boost::lock_guard<boost::recursive_mutex> lock(_mutex);
-    double last_cal_freq;
 
+    /* Requesting the frequency the synthesizer is already at (e.g. after
+     * recalling a fast lock profile) is not a change either. */
     if (direction == RX) {
-        if (freq_is_nearly_equal(value, _req_rx_freq)) {
+        if (freq_is_nearly_equal(value, _req_rx_freq) or freq_is_nearly_equal(value, _rx_freq)) {
             return _rx_freq;
         }
-        last_cal_freq = _last_rx_cal_freq;
     } else if (direction == TX) {
-        if (freq_is_nearly_equal(value, _req_tx_freq)) {
+        if (freq_is_nearly_equal(value, _req_tx_freq) or freq_is_nearly_equal(value, _tx_freq)) {
             return _tx_freq;
         }
-        last_cal_freq = _last_tx_cal_freq;
     } else {
         throw uhd::runtime_error("[ad9361_device_t] [tune] INVALID_CODE_PATH");
     }
 
+    return _tune_and_calibrate(direction, value);
+}
+
+/* Tune the RX or TX synthesizer and run any calibrations that are due
+ * because of the frequency change. Unlike tune(), this never skips the tune
+ * for redundant requests. */
+double ad9361_device_t::_tune_and_calibrate(direction_t direction, const double value)
+{
+    const double last_cal_freq = (direction == RX) ? _last_rx_cal_freq : _last_tx_cal_freq;
+
     /* If we aren't already in the ALERT state, we will need to return to
      * the FDD state after tuning. */
     int not_in_alert = 0;
@@ -2071,6 +2254,168 @@ double ad9361_device_t::tune(direction_t direction, const double value)
     return tune_freq;
 }
 
+/* Store an RX or TX frequency in a fast lock profile.
+ *
+ * Every profile consists of 16 configuration words, which hold the
+ * synthesizer integer and fractional words, the VCO and loop filter settings
+ * from the synthesizer look-up table, and the results of the VCO
+ * calibration. The words are read back after a regular tune, so they are
+ * exactly what the synthesizer ended up with. The layout of the words is
+ * described in the AD9361 reference manual (UG-570), "Fast Lock Profiles". */
+double ad9361_device_t::store_fast_lock_profile(direction_t direction, const size_t profile, const double value)
+{
+    boost::lock_guard<boost::recursive_mutex> lock(_mutex);
+
+    if (profile >= AD9361_NUM_FAST_LOCK_PROFILES) {
+        throw uhd::value_error(str(
+            boost::format("[ad9361_device_t] Invalid fast lock profile: %d") % profile));
+    }
+
+    std::vector<fast_lock_profile_t> &profiles =
+        (direction == RX) ? _rx_fast_lock_profiles : _tx_fast_lock_profiles;
+    const int prev_profile = (direction == RX) ? _rx_fast_lock_active : _tx_fast_lock_active;
+    const double prev_freq = (direction == RX) ? _req_rx_freq : _req_tx_freq;
+
+    /* If we aren't already in the ALERT state, we will need to return to
+     * the FDD state after storing the profile. */
+    int not_in_alert = 0;
+    if ((_io_iface->peek8(0x017) & 0x0F) != 5) {
+        not_in_alert = 1;
+        _io_iface->poke8(0x014, 0x01);
+    }
+
+    const double actual_freq = _tune_and_calibrate(direction, value);
+
+    /* TX synthesizer registers are offset by 0x40 from their RX counterparts. */
+    const uint32_t offs = (direction == RX) ? 0x000 : 0x040;
+    const uint8_t vcodiv = (direction == RX) ?
+        (_regs.vcodivs & 0x0F) : ((_regs.vcodivs >> 4) & 0x0F);
+    const uint8_t bias = _io_iface->peek8(0x242 + offs);
+    const uint8_t cp_current = _io_iface->peek8(0x23b + offs) & 0x3F;
+    const uint8_t loop_filter_1 = _io_iface->peek8(0x23e + offs);
+    const uint8_t loop_filter_2 = _io_iface->peek8(0x23f + offs);
+    const uint8_t loop_filter_r3 = _io_iface->peek8(0x240 + offs) & 0x0F;
+    const uint8_t force_vco_tune_1 = _io_iface->peek8(0x238 + offs);
+
+    uint8_t words[16];
+    words[0] = _io_iface->peek8(0x231 + offs);              // Nint[7:0]
+    words[1] = _io_iface->peek8(0x232 + offs);              // Nint[10:8]
+    words[2] = _io_iface->peek8(0x233 + offs);              // Nfrac[7:0]
+    words[3] = _io_iface->peek8(0x234 + offs);              // Nfrac[15:8]
+    words[4] = _io_iface->peek8(0x235 + offs);              // Nfrac[22:16]
+    words[5] = ((bias & 0x07) << 4)                         // VCO bias ref
+             | (_io_iface->peek8(0x239 + offs) & 0x0F);     // VCO varactor
+    words[6] = (((bias >> 3) & 0x03) << 6) | cp_current;    // VCO bias TCF, CP current (init)
+    words[7] = cp_current;                                  // CP current (steady state)
+    words[8] = (loop_filter_r3 << 4) | loop_filter_r3;      // R3 (init, steady state)
+    words[9] = ((loop_filter_2 & 0x0F) << 4)                // C3 (init, steady state)
+             | (loop_filter_2 & 0x0F);
+    words[10] = ((loop_filter_1 & 0x0F) << 4)               // C1, C2
+              | ((loop_filter_1 >> 4) & 0x0F);
+    words[11] = (loop_filter_2 & 0xF0)                      // R1 (init, steady state)
+              | ((loop_filter_2 >> 4) & 0x0F);
+    words[12] = (((_io_iface->peek8(0x250 + offs) >> 4) & 0x07) << 4)  // Varactor ref TCF
+              | vcodiv;                                     // VCO divider
+    words[13] = (((force_vco_tune_1 >> 3) & 0x0F) << 4)     // VCO cal offset
+              | (_io_iface->peek8(0x251 + offs) & 0x0F);    // Varactor reference
+    words[14] = _io_iface->peek8(0x237 + offs);             // VCO tune[7:0]
+    words[15] = (((_io_iface->peek8(0x236 + offs) >> 1) & 0x7F) << 1)  // ALC word
+              | ((force_vco_tune_1 >> 2) & 0x01);           // Force VCO tune
+
+    /* Program the profile words through the fast lock program interface. */
+    ad9361_io::reg_writes_t writes;
+    for (uint8_t word = 0; word < 16; word++) {
+        writes.push_back(ad9361_io::reg_write_t(0x25c + offs, ((profile & 0x7) << 4) | word)); // Program address
+        writes.push_back(ad9361_io::reg_write_t(0x25d + offs, words[word]));                   // Program data
+        writes.push_back(ad9361_io::reg_write_t(0x25f + offs, 0x03));                          // Write, clock enable
+    }
+    writes.push_back(ad9361_io::reg_write_t(0x25f + offs, 0x00));
+    _io_iface->poke8_batch(writes);
+
+    fast_lock_profile_t &entry = profiles[profile];
+    entry.valid = true;
+    entry.freq = actual_freq;
+    entry.req_freq = value;
+    entry.inputsel = _regs.inputsel & ((direction == RX) ? 0x3F : 0x40);
+    entry.vcodiv = vcodiv;
+
+    /* Go back to where we were before the profile was stored. */
+    if (prev_profile >= 0) {
+        recall_fast_lock_profile(direction, size_t(prev_profile));
+    } else if (prev_freq != 0.0) {
+        _tune_and_calibrate(direction, prev_freq);
+    }
+
+    if (not_in_alert) {
+        _io_iface->poke8(0x014, 0x21);
+    }
+
+    return actual_freq;
+}
+
+/* Switch the RX or TX synthesizer to a stored fast lock profile.
+ *
+ * Only the fast lock setup register needs to be written, unless the profile
+ * lies in a different band than the current frequency. In that case, the
+ * band select and (for RX) the gain table also need updating. */
+double ad9361_device_t::recall_fast_lock_profile(direction_t direction, const size_t profile)
+{
+    boost::lock_guard<boost::recursive_mutex> lock(_mutex);
+
+    std::vector<fast_lock_profile_t> &profiles =
+        (direction == RX) ? _rx_fast_lock_profiles : _tx_fast_lock_profiles;
+    if (profile >= AD9361_NUM_FAST_LOCK_PROFILES or not profiles[profile].valid) {
+        throw uhd::value_error(str(
+            boost::format("[ad9361_device_t] Fast lock profile %d has not been stored") % profile));
+    }
+    const fast_lock_profile_t &entry = profiles[profile];
+
+    const uint8_t inputsel_mask = (direction == RX) ? 0x3F : 0x40;
+    const uint8_t inputsel = (_regs.inputsel & ~inputsel_mask) | entry.inputsel;
+    if (inputsel != _regs.inputsel) {
+        _regs.inputsel = inputsel;
+        _io_iface->poke8(0x004, _regs.inputsel);
+    }
+
+    /* Profile number, fast lock mode enable */
+    const uint32_t offs = (direction == RX) ? 0x000 : 0x040;
+    _io_iface->poke8(0x25a + offs, ((profile & 0x7) << 5) | 0x01);
+
+    /* The VCO divider is part of the profile; keep our soft-copy in sync so
+     * that the next regular tune of the other synthesizer doesn't clobber it. */
+    if (direction == RX) {
+        _regs.vcodivs = (_regs.vcodivs & 0xF0) | entry.vcodiv;
+        _rx_fast_lock_active = int(profile);
+        _req_rx_freq = entry.req_freq;
+        _rx_freq = entry.freq;
+
+        const uint8_t prev_gain_table = _curr_gain_table;
+        _program_gain_table();
+        if (_curr_gain_table != prev_gain_table) {
+            _reprogram_gains();
+        }
+    } else {
+        _regs.vcodivs = (_regs.vcodivs & 0x0F) | (entry.vcodiv << 4);
+        _tx_fast_lock_active = int(profile);
+        _req_tx_freq = entry.req_freq;
+        _tx_freq = entry.freq;
+    }
+
+    return entry.freq;
+}
+
+/* Hand control of the RX or TX synthesizer back to the SPI-programmed
+ * synthesizer words. */
+void ad9361_device_t::_disable_fast_lock(direction_t direction)
+{
+    int &active = (direction == RX) ? _rx_fast_lock_active : _tx_fast_lock_active;
+    if (active < 0) {
+        return;
+    }
+    _io_iface->poke8((direction == RX) ? 0x25a : 0x29a, 0x00);
+    active = -1;
+}
+
 /* Get the current RX or TX frequency. */
 double ad9361_device_t::get_freq(direction_t direction)
 {
@@ -2421,13 +2766,19 @@ double ad9361_device_t::set_bw_filter(direction_t direction, const double rf_bw)
     double set_analog_bb_bw = 0;
     if(direction == RX)
     {
-        _rx_bb_lp_bw = _calibrate_baseband_rx_analog_filter(rf_bw); //returns bb bw
-        _rx_tia_lp_bw = _calibrate_rx_TIAs(rf_bw);
+        if (not _restore_bw_filter_cal(RX, rf_bw)) {
+            _rx_bb_lp_bw = _calibrate_baseband_rx_analog_filter(rf_bw); //returns bb bw
+            _rx_tia_lp_bw = _calibrate_rx_TIAs(rf_bw);
+            _store_bw_filter_cal(RX, rf_bw);
+        }
         _rx_analog_bw = _rx_bb_lp_bw;
         set_analog_bb_bw = _rx_analog_bw;
     } else {
-        _tx_bb_lp_bw = _calibrate_baseband_tx_analog_filter(rf_bw); //returns bb bw
-        _tx_sec_lp_bw = _calibrate_secondary_tx_filter(rf_bw);
+        if (not _restore_bw_filter_cal(TX, rf_bw)) {
+            _tx_bb_lp_bw = _calibrate_baseband_tx_analog_filter(rf_bw); //returns bb bw
+            _tx_sec_lp_bw = _calibrate_secondary_tx_filter(rf_bw);
+            _store_bw_filter_cal(TX, rf_bw);
+        }
         _tx_analog_bw = _tx_bb_lp_bw;
         set_analog_bb_bw = _tx_analog_bw;
     }
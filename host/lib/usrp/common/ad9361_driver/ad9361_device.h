@@ -47,6 +47,7 @@ public:
         _tfir_factor(0), _rfir_factor(0),
         _rx1_agc_mode(GAIN_MODE_MANUAL), _rx2_agc_mode(GAIN_MODE_MANUAL),
         _rx1_agc_enable(false), _rx2_agc_enable(false),
+        _rx_fast_lock_active(-1), _tx_fast_lock_active(-1),
         _use_dc_offset_tracking(false), _use_iq_balance_tracking(false)
     {
 
@@ -115,6 +116,22 @@ public:
     /* Get the current RX or TX frequency. */
     double get_freq(direction_t direction);
 
+    /* Store an RX or TX frequency in one of AD9361's fast lock profiles.
+     *
+     * The synthesizer is fully tuned (and calibrated, if required) to the
+     * requested frequency, and the resulting synthesizer words and VCO
+     * calibration results are written into the profile. Afterwards, the
+     * synthesizer is returned to its previous frequency. Returns the actual
+     * frequency stored in the profile. */
+    double store_fast_lock_profile(direction_t direction, const size_t profile, const double value);
+
+    /* Switch the RX or TX synthesizer to a stored fast lock profile.
+     *
+     * This skips VCO calibration and synthesizer programming; in the common
+     * case it is a single register write. No RF calibrations are run.
+     * Returns the frequency stored in the profile. */
+    double recall_fast_lock_profile(direction_t direction, const size_t profile);
+
     /* Set the gain of RX1, RX2, TX1, or TX2.
      *
      * Note that the 'value' passed to this function is the actual gain value,
@@ -173,6 +190,64 @@ public:
     static const double AD9361_RECOMMENDED_MAX_BANDWIDTH;
     static const double DEFAULT_RX_FREQ;
     static const double DEFAULT_TX_FREQ;
+    static const size_t AD9361_NUM_FAST_LOCK_PROFILES;
+
+private:    //Types
+    //! Clock configuration for one master clock rate, see _compute_rate_plan()
+    struct rate_plan_t
+    {
+        rate_plan_t():
+            rxfilt(0), txfilt(0), tfir_factor(0), rfir_factor(0),
+            coreclk(0.0), bbpll_vcodiv(0), bbpll_nint(0), bbpll_nfrac(0),
+            bbpll_icp(0), bbpll_freq(0.0), adcclk(0.0), dac_half_rate(false),
+            baseband_bw(0.0), num_tx_taps(0), num_rx_taps(0) {}
+        uint8_t rxfilt;
+        uint8_t txfilt;
+        int32_t tfir_factor;
+        int32_t rfir_factor;
+        double coreclk;
+        //! BBPLL divider selection, bits [2:0] of register 0x00A
+        int bbpll_vcodiv;
+        int bbpll_nint;
+        int bbpll_nfrac;
+        int bbpll_icp;
+        double bbpll_freq;
+        double adcclk;
+        bool dac_half_rate;
+        double baseband_bw;
+        size_t num_tx_taps;
+        size_t num_rx_taps;
+    };
+
+    //! Results of a set_bw_filter() calibration for one rate plan and bandwidth
+    struct bw_filter_cal_t
+    {
+        bw_filter_cal_t():
+            bb_lp_bw(0.0), sec_lp_bw(0.0), rx_bbf_tunediv(0), bbftune(0) {}
+        double bb_lp_bw;
+        //! RX TIA or TX secondary filter bandwidth
+        double sec_lp_bw;
+        uint16_t rx_bbf_tunediv;
+        //! Soft copy of bbftune_config (RX) or bbftune_mode (TX)
+        uint8_t bbftune;
+        //! Tuner results and derived settings, in programming order
+        ad9361_io::reg_writes_t regs;
+    };
+    //! Settings a set_bw_filter() calibration depends on
+    struct bw_filter_cal_key_t
+    {
+        int64_t bbpll_freq;
+        //! The calibrations clip the requested bandwidth to half of this
+        int64_t baseband_bw;
+        int64_t rf_bw;
+        bool operator<(const bw_filter_cal_key_t &rhs) const
+        {
+            if (bbpll_freq != rhs.bbpll_freq) return bbpll_freq < rhs.bbpll_freq;
+            if (baseband_bw != rhs.baseband_bw) return baseband_bw < rhs.baseband_bw;
+            return rf_bw < rhs.rf_bw;
+        }
+    };
+    typedef std::map<bw_filter_cal_key_t, bw_filter_cal_t> bw_filter_cal_cache_t;
 
 private:    //Methods
     void _program_fir_filter(direction_t direction, int num_taps, uint16_t *coeffs);
@@ -187,6 +262,9 @@ private:    //Methods
     double _calibrate_baseband_tx_analog_filter(double rfbw);
     double _calibrate_secondary_tx_filter(double rfbw);
     double _calibrate_rx_TIAs(double rfbw);
+    bw_filter_cal_key_t _get_bw_filter_cal_key(const double rf_bw);
+    void _store_bw_filter_cal(direction_t direction, const double rf_bw);
+    bool _restore_bw_filter_cal(direction_t direction, const double rf_bw);
     void _setup_adc();
     void _calibrate_baseband_dc_offset();
     void _calibrate_rf_dc_offset();
@@ -197,9 +275,12 @@ private:    //Methods
     void _program_gain_table();
     void _setup_gain_control(bool use_agc);
     void _setup_synth(direction_t direction, double vcorate);
-    double _tune_bbvco(const double rate);
+    double _tune_bbvco(const rate_plan_t &plan);
     void _reprogram_gains();
     double _tune_helper(direction_t direction, const double value);
+    double _tune_and_calibrate(direction_t direction, const double value);
+    void _disable_fast_lock(direction_t direction);
+    rate_plan_t _compute_rate_plan(const double rate);
     double _setup_rates(const double rate);
     double _get_temperature(const double cal_offset, const double timeout = 0.1);
     void _configure_bb_dc_tracking();
@@ -235,6 +316,20 @@ private:    //Members
         uint8_t bbftune_mode;
     };
 
+    struct fast_lock_profile_t
+    {
+        fast_lock_profile_t():
+            valid(false), freq(0.0), req_freq(0.0),
+            inputsel(0), vcodiv(0) {}
+        bool valid;
+        double freq;
+        double req_freq;
+        //! Band select bits of register 0x004 belonging to this direction
+        uint8_t inputsel;
+        //! VCO divider nibble of register 0x005 belonging to this direction
+        uint8_t vcodiv;
+    };
+
     struct filter_query_helper
     {
         filter_query_helper(
@@ -277,6 +372,15 @@ private:    //Members
     bool                _rx1_agc_enable, _rx2_agc_enable;
     //Register soft-copies
     chip_regs_t         _regs;
+    //Fast lock profiles
+    std::vector<fast_lock_profile_t> _rx_fast_lock_profiles, _tx_fast_lock_profiles;
+    //! Currently active fast lock profile, or -1 if the synthesizer was tuned normally
+    int                 _rx_fast_lock_active, _tx_fast_lock_active;
+    //Cached rate plans (keyed by requested clock rate) and filter
+    //calibrations (keyed by BBPLL rate, baseband bandwidth and requested
+    //bandwidth)
+    std::map<int64_t, rate_plan_t> _rate_plans;
+    bw_filter_cal_cache_t _rx_bw_filter_cals, _tx_bw_filter_cals;
     //Synchronization
     boost::recursive_mutex  _mutex;
     bool _use_dc_offset_tracking;
@@ -18,6 +18,7 @@
 #include "ad936x_manager.hpp"
 #include <uhd/utils/log.hpp>
 #include <boost/functional/hash.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/thread/thread.hpp>
 
 using namespace uhd;
@@ -250,6 +251,17 @@ class ad936x_manager_impl : public ad936x_manager
             .set_coercer(boost::bind(&ad9361_ctrl::tune, _codec_ctrl, key, _1))
         ;
 
+        // Fast lock profiles: Writing a frequency to a profile stores it,
+        // writing a profile index to recall switches the LO to it.
+        for (size_t i = 0; i < ad9361_ctrl::get_num_fast_lock_profiles(); i++) {
+            subtree->create<double>(uhd::fs_path("freq/fast_lock/profiles") / boost::lexical_cast<std::string>(i))
+                .set_coercer(boost::bind(&ad9361_ctrl::store_fast_lock_profile, _codec_ctrl, key, i, _1))
+            ;
+        }
+        subtree->create<size_t>("freq/fast_lock/recall")
+            .add_coerced_subscriber(boost::bind(&ad9361_ctrl::recall_fast_lock_profile, _codec_ctrl, key, _1))
+        ;
+
         // Frontend corrections
         if(dir == RX_DIRECTION)
         {
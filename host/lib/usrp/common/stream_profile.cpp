@@ -0,0 +1,60 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "stream_profile.hpp"
+#include <uhd/exception.hpp>
+#include <boost/format.hpp>
+
+using namespace uhd;
+using namespace uhd::usrp;
+
+//! Samples per packet of the low latency profile, devices cap it to the frame size
+static const char *LOW_LATENCY_SPP = "128";
+//! Time in us that the kernel busy polls the NIC for a socket read
+static const char *LOW_LATENCY_BUSY_POLL_US = "50";
+
+static const char *STREAM_XPORT_KEYS[] = {"busy_poll", "recv_offload"};
+
+static void set_default(device_addr_t &args, const std::string &key, const std::string &value){
+    if (not args.has_key(key)) args[key] = value;
+}
+
+void uhd::usrp::apply_stream_profile(stream_args_t &args){
+    const std::string profile = args.args.get("profile", "default");
+    if (profile == "default") return;
+    if (profile == "low_latency"){
+        //small packets: a sample does not wait for a large packet to fill up
+        set_default(args.args, "spp", LOW_LATENCY_SPP);
+        //convert in the calling thread instead of handing off to send workers
+        set_default(args.args, "send_wait", "inline");
+        //receive in the calling thread instead of queueing behind an offload thread
+        set_default(args.args, "recv_offload", "0");
+        //poll the NIC from the socket reads instead of waiting for an interrupt
+        set_default(args.args, "busy_poll", LOW_LATENCY_BUSY_POLL_US);
+        return;
+    }
+    throw uhd::value_error(str(
+        boost::format("Unknown stream profile \"%s\", expected default or low_latency") % profile
+    ));
+}
+
+void uhd::usrp::apply_stream_xport_hints(const device_addr_t &stream_args, device_addr_t &hints){
+    for (size_t i = 0; i < sizeof(STREAM_XPORT_KEYS)/sizeof(*STREAM_XPORT_KEYS); i++){
+        const std::string key = STREAM_XPORT_KEYS[i];
+        if (stream_args.has_key(key)) hints[key] = stream_args.get(key);
+    }
+}
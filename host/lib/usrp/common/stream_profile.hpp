@@ -0,0 +1,46 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_USRP_COMMON_STREAM_PROFILE_HPP
+#define INCLUDED_LIBUHD_USRP_COMMON_STREAM_PROFILE_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/device_addr.hpp>
+
+namespace uhd{ namespace usrp{
+
+    /*!
+     * Expand the "profile" key of the stream args into the streaming
+     * options it stands for. Options the user set are kept.
+     * Known profiles are "default" and "low_latency".
+     * \param args the stream args to update
+     * \throws uhd::value_error for an unknown profile
+     */
+    void apply_stream_profile(stream_args_t &args);
+
+    /*!
+     * Copy the transport options of the stream args (busy_poll and
+     * recv_offload) into the hints used to make a data transport.
+     * \param stream_args the stream args of one channel (args.args)
+     * \param hints the transport hints to update
+     */
+    void apply_stream_xport_hints(const device_addr_t &stream_args, device_addr_t &hints);
+
+}} //namespace uhd::usrp
+
+#endif /* INCLUDED_LIBUHD_USRP_COMMON_STREAM_PROFILE_HPP */
@@ -49,33 +49,7 @@ public:
     ){
         boost::lock_guard<boost::mutex> lock(_mutex);
 
-        //load SPI divider
-        size_t spi_divider = _div;
-        if (config.use_custom_divider) {
-            //The resulting SPI frequency will be f_system/(2*(divider+1))
-            //This math ensures the frequency will be equal to or less than the target
-            spi_divider = (config.divider-1)/2;
-        }
-
-        //conditionally send SPI divider
-        if (spi_divider != _divider_cache) {
-            _iface->poke32(SPI_DIV, spi_divider);
-            _divider_cache = spi_divider;
-        }
-
-        //load control word
-        uint32_t ctrl_word = 0;
-        ctrl_word |= ((which_slave & 0xffffff) << 0);
-        ctrl_word |= ((num_bits & 0x3f) << 24);
-        if (config.mosi_edge == spi_config_t::EDGE_FALL) ctrl_word |= (1 << 31);
-        if (config.miso_edge == spi_config_t::EDGE_RISE) ctrl_word |= (1 << 30);
-
-        //conditionally send control word
-        if (_ctrl_word_cache != ctrl_word)
-        {
-            _iface->poke32(SPI_CTRL, ctrl_word);
-            _ctrl_word_cache = ctrl_word;
-        }
+        this->load_config(which_slave, config, num_bits);
 
         //load data word (must be in upper bits)
         const uint32_t data_out = data << (32 - num_bits);
@@ -92,6 +66,24 @@ public:
         return 0;
     }
 
+    void write_spi_batch(
+        int which_slave,
+        const spi_config_t &config,
+        const std::vector<uint32_t> &data,
+        size_t num_bits
+    ){
+        boost::lock_guard<boost::mutex> lock(_mutex);
+
+        //the configuration is shared by all words,
+        //so only the data words go out back-to-back
+        this->load_config(which_slave, config, num_bits);
+
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            _iface->poke32(SPI_DATA, data[i] << (32 - num_bits));
+        }
+    }
+
     void set_shutdown(const bool shutdown)
     {
         _shutdown_cache = shutdown;
@@ -109,6 +101,40 @@ public:
     }
 
 private:
+    //! Send divider and control word, unless the core already has them
+    void load_config(
+        int which_slave,
+        const spi_config_t &config,
+        size_t num_bits
+    ){
+        //load SPI divider
+        size_t spi_divider = _div;
+        if (config.use_custom_divider) {
+            //The resulting SPI frequency will be f_system/(2*(divider+1))
+            //This math ensures the frequency will be equal to or less than the target
+            spi_divider = (config.divider-1)/2;
+        }
+
+        //conditionally send SPI divider
+        if (spi_divider != _divider_cache) {
+            _iface->poke32(SPI_DIV, spi_divider);
+            _divider_cache = spi_divider;
+        }
+
+        //load control word
+        uint32_t ctrl_word = 0;
+        ctrl_word |= ((which_slave & 0xffffff) << 0);
+        ctrl_word |= ((num_bits & 0x3f) << 24);
+        if (config.mosi_edge == spi_config_t::EDGE_FALL) ctrl_word |= (1 << 31);
+        if (config.miso_edge == spi_config_t::EDGE_RISE) ctrl_word |= (1 << 30);
+
+        //conditionally send control word
+        if (_ctrl_word_cache != ctrl_word)
+        {
+            _iface->poke32(SPI_CTRL, ctrl_word);
+            _ctrl_word_cache = ctrl_word;
+        }
+    }
 
     wb_iface::sptr _iface;
     const size_t _base;
@@ -23,8 +23,10 @@
 #include <uhd/rfnoc/sink_block_ctrl_base.hpp>
 #include <uhd/utils/byteswap.hpp>
 #include <uhd/utils/log.hpp>
+#include <uhd/utils/trace.hpp>
 
 #include "../common/async_packet_handler.hpp"
+#include "../common/stream_profile.hpp"
 #include "../../transport/super_recv_packet_handler.hpp"
 #include "../../transport/super_send_packet_handler.hpp"
 #include "../../rfnoc/rx_stream_terminator.hpp"
@@ -32,6 +34,7 @@
 #include <uhd/rfnoc/rate_node_ctrl.hpp>
 #include <uhd/rfnoc/radio_ctrl.hpp>
 #include <uhd/transport/zero_copy_flow_ctrl.hpp>
+#include <uhd/types/time_spec.hpp>
 #include <boost/atomic.hpp>
 
 #define UHD_TX_STREAMER_LOG() UHD_LOGGER_TRACE("STREAMER")
@@ -44,6 +47,12 @@ using namespace uhd::transport;
 //! CHDR uses 12-Bit sequence numbers
 static const uint32_t HW_SEQ_NUM_MASK = 0xfff;
 
+//! Number of times to poll for TX flow control credit before sleeping
+static const size_t TX_FC_MAX_SPINS = 100000;
+
+//! Maximum time to sleep before polling for TX flow control credit again
+static const long TX_FC_MAX_WAIT_MS = 100;
+
 
 /***********************************************************************
  * Helper functions for get_?x_stream()
@@ -307,15 +316,35 @@ struct tx_fc_cache_t
         device_channel(0),
         last_seq_out(0),
         last_seq_ack(0),
-        last_seq_ack_cache(0) {}
+        last_seq_ack_cache(0),
+        waiting_for_credit(false),
+        credit_event(event_fd::make()),
+        credit_event_requested(false),
+        credit_event_armed(false),
+        num_stalls(0),
+        stall_time_ns(0) {}
 
     size_t stream_channel;
     size_t device_channel;
-    size_t last_seq_out;
+    boost::atomic_size_t last_seq_out;
     boost::atomic_size_t last_seq_ack;
     size_t last_seq_ack_cache;
-    boost::shared_ptr<device3_impl::async_md_type> async_queue;
+    async_event_channel::sptr async_queue;
     boost::shared_ptr<device3_impl::async_md_type> old_async_queue;
+
+    //! Signalled by the async message handler when credit comes back
+    boost::mutex fc_update_lock;
+    boost::condition_variable fc_update;
+    boost::atomic_bool waiting_for_credit;
+
+    //! Readable while there is credit, once tx_streamer::get_send_fd() was called
+    event_fd::sptr credit_event;
+    boost::atomic_bool credit_event_requested;
+    boost::atomic_bool credit_event_armed;
+
+    //! Stall counters, read by tx_streamer::get_flow_ctrl_stats()
+    boost::atomic<uint64_t> num_stalls;
+    boost::atomic<uint64_t> stall_time_ns;
 };
 
 /*! Return the size of the flow control window in packets.
@@ -357,29 +386,92 @@ static bool tx_flow_ctrl(
     size_t fc_window,
     managed_buffer::sptr
 ) {
-    // Busy loop waiting for flow control update.  This is necessary because
-    // at this point there is data trying to be sent and it must be sent as
-    // quickly as possible when the flow control update arrives to avoid
-    // underruns at high rates.  This is also OK because it only occurs when
-    // data needs to be sent and flow control is holding it back.
+    // Poll for a while before sleeping. At this point there is data trying
+    // to be sent and it must be sent as quickly as possible when the flow
+    // control update arrives to avoid underruns at high rates. When the
+    // device stays back-pressured, sleep until handle_tx_async_msgs()
+    // reports new credit rather than pinning a core.
+    const size_t last_seq_out = fc_cache->last_seq_out.load(boost::memory_order_relaxed);
+    size_t spins = 0;
+    time_spec_t stall_start;
     while (true)
     {
         // delta is the amount of FC credit we've used up
-        const size_t delta = (fc_cache->last_seq_out & HW_SEQ_NUM_MASK) -
+        const size_t delta = (last_seq_out & HW_SEQ_NUM_MASK) -
             (fc_cache->last_seq_ack_cache & HW_SEQ_NUM_MASK);
         // If we want to send another packet, we must have FC credit left
         if ((delta & HW_SEQ_NUM_MASK) < fc_window)
         {
             // Packet will be sent
-            fc_cache->last_seq_out++; //update seq
+            fc_cache->last_seq_out.store(last_seq_out + 1, boost::memory_order_relaxed); //update seq
+            if (spins != 0)
+            {
+                const time_spec_t stall_time = time_spec_t::get_system_time() - stall_start;
+                fc_cache->stall_time_ns += uint64_t(stall_time.get_real_secs()*1e9);
+                // The credit may have come back before the async handler saw the event armed
+                if (fc_cache->credit_event_armed.exchange(false)) fc_cache->credit_event->signal();
+            }
             return true;
         }
         // update the cached value from the atomic
-        fc_cache->last_seq_ack_cache = fc_cache->last_seq_ack;
+        const size_t last_seq_ack = fc_cache->last_seq_ack;
+        if (last_seq_ack != fc_cache->last_seq_ack_cache)
+        {
+            fc_cache->last_seq_ack_cache = last_seq_ack;
+            continue;
+        }
+        // out of credit
+        if (spins++ == 0)
+        {
+            fc_cache->num_stalls++;
+            stall_start = time_spec_t::get_system_time();
+            // Not ready until the next flow control update
+            if (fc_cache->credit_event_requested)
+            {
+                fc_cache->credit_event->clear();
+                fc_cache->credit_event_armed = true;
+            }
+        }
+        if (spins > TX_FC_MAX_SPINS)
+        {
+            boost::unique_lock<boost::mutex> lock(fc_cache->fc_update_lock);
+            fc_cache->waiting_for_credit = true;
+            if (fc_cache->last_seq_ack == fc_cache->last_seq_ack_cache)
+            {
+                fc_cache->fc_update.timed_wait(lock, boost::posix_time::milliseconds(TX_FC_MAX_WAIT_MS));
+            }
+            fc_cache->waiting_for_credit = false;
+        }
     }
     return false;
 }
 
+static int get_tx_credit_fd(
+    boost::shared_ptr<tx_fc_cache_t> fc_cache
+) {
+    if (fc_cache->credit_event->get_fd() < 0) return -1;
+    if (not fc_cache->credit_event_requested.exchange(true))
+    {
+        // Start out readable, nothing was sent yet or the sender will
+        // clear it the next time it runs out of credit
+        fc_cache->credit_event->signal();
+    }
+    return fc_cache->credit_event->get_fd();
+}
+
+static tx_flow_ctrl_stats_t get_tx_fc_stats(
+    boost::shared_ptr<tx_fc_cache_t> fc_cache,
+    size_t fc_window
+) {
+    tx_flow_ctrl_stats_t stats;
+    const size_t delta = (fc_cache->last_seq_out & HW_SEQ_NUM_MASK) -
+        (fc_cache->last_seq_ack & HW_SEQ_NUM_MASK);
+    stats.credit_occupancy = std::min(1.0, double(delta & HW_SEQ_NUM_MASK) / fc_window);
+    stats.num_stalls = fc_cache->num_stalls;
+    stats.stall_time = fc_cache->stall_time_ns / 1e9;
+    return stats;
+}
+
 #define DEVICE3_ASYNC_EVENT_CODE_FLOW_CTRL 0
 /*! Handle incoming messages. If they're flow control, update the TX FC cache.
  * Otherwise, send them to the async message queue for the user to poll.
@@ -446,11 +538,21 @@ static void handle_tx_async_msgs(
     //consumed packets. Use them to update the FC metadata
     if (metadata.event_code == DEVICE3_ASYNC_EVENT_CODE_FLOW_CTRL) {
         fc_cache->last_seq_ack = metadata.user_payload[0];
+        UHD_TRACE_POINT(SEND_FC_RECV, metadata.user_payload[0]);
+        //wake up the sender if it went to sleep waiting for credit
+        if (fc_cache->waiting_for_credit) {
+            boost::lock_guard<boost::mutex> lock(fc_cache->fc_update_lock);
+            fc_cache->fc_update.notify_one();
+        }
+        //and tell an event loop polling tx_streamer::get_send_fd()
+        if (fc_cache->credit_event_armed and fc_cache->credit_event_armed.exchange(false)) {
+            fc_cache->credit_event->signal();
+        }
     }
 
     //FC responses don't propagate up to the user so filter them here
     if (metadata.event_code != DEVICE3_ASYNC_EVENT_CODE_FLOW_CTRL) {
-        fc_cache->async_queue->push_with_pop_on_full(metadata);
+        fc_cache->async_queue->push(metadata);
         metadata.channel = fc_cache->device_channel;
         fc_cache->old_async_queue->push_with_pop_on_full(metadata);
         standard_async_msg_prints(metadata);
@@ -469,6 +571,34 @@ bool device3_impl::recv_async_msg(
     return _async_md->pop_with_timed_wait(async_metadata, timeout);
 }
 
+/***********************************************************************
+ * Streamer stats:
+ * Published in the property tree under /streamers/<terminator>/stats.
+ * The tree only holds a weak pointer, so a streamer that is being
+ * destroyed reads zeros. The deleter of the streamer removes its node.
+ **********************************************************************/
+template <typename streamer_type>
+static stream_stats_t get_streamer_stats(boost::weak_ptr<streamer_type> weak_streamer)
+{
+    boost::shared_ptr<streamer_type> streamer = weak_streamer.lock();
+    if (not streamer) return stream_stats_t();
+    return streamer->get_stats();
+}
+
+template <typename streamer_type>
+static void delete_streamer(
+        streamer_type *streamer,
+        boost::weak_ptr<property_tree> weak_tree,
+        const fs_path &streamer_path
+) {
+    delete streamer;
+    // The device may be gone already, and its tree with it
+    property_tree::sptr tree = weak_tree.lock();
+    if (tree and tree->exists(streamer_path)) {
+        tree->remove(streamer_path);
+    }
+}
+
 /***********************************************************************
  * Receive streamer
  **********************************************************************/
@@ -551,6 +681,7 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
 
         // Setup the DSP transport hints
         device_addr_t rx_hints = get_rx_hints(mb_index);
+        apply_stream_xport_hints(args.args, rx_hints);
 
         //allocate sid and create transport
         uhd::sid_t stream_address = blk_ctrl->get_address(block_port);
@@ -580,10 +711,16 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
 
         //make the new streamer given the samples per packet
         if (not my_streamer)
-            my_streamer = boost::make_shared<sph::recv_packet_streamer>(spp);
+            my_streamer.reset(
+                new sph::recv_packet_streamer(spp),
+                boost::bind(&delete_streamer<sph::recv_packet_streamer>, _1,
+                    boost::weak_ptr<property_tree>(_tree),
+                    fs_path("/streamers") / recv_terminator->unique_id())
+            );
         my_streamer->resize(chan_list.size());
 
         //init some streamer stuff
+        my_streamer->set_recv_args(args.args);
         std::string conv_endianness;
         if (xport.endianness == ENDIANNESS_BIG) {
             my_streamer->set_vrt_unpacker(&vrt::chdr::if_hdr_unpack_be);
@@ -618,6 +755,10 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
             boost::bind(&zero_copy_if::get_recv_buff, xport.recv, _1),
             true /*flush*/
         );
+        my_streamer->set_xport_chan_ready_fd(
+            stream_i,
+            boost::bind(&zero_copy_if::get_recv_fd, xport.recv)
+        );
 
         //Give the streamer a functor to handle overruns
         //bind requires a weak_ptr to break the a streamer->streamer circular dependency
@@ -667,6 +808,8 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
     // Note that we store the streamer only once, and use its terminator's
     // ID to do so.
     _rx_streamers[recv_terminator->unique_id()] = boost::weak_ptr<sph::recv_packet_streamer>(my_streamer);
+    _tree->create<stream_stats_t>(fs_path("/streamers") / recv_terminator->unique_id() / "stats")
+        .set_publisher(boost::bind(&get_streamer_stats<rx_streamer>, boost::weak_ptr<rx_streamer>(my_streamer)));
 
     // Sets tick rate, samp rate and scaling on this streamer.
     // A registered terminator is required to do this.
@@ -718,7 +861,7 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
     // Note: All 'args.args' are merged into chan_args now.
 
     //shared async queue for all channels in streamer
-    boost::shared_ptr<async_md_type> async_md(new async_md_type(1000/*messages deep*/));
+    async_event_channel::sptr async_md = async_event_channel::make(1024/*messages deep*/);
 
     // II. Iterate over all channels
     boost::shared_ptr<sph::send_packet_streamer> my_streamer;
@@ -754,6 +897,7 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
 
         // Setup the dsp transport hints
         device_addr_t tx_hints = get_tx_hints(mb_index);
+        apply_stream_xport_hints(args.args, tx_hints);
 
         //allocate sid and create transport
         uhd::sid_t stream_address = blk_ctrl->get_address(block_port);
@@ -770,7 +914,12 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
 
         //make the new streamer given the samples per packet
         if (not my_streamer)
-            my_streamer = boost::make_shared<sph::send_packet_streamer>(spp);
+            my_streamer.reset(
+                new sph::send_packet_streamer(spp),
+                boost::bind(&delete_streamer<sph::send_packet_streamer>, _1,
+                    boost::weak_ptr<property_tree>(_tree),
+                    fs_path("/streamers") / send_terminator->unique_id())
+            );
         my_streamer->resize(chan_list.size());
 
         //init some streamer stuff
@@ -872,13 +1021,20 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
         //get_tx_buff is static so bind has no lifetime issues
         //xport.send (sptr) is required to add streamer->data-transport lifetime dependency
         //task (sptr) is required to add  a streamer->async-handler lifetime dependency
+        my_streamer->set_send_args(args.args);
         my_streamer->set_xport_chan_get_buff(
             stream_i,
             boost::bind(&get_tx_buff, xport.send, _1)
         );
-        //Give the streamer a functor handled received async messages
-        my_streamer->set_async_receiver(
-            boost::bind(&async_md_type::pop_with_timed_wait, async_md, _1, _2)
+        //Give the streamer the channel the async messages are pushed into
+        my_streamer->set_async_channel(async_md);
+        my_streamer->set_xport_chan_fc_stats(
+            stream_i,
+            boost::bind(&get_tx_fc_stats, fc_cache, fc_window)
+        );
+        my_streamer->set_xport_chan_ready_fd(
+            stream_i,
+            boost::bind(&get_tx_credit_fd, fc_cache)
         );
         my_streamer->set_xport_chan_sid(stream_i, true, xport.send_sid);
         // CHDR does not support trailers
@@ -895,6 +1051,8 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
     // Note that we store the streamer only once, and use its terminator's
     // ID to do so.
     _tx_streamers[send_terminator->unique_id()] = boost::weak_ptr<sph::send_packet_streamer>(my_streamer);
+    _tree->create<stream_stats_t>(fs_path("/streamers") / send_terminator->unique_id() / "stats")
+        .set_publisher(boost::bind(&get_streamer_stats<tx_streamer>, boost::weak_ptr<tx_streamer>(my_streamer)));
 
     // Sets tick rate, samp rate and scaling on this streamer
     // A registered terminator is required to do this.
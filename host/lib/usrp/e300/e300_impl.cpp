@@ -1053,6 +1053,10 @@ void e300_impl::_setup_radio(const size_t dspno)
         _tree->access<double>(rf_fe_path / "freq" / "value")
             .add_coerced_subscriber(boost::bind(&e300_impl::_update_fe_lo_freq, this, key, _1))
         ;
+        _tree->access<size_t>(rf_fe_path / "freq" / "fast_lock" / "recall")
+            .add_coerced_subscriber(boost::bind(&e300_impl::_update_fe_lo_freq, this, key,
+                boost::bind(&ad9361_ctrl::get_freq, _codec_ctrl, key)))
+        ;
 
         // Antenna Setup
         if (dir == RX_DIRECTION) {
@@ -458,6 +458,7 @@ rx_streamer::sptr e300_impl::get_rx_stream(const uhd::stream_args_t &args_)
         my_streamer->resize(args.channels.size());
 
         //init some streamer stuff
+        my_streamer->set_recv_args(args.args);
         my_streamer->set_vrt_unpacker(&e300_if_hdr_unpack_le);
 
         //set the converter
@@ -607,6 +608,7 @@ tx_streamer::sptr e300_impl::get_tx_stream(const uhd::stream_args_t &args_)
                                                  fc_cache, data_xports.recv,
                                                  get_tick_rate_fn));
 
+        my_streamer->set_send_args(args.args);
         my_streamer->set_xport_chan_get_buff(
             stream_i,
             boost::bind(&get_tx_buff_with_flowctrl, task, fc_cache, data_xports.send, fc_window, _1)
@@ -30,7 +30,9 @@
 #include "e300_defaults.hpp"
 #include "e300_common.hpp"
 #include "e300_remote_codec_ctrl.hpp"
+#include "e300_network_batch.hpp"
 
+#include <uhd/exception.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/byteswap.hpp>
 #include <uhd/utils/paths.hpp>
@@ -41,6 +43,7 @@
 #include <boost/make_shared.hpp>
 
 #include <fstream>
+#include <vector>
 
 using namespace uhd;
 using namespace uhd::transport;
@@ -51,22 +54,6 @@ namespace uhd { namespace usrp { namespace e300 {
 
 static const size_t E300_NETWORK_DEBUG = false;
 
-static inline bool wait_for_recv_ready(int sock_fd, const size_t timeout_ms)
-{
-    //setup timeval for timeout
-    timeval tv;
-    tv.tv_sec = 0;
-    tv.tv_usec = timeout_ms*1000;
-
-    //setup rset for timeout
-    fd_set rset;
-    FD_ZERO(&rset);
-    FD_SET(sock_fd, &rset);
-
-    //call select with timeout on receive socket
-    return ::select(sock_fd+1, &rset, NULL, NULL, &tv) > 0;
-}
-
 static boost::mutex endpoint_mutex;
 
 /***********************************************************************
@@ -81,14 +68,19 @@ static void e300_recv_tunnel(
 )
 {
     asio::ip::udp::endpoint _tx_endpoint;
+    std::vector<managed_recv_buffer::sptr> buffs;
+    std::vector<iovec> iovs(E300_NETWORK_BATCH_SIZE);
+    std::vector<tunnel_msg_t> msgs(E300_NETWORK_BATCH_SIZE);
     try
     {
         while (*running)
         {
-            //step 1 - get the buffer
+            //step 1 - get the buffers, wait for the first and take the others already there
             managed_recv_buffer::sptr buff = recver->get_recv_buff();
             if (not buff) continue;
-            if (E300_NETWORK_DEBUG) UHD_LOGGER_INFO("E300") << name << " got " << buff->size();
+            do buffs.push_back(buff);
+            while (buffs.size() < E300_NETWORK_BATCH_SIZE and (buff = recver->get_recv_buff(0.0)));
+            if (E300_NETWORK_DEBUG) UHD_LOGGER_INFO("E300") << name << " got " << buffs.size() << " buffers";
 
             //step 1.5 -- update endpoint
             {
@@ -96,8 +88,14 @@ static void e300_recv_tunnel(
                 _tx_endpoint = *endpoint;
             }
 
-            //step 2 - send to the socket
-            sender->send_to(asio::buffer(buff->cast<const void *>(), buff->size()), _tx_endpoint);
+            //step 2 - send to the socket, straight from the FIFO memory
+            for (size_t i = 0; i < buffs.size(); i++)
+            {
+                init_tunnel_msg(msgs[i], iovs[i], buffs[i]->cast<void *>(), buffs[i]->size(),
+                    _tx_endpoint, _tx_endpoint.size());
+            }
+            send_batch(sender->native_handle(), &msgs.front(), buffs.size());
+            buffs.clear();
         }
     }
     catch(const std::exception &ex)
@@ -123,29 +121,58 @@ static void e300_send_tunnel(
     bool *running
 )
 {
-    asio::ip::udp::endpoint _rx_endpoint;
+    std::vector<asio::ip::udp::endpoint> _rx_endpoints(E300_NETWORK_BATCH_SIZE);
+    std::vector<managed_send_buffer::sptr> buffs;
+    std::vector<iovec> iovs(E300_NETWORK_BATCH_SIZE);
+    std::vector<tunnel_msg_t> msgs(E300_NETWORK_BATCH_SIZE);
     try
     {
         while (*running)
         {
-            //step 1 - get the buffer
-            managed_send_buffer::sptr buff = sender->get_send_buff();
-            if (not buff) continue;
+            //step 1 - get the buffers, wait for one and take the others already free
+            if (buffs.empty())
+            {
+                managed_send_buffer::sptr buff = sender->get_send_buff();
+                if (not buff) continue;
+                buffs.push_back(buff);
+            }
+            while (buffs.size() < E300_NETWORK_BATCH_SIZE)
+            {
+                managed_send_buffer::sptr buff = sender->get_send_buff(0.0);
+                if (not buff) break;
+                buffs.push_back(buff);
+            }
 
-            //step 2 - recv from socket
-            while (not wait_for_recv_ready(recver->native(), 100) and *running){}
+            //step 2 - recv from socket, straight into the FIFO memory,
+            //only wait in select() when nothing is queued on the socket
+            for (size_t i = 0; i < buffs.size(); i++)
+            {
+                init_tunnel_msg(msgs[i], iovs[i], buffs[i]->cast<void *>(), buffs[i]->size(),
+                    _rx_endpoints[i], _rx_endpoints[i].capacity());
+            }
+            size_t num_msgs = 0;
+            while (*running and (num_msgs = recv_batch(recver->native_handle(), &msgs.front(), buffs.size())) == 0)
+            {
+                wait_for_recv_ready(recver->native_handle(), 100);
+            }
             if (not *running) break;
-            const size_t num_bytes = recver->receive_from(asio::buffer(buff->cast<void *>(), buff->size()), _rx_endpoint);
-            if (E300_NETWORK_DEBUG) UHD_LOGGER_INFO("E300") << name << " got " << num_bytes;
+            if (E300_NETWORK_DEBUG) UHD_LOGGER_INFO("E300") << name << " got " << num_msgs << " datagrams";
 
             //step 2.5 -- update endpoint
             {
+                asio::ip::udp::endpoint &last = _rx_endpoints[num_msgs-1];
+                last.resize(msgs[num_msgs-1].msg_hdr.msg_namelen);
                 boost::mutex::scoped_lock l(endpoint_mutex);
-                *endpoint = _rx_endpoint;
+                *endpoint = last;
             }
 
-            //step 3 - commit the buffer
-            buff->commit(num_bytes);
+            //step 3 - commit the filled buffers in order, keep the others for the next batch
+            for (size_t i = 0; i < num_msgs; i++)
+            {
+                buffs[i]->commit(msgs[i].msg_len);
+                buffs[i].reset();
+            }
+            buffs.erase(buffs.begin(), buffs.begin() + num_msgs);
         }
     }
     catch(const std::exception &ex)
@@ -190,7 +217,9 @@ static void e300_codec_ctrl_tunnel(
             std::memcpy(out, in, sizeof(codec_xact_t));
 
             std::string which_str;
-            switch (uhd::ntohx<uint32_t>(in->which)) {
+            const uint32_t which = uhd::ntohx<uint32_t>(in->which);
+            const uint32_t profile = which >> codec_xact_t::WHICH_PROFILE_SHIFT;
+            switch (which & codec_xact_t::WHICH_CHAIN_MASK) {
             case codec_xact_t::CHAIN_TX1:
                 which_str = "TX1"; break;
             case codec_xact_t::CHAIN_TX2:
@@ -223,6 +252,14 @@ static void e300_codec_ctrl_tunnel(
             case codec_xact_t::ACTION_GET_FREQ:
                     out->freq = _codec_ctrl->get_freq(which_str);
                 break;
+            case codec_xact_t::ACTION_STORE_FAST_LOCK:
+                out->freq = _codec_ctrl->store_fast_lock_profile(
+                    which_str, profile, in->freq);
+                break;
+            case codec_xact_t::ACTION_RECALL_FAST_LOCK:
+                out->freq = _codec_ctrl->recall_fast_lock_profile(
+                    which_str, profile);
+                break;
             case codec_xact_t::ACTION_SET_LOOPBACK:
                 _codec_ctrl->data_port_loopback(
                     uhd::ntohx<uint32_t>(in->bits) & 1);
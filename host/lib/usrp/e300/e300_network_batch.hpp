@@ -0,0 +1,123 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_E300_NETWORK_BATCH_HPP
+#define INCLUDED_E300_NETWORK_BATCH_HPP
+
+#include <uhd/exception.hpp>
+#include <boost/asio.hpp>
+#include <boost/format.hpp>
+#include <cerrno>
+#include <cstring>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace uhd { namespace usrp { namespace e300 {
+
+//! most datagrams moved by one system call in the tunnels
+static const size_t E300_NETWORK_BATCH_SIZE = 16;
+
+/***********************************************************************
+ * Batched socket I/O - one system call for many datagrams
+ **********************************************************************/
+#ifdef HAVE_SENDMMSG
+typedef mmsghdr tunnel_msg_t;
+#else
+struct tunnel_msg_t
+{
+    msghdr msg_hdr;
+    unsigned int msg_len;
+};
+#endif
+
+inline bool wait_for_recv_ready(int sock_fd, const size_t timeout_ms)
+{
+    //setup timeval for timeout
+    timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = timeout_ms*1000;
+
+    //setup rset for timeout
+    fd_set rset;
+    FD_ZERO(&rset);
+    FD_SET(sock_fd, &rset);
+
+    //call select with timeout on receive socket
+    return ::select(sock_fd+1, &rset, NULL, NULL, &tv) > 0;
+}
+
+inline void init_tunnel_msg(
+    tunnel_msg_t &msg,
+    iovec &iov,
+    void *mem,
+    const size_t len,
+    boost::asio::ip::udp::endpoint &ep,
+    const size_t ep_len
+)
+{
+    iov.iov_base = mem;
+    iov.iov_len = len;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_hdr.msg_name = ep.data();
+    msg.msg_hdr.msg_namelen = socklen_t(ep_len);
+    msg.msg_hdr.msg_iov = &iov;
+    msg.msg_hdr.msg_iovlen = 1;
+}
+
+//! sends all datagrams, blocks while the socket buffer is full
+inline void send_batch(const int sock_fd, tunnel_msg_t *msgs, const size_t num_msgs)
+{
+    size_t num_sent = 0;
+    while (num_sent < num_msgs)
+    {
+#ifdef HAVE_SENDMMSG
+        const int ret = ::sendmmsg(sock_fd, msgs + num_sent, unsigned(num_msgs - num_sent), 0);
+#else
+        const int ret = (::sendmsg(sock_fd, &msgs[num_sent].msg_hdr, 0) < 0)? -1 : 1;
+#endif
+        if (ret < 0)
+        {
+            if (errno == EINTR) continue;
+            throw uhd::os_error(str(boost::format("send failed: %s") % std::strerror(errno)));
+        }
+        num_sent += size_t(ret);
+    }
+}
+
+//! returns the number of datagrams already queued on the socket, never blocks
+inline size_t recv_batch(const int sock_fd, tunnel_msg_t *msgs, const size_t num_msgs)
+{
+#ifdef HAVE_SENDMMSG
+    const int ret = ::recvmmsg(sock_fd, msgs, unsigned(num_msgs), MSG_DONTWAIT, NULL);
+#else
+    (void)num_msgs;
+    const ssize_t len = ::recvmsg(sock_fd, &msgs[0].msg_hdr, MSG_DONTWAIT);
+    if (len >= 0) msgs[0].msg_len = unsigned(len);
+    const int ret = (len < 0)? -1 : 1;
+#endif
+    if (ret < 0)
+    {
+        if (errno == EINTR or errno == EAGAIN or errno == EWOULDBLOCK) return 0;
+        throw uhd::os_error(str(boost::format("receive failed: %s") % std::strerror(errno)));
+    }
+    return size_t(ret);
+}
+
+}}}
+
+#endif // INCLUDED_E300_NETWORK_BATCH_HPP
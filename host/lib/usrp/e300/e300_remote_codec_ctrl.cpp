@@ -113,6 +113,27 @@ public:
         return _retval.freq;
     }
 
+    double store_fast_lock_profile(const std::string &which, const size_t profile, const double value)
+    {
+        _clear();
+        _args.action = uhd::htonx<uint32_t>(transaction_t::ACTION_STORE_FAST_LOCK);
+        _args.which = uhd::htonx<uint32_t>(_get_fast_lock_which(which, profile));
+        _args.freq = value;
+
+        _transact();
+        return _retval.freq;
+    }
+
+    double recall_fast_lock_profile(const std::string &which, const size_t profile)
+    {
+        _clear();
+        _args.action = uhd::htonx<uint32_t>(transaction_t::ACTION_RECALL_FAST_LOCK);
+        _args.which = uhd::htonx<uint32_t>(_get_fast_lock_which(which, profile));
+
+        _transact();
+        return _retval.freq;
+    }
+
     void data_port_loopback(const bool on)
     {
         _clear();
@@ -279,6 +300,17 @@ private:
         _retval.bits = 0;
     }
 
+    static uint32_t _get_fast_lock_which(const std::string &which, const size_t profile)
+    {
+        uint32_t chain;
+        if (which == "TX1")      chain = transaction_t::CHAIN_TX1;
+        else if (which == "TX2") chain = transaction_t::CHAIN_TX2;
+        else if (which == "RX1") chain = transaction_t::CHAIN_RX1;
+        else if (which == "RX2") chain = transaction_t::CHAIN_RX2;
+        else throw std::runtime_error("e300_remote_codec_ctrl_impl incorrect chain string.");
+        return chain | (uint32_t(profile) << transaction_t::WHICH_PROFILE_SHIFT);
+    }
+
     uhd::transport::zero_copy_if::sptr _xport;
     transaction_t                      _args;
     transaction_t                      _retval;
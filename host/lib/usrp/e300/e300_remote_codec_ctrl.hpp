@@ -57,6 +57,8 @@ public:
         static const uint32_t ACTION_SET_AGC_MODE        = 20;
         static const uint32_t ACTION_SET_BW              = 21;
         static const uint32_t ACTION_GET_FREQ            = 22;
+        static const uint32_t ACTION_STORE_FAST_LOCK     = 23;
+        static const uint32_t ACTION_RECALL_FAST_LOCK    = 24;
 
         //Values for "which"
         static const uint32_t CHAIN_NONE = 0;
@@ -64,6 +66,10 @@ public:
         static const uint32_t CHAIN_TX2  = 2;
         static const uint32_t CHAIN_RX1  = 3;
         static const uint32_t CHAIN_RX2  = 4;
+
+        //The fast lock actions carry the profile in the upper half of "which"
+        static const uint32_t WHICH_CHAIN_MASK    = 0x0000FFFF;
+        static const uint32_t WHICH_PROFILE_SHIFT = 16;
     };
 
     static sptr make(uhd::transport::zero_copy_if::sptr xport);
@@ -22,6 +22,9 @@
 #ifdef E300_NATIVE
 #include <boost/thread.hpp>
 #include <boost/format.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 #include <fcntl.h>
 #include <sys/ioctl.h>
@@ -30,6 +33,9 @@
 
 namespace uhd { namespace usrp { namespace e300 {
 
+//! Keeps the ioctl() argument size well below the _IOC_SIZEBITS limit
+static const size_t MAX_BATCH_XFERS = 256;
+
 class spidev_impl : public spi
 {
 public:
@@ -105,6 +111,43 @@ public:
         return rx[2];
     }
 
+    void write_spi_batch(int, const uhd::spi_config_t &,
+                         const std::vector<uint32_t> &data,
+                         size_t num_bits)
+    {
+        UHD_ASSERT_THROW(num_bits == 24);
+
+        // Every word becomes one transfer with a chip select toggle
+        // in between, and up to MAX_BATCH_XFERS transfers go into one
+        // ioctl() instead of one ioctl() per word.
+        std::vector<uint8_t> tx(3 * std::min(data.size(), MAX_BATCH_XFERS));
+        std::vector<struct spi_ioc_transfer> tr(std::min(data.size(), MAX_BATCH_XFERS));
+
+        for (size_t offset = 0; offset < data.size(); offset += MAX_BATCH_XFERS) {
+            const size_t n_xfers = std::min(data.size() - offset, MAX_BATCH_XFERS);
+            std::memset(&tr[0], 0, n_xfers * sizeof(struct spi_ioc_transfer));
+            for (size_t i = 0; i < n_xfers; i++) {
+                const uint32_t word = data[offset + i];
+                tx[3*i + 0] = uint8_t(word >> 16);
+                tx[3*i + 1] = uint8_t(word >> 8);
+                tx[3*i + 2] = uint8_t(word >> 0);
+                tr[i].tx_buf = (unsigned long) &tx[3*i];
+                tr[i].rx_buf = 0;
+                tr[i].len = num_bits >> 3;
+                tr[i].bits_per_word = _bits;
+                tr[i].tx_nbits = 1;
+                tr[i].rx_nbits = 1;
+                tr[i].speed_hz = _speed;
+                tr[i].delay_usecs = _delay;
+                tr[i].cs_change = (i + 1 < n_xfers) ? 1 : 0;
+            }
+
+            const int ret = ioctl(_fd, SPI_IOC_MESSAGE(n_xfers), &tr[0]);
+            if (ret < 1)
+                throw uhd::runtime_error("Could not send spidev message");
+        }
+    }
+
 private:
     int _fd;
     uint8_t _mode;
@@ -18,6 +18,7 @@
 #include <uhd/usrp/gps_ctrl.hpp>
 
 #include <uhd/utils/log.hpp>
+#include <uhd/utils/tasks.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/types/sensors.hpp>
 #include <boost/algorithm/string.hpp>
@@ -28,6 +29,8 @@
 #include <boost/format.hpp>
 #include <boost/regex.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/bind.hpp>
 #include <ctime>
 #include <string>
 #include <boost/date_time.hpp>
@@ -49,67 +52,41 @@ gps_ctrl::~gps_ctrl(void){
 
 class gps_ctrl_impl : public gps_ctrl{
 private:
-    std::map<std::string, boost::tuple<std::string, boost::system_time, bool> > sentences;
+    struct sentence_t{
+        sentence_t(void): seq(0){}
+        std::string data;
+        boost::system_time time;
+        size_t seq;
+    };
+
+    //! the latest of each sentence, filled in by the reader task
+    std::map<std::string, sentence_t> sentences;
     boost::mutex cache_mutex;
-    boost::system_time _last_cache_update;
+    boost::condition_variable cache_cond;
 
     std::string get_sentence(const std::string which, const int max_age_ms, const int timeout, const bool wait_for_next = false)
     {
-        std::string sentence;
-        boost::system_time now = boost::get_system_time();
-        boost::system_time exit_time = now + milliseconds(timeout);
-        boost::posix_time::time_duration age;
+        const boost::system_time exit_time = boost::get_system_time() + milliseconds(timeout);
 
-        if (wait_for_next)
-        {
-            boost::lock_guard<boost::mutex> lock(cache_mutex);
-            update_cache();
-            //mark sentence as touched
-            if (sentences.find(which) != sentences.end())
-                sentences[which].get<2>() = true;
-        }
+        boost::mutex::scoped_lock lock(cache_mutex);
+        //only a sentence that comes in after this call is next
+        const size_t last_seq = wait_for_next? sentences[which].seq : 0;
         while (1)
         {
-            try
+            const sentence_t &sentence = sentences[which];
+            if (sentence.seq > last_seq
+                and boost::get_system_time() - sentence.time < milliseconds(max_age_ms))
             {
-                boost::lock_guard<boost::mutex> lock(cache_mutex);
-
-                // update cache if older than a millisecond
-                if (now - _last_cache_update > milliseconds(1))
-                {
-                    update_cache();
-                }
-
-                if (sentences.find(which) == sentences.end())
-                {
-                    age = milliseconds(max_age_ms);
-                } else {
-                    age = boost::get_system_time() - sentences[which].get<1>();
-                }
-                if (age < milliseconds(max_age_ms) and (not (wait_for_next and sentences[which].get<2>())))
-                {
-                    sentence = sentences[which].get<0>();
-                    sentences[which].get<2>() = true;
-                }
-            } catch(std::exception &e) {
-                UHD_LOGGER_DEBUG("GPS") << "get_sentence: " << e.what();
+                return sentence.data;
             }
 
-            if (not sentence.empty() or now > exit_time)
+            if (not cache_cond.timed_wait(lock, exit_time))
             {
                 break;
             }
-
-            sleep(boost::posix_time::milliseconds(1));
-            now = boost::get_system_time();
-        }
-
-        if (sentence.empty())
-        {
-            throw uhd::value_error("gps ctrl: No " + which + " message found");
         }
 
-        return sentence;
+        throw uhd::value_error("gps ctrl: No " + which + " message found");
     }
 
     static bool is_nmea_checksum_ok(std::string nmea)
@@ -133,20 +110,23 @@ private:
         return (string_crc == calculated_crc);
     }
 
-  void update_cache() {
+  /*!
+   * Read all available GPSDO messages into the cache.
+   * \return true if anything was read
+   */
+  bool update_cache() {
     if(not gps_detected()) {
-        return;
+        return false;
     }
 
-    const std::list<std::string> keys = boost::assign::list_of("GPGGA")("GPRMC")("SERVO");
     static const boost::regex servo_regex("^\\d\\d-\\d\\d-\\d\\d.*$");
     static const boost::regex gp_msg_regex("^\\$GP.*,\\*[0-9A-F]{2}$");
-    std::map<std::string,std::string> msgs;
 
-    // Get all GPSDO messages available
-    // Creating a map here because we only want the latest of each message type
+    bool got_msg = false;
     for (std::string msg = _recv(0); not msg.empty(); msg = _recv(0))
     {
+        got_msg = true;
+
         // Strip any end of line characters
         erase_all(msg, "\r");
         erase_all(msg, "\n");
@@ -164,32 +144,46 @@ private:
         }
 
         // Look for SERVO message
+        std::string key;
         if (boost::regex_search(msg, servo_regex, boost::regex_constants::match_continuous))
         {
-            msgs["SERVO"] = msg;
+            key = "SERVO";
         }
         else if (boost::regex_match(msg, gp_msg_regex) and is_nmea_checksum_ok(msg))
         {
-            msgs[msg.substr(1,5)] = msg;
+            key = msg.substr(1,5);
         }
         else
         {
             UHD_LOGGER_WARNING("GPS") << __FUNCTION__ << ": Malformed GPSDO string: " << msg ;
+            continue;
         }
+        if (key != "GPGGA" and key != "GPRMC" and key != "SERVO") continue;
+
+        // Update sentences with newly read data
+        boost::mutex::scoped_lock lock(cache_mutex);
+        sentence_t &sentence = sentences[key];
+        sentence.data = msg;
+        sentence.time = boost::get_system_time();
+        sentence.seq++;
+        cache_cond.notify_all();
     }
 
-    boost::system_time time = boost::get_system_time();
+    return got_msg;
+  }
 
-    // Update sentences with newly read data
-    for(std::string key:  keys)
-    {
-        if (not msgs[key].empty())
-        {
-            sentences[key] = boost::make_tuple(msgs[key], time, false);
-        }
+  /*!
+   * The reader task: keeps the cache up to date so that sensor queries
+   * do not have to wait on the UART. UARTs that poll the device are
+   * not read more often than every GPS_READER_POLL_MS.
+   */
+  void reader_loop(void) {
+    try {
+        if (update_cache()) return;
+    } catch(const std::exception &e) {
+        UHD_LOGGER_DEBUG("GPS") << "reader_loop: " << e.what();
     }
-
-    _last_cache_update = time;
+    sleep(milliseconds(GPS_READER_POLL_MS));
   }
 
 public:
@@ -257,12 +251,16 @@ public:
 
     }
 
-    // initialize cache
-    update_cache();
+    // initialize cache and keep it up to date
+    if (gps_detected()) {
+        update_cache();
+        _reader_task = task::make(boost::bind(&gps_ctrl_impl::reader_loop, this), "gps_reader");
+    }
   }
 
   ~gps_ctrl_impl(void){
-    /* NOP */
+    //stop the reader before the members it uses go away
+    _reader_task.reset();
   }
 
   //return a list of supported sensors
@@ -397,6 +395,7 @@ private:
   }
 
   uart_iface::sptr _uart;
+  task::sptr _reader_task;
 
   void _flush(void){
     while (not _uart->read_uart(0.0).empty()){
@@ -424,6 +423,7 @@ private:
   static const int GPS_LOCK_FRESHNESS = 2500;
   static const int GPS_TIMEOUT_DELAY_MS = 200;
   static const int GPSDO_COMMAND_DELAY_MS = 200;
+  static const int GPS_READER_POLL_MS = 10;
 };
 
 /***********************************************************************
@@ -28,6 +28,7 @@
 #include <uhd/convert.hpp>
 #include <uhd/utils/soft_register.hpp>
 #include "legacy_compat.hpp"
+#include "stream_profile.hpp"
 #include <boost/assign/list_of.hpp>
 #include <boost/thread.hpp>
 #include <boost/format.hpp>
@@ -556,55 +557,74 @@ public:
             _tree->access<time_spec_t>(mb_root(mboard) / "time/pps").set(time_spec);
             return;
         }
-        for (size_t m = 0; m < get_num_mboards(); m++){
-            set_time_next_pps(time_spec, m);
-        }
+        //arm all motherboards at once, so that they all latch the same edge
+        for_each_mboard_parallel([this, &time_spec](const size_t m){
+            this->set_time_next_pps(time_spec, m);
+        });
     }
 
     void set_time_unknown_pps(const time_spec_t &time_spec){
         UHD_LOGGER_INFO("MULTI_USRP") << "    1) catch time transition at pps edge";
-        boost::system_time end_time = boost::get_system_time() + boost::posix_time::milliseconds(1100);
-        time_spec_t time_start_last_pps = get_time_last_pps();
-        while (time_start_last_pps == get_time_last_pps())
+        const time_spec_t time_start_last_pps = get_time_last_pps();
+        if (not wait_for_pps_edge(time_start_last_pps))
         {
-            if (boost::get_system_time() > end_time)
-            {
-                throw uhd::runtime_error(
-                    "Board 0 may not be getting a PPS signal!\n"
-                    "No PPS detected within the time interval.\n"
-                    "See the application notes for your device.\n"
-                );
-            }
-            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+            throw uhd::runtime_error(
+                "Board 0 may not be getting a PPS signal!\n"
+                "No PPS detected within the time interval.\n"
+                "See the application notes for your device.\n"
+            );
         }
 
         UHD_LOGGER_INFO("MULTI_USRP") << "    2) set times next pps (synchronously)";
+        const time_spec_t time_armed_last_pps = get_time_last_pps();
         set_time_next_pps(time_spec, ALL_MBOARDS);
-        boost::this_thread::sleep(boost::posix_time::seconds(1));
+
+        //the times are set at the next edge, some devices only report
+        //the new time at the edge after that, so wait at most a period
+        wait_for_pps_edge(time_armed_last_pps);
 
         //verify that the time registers are read to be within a few RTT
-        for (size_t m = 1; m < get_num_mboards(); m++){
-            time_spec_t time_0 = this->get_time_now(0);
-            time_spec_t time_i = this->get_time_now(m);
-            if (time_i < time_0 or (time_i - time_0) > time_spec_t(0.01)){ //10 ms: greater than RTT but not too big
+        const std::vector<time_spec_t> offsets = get_time_offsets();
+        for (size_t m = 1; m < offsets.size(); m++){
+            UHD_LOGGER_DEBUG("MULTI_USRP") << boost::format(
+                "Board %d time offset to board 0: %f seconds"
+            ) % m % offsets[m].get_real_secs();
+            if (not is_time_offset_synchronized(offsets[m])){
                 UHD_LOGGER_WARNING("MULTI_USRP") << boost::format(
                     "Detected time deviation between board %d and board 0.\n"
-                    "Board 0 time is %f seconds.\n"
-                    "Board %d time is %f seconds.\n"
-                ) % m % time_0.get_real_secs() % m % time_i.get_real_secs();
+                    "Board %d time is %f seconds ahead of board 0.\n"
+                ) % m % m % offsets[m].get_real_secs();
             }
         }
     }
 
     bool get_time_synchronized(void){
-        for (size_t m = 1; m < get_num_mboards(); m++){
-            time_spec_t time_0 = this->get_time_now(0);
-            time_spec_t time_i = this->get_time_now(m);
-            if (time_i < time_0 or (time_i - time_0) > time_spec_t(0.01)) return false;
+        for(const time_spec_t &offset:  get_time_offsets()){
+            if (not is_time_offset_synchronized(offset)) return false;
         }
         return true;
     }
 
+    std::vector<time_spec_t> get_time_offsets(void){
+        const size_t num_mboards = get_num_mboards();
+        std::vector<time_spec_t> times(num_mboards);
+        if (num_mboards == 1) return times;
+
+        //read all times at once, so that the offsets only
+        //include the differences in the readback latency
+        boost::barrier start(num_mboards);
+        for_each_mboard_parallel([this, &times, &start](const size_t m){
+            start.wait();
+            times[m] = this->get_time_now(m);
+        });
+
+        std::vector<time_spec_t> offsets(num_mboards);
+        for (size_t m = 1; m < num_mboards; m++){
+            offsets[m] = times[m] - times[0];
+        }
+        return offsets;
+    }
+
     void set_command_time(const time_spec_t &time_spec, size_t mboard){
         if (mboard != ALL_MBOARDS){
             if (not _tree->exists(mb_root(mboard) / "time/cmd")){
@@ -768,7 +788,9 @@ public:
     /*******************************************************************
      * RX methods
      ******************************************************************/
-    rx_streamer::sptr get_rx_stream(const stream_args_t &args) {
+    rx_streamer::sptr get_rx_stream(const stream_args_t &args_) {
+        stream_args_t args = args_;
+        apply_stream_profile(args);
         _check_link_rate(args, false);
         if (is_device3()) {
             return _legacy_compat->get_rx_stream(args);
@@ -875,6 +897,15 @@ public:
         return _tree->access<meta_range_t>(rx_rf_fe_root(chan) / "freq" / "range").get();
     }
 
+    double store_rx_fast_lock_profile(size_t profile, double freq, size_t chan){
+        const fs_path profile_path = get_fast_lock_profile_path(rx_rf_fe_root(chan), profile);
+        return _tree->access<double>(profile_path).set(freq).get();
+    }
+
+    void recall_rx_fast_lock_profile(size_t profile, size_t chan){
+        recall_fast_lock_profile(rx_rf_fe_root(chan), profile);
+    }
+
     std::vector<std::string> get_rx_lo_names(size_t chan = 0){
         std::vector<std::string> lo_names;
         if (_tree->exists(rx_rf_fe_root(chan) / "los")) {
@@ -1308,7 +1339,9 @@ public:
     /*******************************************************************
      * TX methods
      ******************************************************************/
-    tx_streamer::sptr get_tx_stream(const stream_args_t &args) {
+    tx_streamer::sptr get_tx_stream(const stream_args_t &args_) {
+        stream_args_t args = args_;
+        apply_stream_profile(args);
         _check_link_rate(args, true);
         if (is_device3()) {
             return _legacy_compat->get_tx_stream(args);
@@ -1415,6 +1448,15 @@ public:
         return _tree->access<meta_range_t>(tx_rf_fe_root(chan) / "freq" / "range").get();
     }
 
+    double store_tx_fast_lock_profile(size_t profile, double freq, size_t chan){
+        const fs_path profile_path = get_fast_lock_profile_path(tx_rf_fe_root(chan), profile);
+        return _tree->access<double>(profile_path).set(freq).get();
+    }
+
+    void recall_tx_fast_lock_profile(size_t profile, size_t chan){
+        recall_fast_lock_profile(tx_rf_fe_root(chan), profile);
+    }
+
     void set_tx_gain(double gain, const std::string &name, size_t chan){
         try {
             return tx_gain_group(chan)->set_value(gain, name);
@@ -1721,6 +1763,56 @@ private:
     bool _is_device3;
     uhd::rfnoc::legacy_compat::sptr _legacy_compat;
 
+    /*!
+     * Call a function for every motherboard, each from its own thread.
+     * \throws uhd::runtime_error if any of the calls threw
+     */
+    void for_each_mboard_parallel(const boost::function<void(const size_t)> &fcn){
+        const size_t num_mboards = get_num_mboards();
+        if (num_mboards == 1) return fcn(0);
+
+        std::vector<std::string> errors(num_mboards);
+        boost::thread_group threads;
+        for (size_t m = 0; m < num_mboards; m++){
+            threads.create_thread([&fcn, &errors, m](){
+                try{
+                    fcn(m);
+                }
+                catch(const std::exception &e){
+                    errors[m] = e.what();
+                }
+            });
+        }
+        threads.join_all();
+
+        for (size_t m = 0; m < num_mboards; m++){
+            if (not errors[m].empty()){
+                throw uhd::runtime_error(str(boost::format(
+                    "Board %d: %s") % m % errors[m]
+                ));
+            }
+        }
+    }
+
+    /*!
+     * Wait until the time of the last PPS of board 0 changes.
+     * \return false if it did not change within a PPS period
+     */
+    bool wait_for_pps_edge(const time_spec_t &last_pps){
+        const boost::system_time end_time = boost::get_system_time() + boost::posix_time::milliseconds(1100);
+        while (last_pps == get_time_last_pps())
+        {
+            if (boost::get_system_time() > end_time) return false;
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+        return true;
+    }
+
+    static bool is_time_offset_synchronized(const time_spec_t &offset){
+        //10 ms: greater than RTT but not too big
+        return offset > time_spec_t(-0.01) and offset < time_spec_t(0.01);
+    }
+
     struct mboard_chan_pair{
         size_t mboard, chan;
         mboard_chan_pair(void): mboard(0), chan(0){}
@@ -1862,6 +1954,33 @@ private:
         }
     }
 
+    //! Get the path of a fast lock profile, checking the device and the index
+    fs_path get_fast_lock_profile_path(const fs_path &rf_fe_root, const size_t profile)
+    {
+        const fs_path profiles_path = rf_fe_root / "freq" / "fast_lock" / "profiles";
+        if (not _tree->exists(profiles_path)) {
+            throw uhd::runtime_error("This device does not support fast lock profiles");
+        }
+        const fs_path profile_path = profiles_path / boost::lexical_cast<std::string>(profile);
+        if (not _tree->exists(profile_path)) {
+            throw uhd::value_error(str(
+                boost::format("Invalid fast lock profile %d, the device has %d")
+                % profile % _tree->list(profiles_path).size()
+            ));
+        }
+        return profile_path;
+    }
+
+    //! Switch the LO to a stored profile and update the frequency value to match
+    void recall_fast_lock_profile(const fs_path &rf_fe_root, const size_t profile)
+    {
+        get_fast_lock_profile_path(rf_fe_root, profile);
+        _tree->access<size_t>(rf_fe_root / "freq" / "fast_lock" / "recall").set(profile);
+        //the LO is already there, so this does not tune again
+        property<double> &freq = _tree->access<double>(rf_fe_root / "freq" / "value");
+        freq.set(freq.get());
+    }
+
     fs_path rx_rf_fe_root(const size_t chan)
     {
         mboard_chan_pair mcp = rx_chan_to_mcp(chan);
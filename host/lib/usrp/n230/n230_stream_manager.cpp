@@ -111,6 +111,7 @@ rx_streamer::sptr n230_stream_manager::get_rx_stream(const uhd::stream_args_t &a
         my_streamer->resize(args.channels.size());
 
         //init some streamer stuff
+        my_streamer->set_recv_args(args.args);
         my_streamer->set_vrt_unpacker(&n230_stream_manager::_cvita_hdr_unpack);
 
         //set the converter
@@ -134,6 +135,10 @@ rx_streamer::sptr n230_stream_manager::get_rx_stream(const uhd::stream_args_t &a
             boost::bind(&zero_copy_if::get_recv_buff, xport, _1),
             true /*flush*/
         );
+        my_streamer->set_xport_chan_ready_fd(
+            stream_i,
+            boost::bind(&zero_copy_if::get_recv_fd, xport)
+        );
 
         my_streamer->set_overflow_handler(stream_i, boost::bind(
             &n230_stream_manager::_handle_overflow, this, chan
@@ -272,6 +277,7 @@ tx_streamer::sptr n230_stream_manager::get_tx_stream(const uhd::stream_args_t &a
         //get_tx_buff_with_flowctrl is static so bind has no lifetime issues
         //xport.send (sptr) is required to add streamer->data-transport lifetime dependency
         //task (sptr) is required to add  a streamer->async-handler lifetime dependency
+        my_streamer->set_send_args(args.args);
         my_streamer->set_xport_chan_get_buff(
             stream_i,
             boost::bind(&n230_stream_manager::_get_tx_buff_with_flowctrl, task, fc_cache, xport, fc_window, _1)
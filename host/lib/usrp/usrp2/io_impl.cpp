@@ -441,6 +441,7 @@ rx_streamer::sptr usrp2_impl::get_rx_stream(const uhd::stream_args_t &args_){
     //init some streamer stuff
     my_streamer->resize(args.channels.size());
     my_streamer->set_vrt_unpacker(&vrt::if_hdr_unpack_be);
+    my_streamer->set_recv_args(args.args);
 
     //set the converter
     uhd::convert::id_type id;
@@ -464,6 +465,9 @@ rx_streamer::sptr usrp2_impl::get_rx_stream(const uhd::stream_args_t &args_){
                 my_streamer->set_xport_chan_get_buff(chan_i, boost::bind(
                     &zero_copy_if::get_recv_buff, _mbc[mb].rx_dsp_xports[dsp], _1
                 ), true /*flush*/);
+                my_streamer->set_xport_chan_ready_fd(chan_i, boost::bind(
+                    &zero_copy_if::get_recv_fd, _mbc[mb].rx_dsp_xports[dsp]
+                ));
                 my_streamer->set_issue_stream_cmd(chan_i, boost::bind(
                     &rx_dsp_core_200::issue_stream_command, _mbc[mb].rx_dsps[dsp], _1));
                 _mbc[mb].rx_streamers[dsp] = my_streamer; //store weak pointer
@@ -536,6 +540,7 @@ tx_streamer::sptr usrp2_impl::get_tx_stream(const uhd::stream_args_t &args_){
                     _io_impl->fc_mons[abs]->clear();
                 }
                 _mbc[mb].tx_dsp->setup(args);
+                my_streamer->set_send_args(args.args);
                 my_streamer->set_xport_chan_get_buff(chan_i, boost::bind(
                     &usrp2_impl::io_impl::get_send_buff, _io_impl.get(), abs, _1
                 ));
@@ -542,6 +542,8 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
     eth_addrs.push_back(eth0_addr);
 
     mb.next_src_addr = 0;   //Host source address for blocks
+    mb.next_tx_src_addr = 0;
+    mb.next_rx_src_addr = 0;
     if (dev_addr.has_key("second_addr")) {
         std::string eth1_addr = dev_addr["second_addr"];
 
@@ -1156,13 +1158,20 @@ uhd::both_xports_t x300_impl::make_transport(
         xports.send_buff_size = xports.send->get_num_send_frames() * xports.send->get_send_frame_size();
 
     } else if (mb.xport_path == "eth") {
-        // Decide on the IP/Interface pair based on the endpoint index
-        std::string interface_addr = mb.eth_conns[mb.next_src_addr].addr;
+        // Decide on the IP/Interface pair based on the endpoint index.
+        // RX and TX data each take turns over the links on their own, so
+        // that consecutive channels alternate links no matter how many
+        // control transports were made in between.
+        size_t &next_src_addr =
+            (xport_type == RX_DATA) ? mb.next_rx_src_addr :
+            (xport_type == TX_DATA) ? mb.next_tx_src_addr : mb.next_src_addr;
+        const size_t link = next_src_addr;
+        next_src_addr = (next_src_addr + 1) % mb.eth_conns.size();
+        std::string interface_addr = mb.eth_conns[link].addr;
         const uint32_t xbar_src_addr =
-            mb.next_src_addr==0 ? X300_SRC_ADDR0 : X300_SRC_ADDR1;
+            link==0 ? X300_SRC_ADDR0 : X300_SRC_ADDR1;
         const uint32_t xbar_src_dst =
-            mb.eth_conns[mb.next_src_addr].type==X300_IFACE_ETH0 ? X300_XB_DST_E0 : X300_XB_DST_E1;
-        mb.next_src_addr = (mb.next_src_addr + 1) % mb.eth_conns.size();
+            mb.eth_conns[link].type==X300_IFACE_ETH0 ? X300_XB_DST_E0 : X300_XB_DST_E1;
 
         xports.send_sid = this->allocate_sid(mb, address, xbar_src_addr, xbar_src_dst);
         xports.recv_sid = xports.send_sid.reversed();
@@ -1248,16 +1257,52 @@ uhd::both_xports_t x300_impl::make_transport(
         //make a new transport - fpga has no idea how to talk to us on this yet
         udp_zero_copy::buff_params buff_params;
 
-        xports.recv = udp_zero_copy::make(
-                interface_addr,
-                BOOST_STRINGIZE(X300_VITA_UDP_PORT),
-                default_buff_args,
-                buff_params,
-                xport_args);
+        if (xport_type == RX_DATA and xport_args.has_key("recv_port_base")) {
+            // Bind to the lowest free local port from the base, so that every
+            // channel has its own port that flow steering rules can match
+            const size_t port_base = xport_args.cast<size_t>("recv_port_base", 0);
+            if (port_base == 0 or port_base > 0xFFFF) {
+                throw uhd::value_error(str(
+                    boost::format("Invalid recv_port_base %u, expected 1 to 65535")
+                    % port_base
+                ));
+            }
+            const size_t port_end = std::min<size_t>(port_base + X300_ETH_RECV_PORT_RANGE, 0x10000);
+            device_addr_t udp_args = xport_args;
+            for (size_t port = port_base; not xports.recv; port++) {
+                if (port >= port_end) {
+                    throw uhd::runtime_error(str(
+                        boost::format("No free UDP port in %u to %u for RX data")
+                        % port_base % (port - 1)
+                    ));
+                }
+                udp_args["local_port"] = boost::lexical_cast<std::string>(port);
+                try {
+                    xports.recv = udp_zero_copy::make(
+                            interface_addr,
+                            BOOST_STRINGIZE(X300_VITA_UDP_PORT),
+                            default_buff_args,
+                            buff_params,
+                            udp_args);
+                } catch (const uhd::io_error &) {
+                    continue;
+                }
+                UHD_LOGGER_DEBUG("X300") << "RX data on " << interface_addr
+                    << " local port " << port << " sid " << xports.send_sid;
+            }
+        } else {
+            xports.recv = udp_zero_copy::make(
+                    interface_addr,
+                    BOOST_STRINGIZE(X300_VITA_UDP_PORT),
+                    default_buff_args,
+                    buff_params,
+                    xport_args);
+        }
 
-        // Create a threaded transport for the receive chain only
+        // Create a threaded transport for the receive chain only,
+        // unless the streamer asked to receive in its own thread
         // Note that this shouldn't affect PCIe
-        if (xport_type == RX_DATA) {
+        if (xport_type == RX_DATA and xport_args.cast<int>("recv_offload", 1) != 0) {
             xports.recv = zero_copy_recv_offload::make(
                     xports.recv,
                     X300_THREAD_BUFFER_TIMEOUT
@@ -75,6 +75,8 @@ static const double X300_THREAD_BUFFER_TIMEOUT      = 0.1;   // Time in seconds
 
 static const size_t X300_ETH_MSG_NUM_FRAMES         = 64;
 static const size_t X300_ETH_DATA_NUM_FRAMES        = 32;
+// Number of local ports tried from recv_port_base for an RX data socket
+static const size_t X300_ETH_RECV_PORT_RANGE        = 256;
 static const double X300_DEFAULT_SYSREF_RATE        = 10e6;
 
 // Limit the number of initialization threads
@@ -166,6 +168,8 @@ private:
 
         std::vector<x300_eth_conn_t> eth_conns;
         size_t next_src_addr;
+        size_t next_tx_src_addr;
+        size_t next_rx_src_addr;
 
         // Discover the ethernet connections per motherboard
         void discover_eth(const uhd::usrp::mboard_eeprom_t mb_eeprom,
@@ -21,15 +21,29 @@
 #include <uhd/utils/algorithm.hpp>
 #include <uhd/exception.hpp>
 #include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 using namespace uhd;
 
 static bool compare_by_step_size(
-    const size_t &rhs, const size_t &lhs, std::vector<gain_fcns_t> &fcns
+    const size_t &rhs, const size_t &lhs, const std::vector<gain_range_t> &ranges
 ){
-    return fcns.at(rhs).get_range().step() > fcns.at(lhs).get_range().step();
+    return ranges.at(rhs).step() > ranges.at(lhs).step();
+}
+
+//! the largest distribution table to precompute (in overall gain steps)
+static const size_t MAX_TABLE_STEPS = 4096;
+
+//! how close to a step of the overall range a gain must be to use the table
+static const double TABLE_GRID_TOLERANCE = 1e-6;
+
+static bool is_same_range(const gain_range_t &a, const gain_range_t &b){
+    return a.start() == b.start() and a.stop() == b.stop() and a.step() == b.step();
 }
 
 /*!
@@ -64,7 +78,9 @@ gain_group::~gain_group(void){
  **********************************************************************/
 class gain_group_impl : public gain_group{
 public:
-    gain_group_impl(void){
+    gain_group_impl(void):
+        _table_start(0.0), _table_step(0.0), _table_ready(false)
+    {
         /*NOP*/
     }
 
@@ -72,7 +88,7 @@ public:
         if (not name.empty()) return _name_to_fcns.get(name).get_range();
 
         double overall_min = 0, overall_max = 0, overall_step = 0;
-        for(const gain_fcns_t &fcns:  get_all_fcns()){
+        for(const gain_fcns_t &fcns:  *get_all_fcns()){
             const gain_range_t range = fcns.get_range();
             overall_min += range.start();
             overall_max += range.stop();
@@ -87,7 +103,7 @@ public:
         if (not name.empty()) return _name_to_fcns.get(name).get_value();
 
         double overall_gain = 0;
-        for(const gain_fcns_t &fcns:  get_all_fcns()){
+        for(const gain_fcns_t &fcns:  *get_all_fcns()){
             overall_gain += fcns.get_value();
         }
         return overall_gain;
@@ -96,22 +112,146 @@ public:
     void set_value(double gain, const std::string &name){
         if (not name.empty()) return _name_to_fcns.get(name).set_value(gain);
 
-        std::vector<gain_fcns_t> all_fcns = get_all_fcns();
-        if (all_fcns.size() == 0) return; //nothing to set!
+        fcns_list_sptr all_fcns;
+        std::vector<double> gain_bucket;
+        {
+            boost::mutex::scoped_lock lock(_cache_mutex);
+            all_fcns = _get_all_fcns();
+            if (all_fcns->size() == 0) return; //nothing to set!
+            update_ranges(*all_fcns);
+
+            //look up the distribution for gains on the overall step grid,
+            //compute it on the fly for anything else
+            if (not _table.empty()){
+                const double index = (gain - _table_start)/_table_step;
+                const size_t num_rows = _table.size()/all_fcns->size();
+                if (index > -0.5 and index < num_rows - 0.5){
+                    const size_t row = size_t(index + 0.5);
+                    if (std::abs(index - row) < TABLE_GRID_TOLERANCE){
+                        const double *bucket = &_table[row*all_fcns->size()];
+                        gain_bucket.assign(bucket, bucket + all_fcns->size());
+                    }
+                }
+            }
+            if (gain_bucket.empty()) gain_bucket = distribute(gain);
+        }
+
+        //now write the bucket out to the individual gain values
+        for (size_t i = 0; i < all_fcns->size(); i++){
+            UHD_LOGGER_DEBUG("UHD") << i << ": " << gain_bucket[i] ;
+            all_fcns->at(i).set_value(gain_bucket[i]);
+        }
+    }
+
+    const std::vector<std::string> get_names(void){
+        return _name_to_fcns.keys();
+    }
 
+    void register_fcns(
+        const std::string &name,
+        const gain_fcns_t &gain_fcns,
+        size_t priority
+    ){
+        boost::mutex::scoped_lock lock(_cache_mutex);
+        //ensure the name name is unique and non-empty
+        std::string unique_name = name;
+        while (unique_name.empty() or _name_to_fcns.has_key(unique_name)){
+            unique_name += "_";
+        }
+        _registry[priority].push_back(gain_fcns);
+        _name_to_fcns[unique_name] = gain_fcns;
+
+        //the element order changed, rebuild everything on the next use
+        _all_fcns.reset();
+        _ranges.clear();
+        _table.clear();
+        _table_ready = false;
+    }
+
+private:
+    typedef boost::shared_ptr<const std::vector<gain_fcns_t> > fcns_list_sptr;
+
+    //! get the gain function sets in order (highest priority first)
+    fcns_list_sptr get_all_fcns(void){
+        boost::mutex::scoped_lock lock(_cache_mutex);
+        return _get_all_fcns();
+    }
+
+    //! get_all_fcns() for callers that hold the cache mutex
+    fcns_list_sptr _get_all_fcns(void){
+        if (_all_fcns) return _all_fcns;
+        boost::shared_ptr<std::vector<gain_fcns_t> > all_fcns(new std::vector<gain_fcns_t>());
+        for(size_t key:  uhd::sorted(_registry.keys())){
+            const std::vector<gain_fcns_t> &fcns = _registry[key];
+            all_fcns->insert(all_fcns->begin(), fcns.begin(), fcns.end());
+        }
+        _all_fcns = all_fcns;
+        return _all_fcns;
+    }
+
+    /*!
+     * Query the element ranges and drop the distribution table when they
+     * changed. The table is built once the ranges were seen unchanged,
+     * so elements whose ranges keep changing do not rebuild it every time.
+     * Needs the cache mutex.
+     */
+    void update_ranges(const std::vector<gain_fcns_t> &all_fcns){
+        std::vector<gain_range_t> ranges;
+        ranges.reserve(all_fcns.size());
+        bool changed = (_ranges.size() != all_fcns.size());
+        for (size_t i = 0; i < all_fcns.size(); i++){
+            ranges.push_back(all_fcns[i].get_range());
+            if (not changed and not is_same_range(ranges.back(), _ranges[i])) changed = true;
+        }
+        if (changed){
+            _ranges.swap(ranges);
+            _table.clear();
+            _table_ready = false;
+        }
+        else if (not _table_ready){
+            build_table();
+            _table_ready = true;
+        }
+    }
+
+    //! precompute the distribution for every step of the overall range
+    void build_table(void){
+        _table.clear();
+        double overall_min = 0, overall_max = 0, overall_step = 0;
+        for(const gain_range_t &range:  _ranges){
+            if (range.step() <= 0) return; //continuous, no table
+            overall_min += range.start();
+            overall_max += range.stop();
+            if (overall_step == 0) overall_step = range.step();
+            overall_step = std::min(overall_step, range.step());
+        }
+        const double num_steps = std::floor((overall_max - overall_min)/overall_step + TABLE_GRID_TOLERANCE) + 1;
+        if (num_steps > MAX_TABLE_STEPS) return;
+
+        _table_start = overall_min;
+        _table_step = overall_step;
+        _table.reserve(size_t(num_steps)*_ranges.size());
+        for (size_t k = 0; k < size_t(num_steps); k++){
+            const std::vector<double> gain_bucket = distribute(_table_start + k*_table_step);
+            _table.insert(_table.end(), gain_bucket.begin(), gain_bucket.end());
+        }
+    }
+
+    //! distribute an overall gain across the elements with the current ranges
+    std::vector<double> distribute(const double gain) const{
         //get the max step size among the gains
         double max_step = 0;
-        for(const gain_fcns_t &fcns:  all_fcns){
-            max_step = std::max(max_step, fcns.get_range().step());
+        for(const gain_range_t &range:  _ranges){
+            max_step = std::max(max_step, range.step());
         }
 
         //create gain bucket to distribute power
         std::vector<double> gain_bucket;
+        gain_bucket.reserve(_ranges.size());
 
         //distribute power according to priority (round to max step)
         double gain_left_to_distribute = gain;
-        for(const gain_fcns_t &fcns:  all_fcns){
-            const gain_range_t range = fcns.get_range();
+        for(const gain_range_t &range:  _ranges){
             gain_bucket.push_back(floor_step(uhd::clip(
                 gain_left_to_distribute, range.start(), range.stop()
             ), max_step));
@@ -120,67 +260,45 @@ public:
 
         //get a list of indexes sorted by step size large to small
         std::vector<size_t> indexes_step_size_dec;
-        for (size_t i = 0; i < all_fcns.size(); i++){
+        for (size_t i = 0; i < _ranges.size(); i++){
             indexes_step_size_dec.push_back(i);
         }
         std::sort(
             indexes_step_size_dec.begin(), indexes_step_size_dec.end(),
-            boost::bind(&compare_by_step_size, _1, _2, all_fcns)
+            boost::bind(&compare_by_step_size, _1, _2, boost::cref(_ranges))
         );
         UHD_ASSERT_THROW(
-            all_fcns.at(indexes_step_size_dec.front()).get_range().step() >=
-            all_fcns.at(indexes_step_size_dec.back()).get_range().step()
+            _ranges.at(indexes_step_size_dec.front()).step() >=
+            _ranges.at(indexes_step_size_dec.back()).step()
         );
 
         //distribute the remainder (less than max step)
         //fill in the largest step sizes first that are less than the remainder
         for(size_t i:  indexes_step_size_dec){
-            const gain_range_t range = all_fcns.at(i).get_range();
+            const gain_range_t &range = _ranges.at(i);
             double additional_gain = floor_step(uhd::clip(
                 gain_bucket.at(i) + gain_left_to_distribute, range.start(), range.stop()
             ), range.step()) - gain_bucket.at(i);
             gain_bucket.at(i) += additional_gain;
             gain_left_to_distribute -= additional_gain;
         }
-        UHD_LOGGER_DEBUG("UHD") << "gain_left_to_distribute " << gain_left_to_distribute ;
-
-        //now write the bucket out to the individual gain values
-        for (size_t i = 0; i < gain_bucket.size(); i++){
-            UHD_LOGGER_DEBUG("UHD") << i << ": " << gain_bucket.at(i) ;
-            all_fcns.at(i).set_value(gain_bucket.at(i));
-        }
+        return gain_bucket;
     }
 
-    const std::vector<std::string> get_names(void){
-        return _name_to_fcns.keys();
-    }
+    uhd::dict<size_t, std::vector<gain_fcns_t> > _registry;
+    uhd::dict<std::string, gain_fcns_t> _name_to_fcns;
 
-    void register_fcns(
-        const std::string &name,
-        const gain_fcns_t &gain_fcns,
-        size_t priority
-    ){
-        if (name.empty() or _name_to_fcns.has_key(name)){
-            //ensure the name name is unique and non-empty
-            return register_fcns(name + "_", gain_fcns, priority);
-        }
-        _registry[priority].push_back(gain_fcns);
-        _name_to_fcns[name] = gain_fcns;
-    }
+    //! guards the caches below, set_value() may be called from several threads
+    boost::mutex _cache_mutex;
 
-private:
-    //! get the gain function sets in order (highest priority first)
-    std::vector<gain_fcns_t> get_all_fcns(void){
-        std::vector<gain_fcns_t> all_fcns;
-        for(size_t key:  uhd::sorted(_registry.keys())){
-            const std::vector<gain_fcns_t> &fcns = _registry[key];
-            all_fcns.insert(all_fcns.begin(), fcns.begin(), fcns.end());
-        }
-        return all_fcns;
-    }
+    //! the elements in priority order and their ranges when last used
+    fcns_list_sptr _all_fcns;
+    std::vector<gain_range_t> _ranges;
 
-    uhd::dict<size_t, std::vector<gain_fcns_t> > _registry;
-    uhd::dict<std::string, gain_fcns_t> _name_to_fcns;
+    //! precomputed distributions, one row of element gains per overall step
+    std::vector<double> _table;
+    double _table_start, _table_step;
+    bool _table_ready;
 };
 
 /***********************************************************************
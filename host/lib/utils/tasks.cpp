@@ -18,6 +18,7 @@
 #include <uhd/utils/tasks.hpp>
 #include <uhd/utils/msg_task.hpp>
 #include <uhd/utils/log.hpp>
+#include <uhd/utils/thread_priority.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/barrier.hpp>
 #include <exception>
@@ -29,10 +30,10 @@ using namespace uhd;
 class task_impl : public task{
 public:
 
-    task_impl(const task_fcn_type &task_fcn):
+    task_impl(const task_fcn_type &task_fcn, const std::string &role):
         _spawn_barrier(2)
     {
-        _thread_group.create_thread(boost::bind(&task_impl::task_loop, this, task_fcn));
+        _thread_group.create_thread(boost::bind(&task_impl::task_loop, this, task_fcn, role));
         _spawn_barrier.wait();
     }
 
@@ -44,7 +45,8 @@ public:
 
 private:
 
-    void task_loop(const task_fcn_type &task_fcn){
+    void task_loop(const task_fcn_type &task_fcn, const std::string &role){
+        apply_thread_placement(role);
         _running = true;
         _spawn_barrier.wait();
 
@@ -79,8 +81,8 @@ private:
     bool _running;
 };
 
-task::sptr task::make(const task_fcn_type &task_fcn){
-    return task::sptr(new task_impl(task_fcn));
+task::sptr task::make(const task_fcn_type &task_fcn, const std::string &role){
+    return task::sptr(new task_impl(task_fcn, role));
 }
 
 msg_task::~msg_task(void){
@@ -132,6 +134,7 @@ public:
 private:
 
     void task_loop(const task_fcn_type &task_fcn){
+        apply_thread_placement("task");
         _running = true;
         _spawn_barrier.wait();
 
@@ -17,8 +17,14 @@
 
 #include <uhd/utils/thread_priority.hpp>
 #include <uhd/utils/log.hpp>
+#include <uhd/utils/static.hpp>
+#include <uhd/types/dict.hpp>
 #include <uhd/exception.hpp>
 #include <boost/format.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/mutex.hpp>
+#include <fstream>
 #include <iostream>
 
 bool uhd::set_thread_priority_safe(float priority, bool realtime){
@@ -108,3 +114,201 @@ static void check_priority_range(float priority){
     }
 
 #endif /* HAVE_THREAD_PRIO_DUMMY */
+
+/***********************************************************************
+ * Pthread API to set affinity
+ **********************************************************************/
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+    #include <pthread.h>
+    #include <sched.h>
+
+    void uhd::set_thread_affinity(const std::vector<size_t> &cpus){
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (size_t i = 0; i < cpus.size(); i++){
+            if (cpus[i] >= CPU_SETSIZE) throw uhd::value_error(str(
+                boost::format("CPU index %u out of range") % cpus[i]
+            ));
+            CPU_SET(cpus[i], &cpu_set);
+        }
+        int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (ret != 0) throw uhd::os_error("error in pthread_setaffinity_np");
+    }
+
+/***********************************************************************
+ * Windows API to set affinity
+ **********************************************************************/
+#elif defined(HAVE_WIN_SETTHREADPRIORITY)
+    void uhd::set_thread_affinity(const std::vector<size_t> &cpus){
+        DWORD_PTR mask = 0;
+        for (size_t i = 0; i < cpus.size(); i++){
+            if (cpus[i] >= sizeof(DWORD_PTR)*8) throw uhd::value_error(str(
+                boost::format("CPU index %u out of range") % cpus[i]
+            ));
+            mask |= DWORD_PTR(1) << cpus[i];
+        }
+        if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0)
+            throw uhd::os_error("error in SetThreadAffinityMask");
+    }
+
+/***********************************************************************
+ * Unimplemented API to set affinity
+ **********************************************************************/
+#else
+    void uhd::set_thread_affinity(const std::vector<size_t> &){
+        throw uhd::not_implemented_error("set thread affinity not implemented");
+    }
+#endif /* HAVE_PTHREAD_SETAFFINITY_NP */
+
+/***********************************************************************
+ * Thread names
+ **********************************************************************/
+#ifdef HAVE_PTHREAD_SETNAME_NP
+    #include <pthread.h>
+
+    void uhd::set_thread_name(const std::string &name){
+        //the kernel limits names to 16 bytes including the terminator
+        pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+    }
+#else
+    void uhd::set_thread_name(const std::string &){
+        //not supported on this platform
+    }
+#endif /* HAVE_PTHREAD_SETNAME_NP */
+
+/***********************************************************************
+ * Placement policy for internal threads
+ **********************************************************************/
+namespace {
+    struct thread_placement_t{
+        thread_placement_t(void): has_priority(false), priority(0.0){}
+        std::vector<size_t> cpus;
+        bool has_priority;
+        float priority;
+    };
+
+#ifdef CPU_SETSIZE
+    const size_t MAX_NUM_CPUS = CPU_SETSIZE;
+#else
+    const size_t MAX_NUM_CPUS = 1024;
+#endif
+
+    //! Parses lists such as "2-3:6" into CPU indexes
+    std::vector<size_t> parse_cpu_list(const std::string &list, const std::string &seps){
+        std::vector<size_t> cpus;
+        std::vector<std::string> items;
+        boost::split(items, list, boost::is_any_of(seps));
+        for(std::string item:  items){
+            boost::trim(item);
+            if (item.empty()) continue;
+            size_t first = 0, last = 0;
+            try{
+                const size_t dash = item.find('-');
+                first = boost::lexical_cast<size_t>(item.substr(0, dash));
+                last = (dash == std::string::npos)?
+                    first : boost::lexical_cast<size_t>(item.substr(dash+1));
+            }
+            catch(const boost::bad_lexical_cast &){
+                throw uhd::value_error(str(boost::format("Invalid CPU list \"%s\"") % list));
+            }
+            if (first > last) throw uhd::value_error(str(
+                boost::format("Invalid CPU range \"%s\" in \"%s\"") % item % list
+            ));
+            if (last >= MAX_NUM_CPUS) throw uhd::value_error(str(
+                boost::format("CPU index %u in \"%s\" out of range") % last % list
+            ));
+            for (size_t cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    std::vector<size_t> get_numa_node_cpus(const std::string &node){
+        const std::string path = str(boost::format("/sys/devices/system/node/node%s/cpulist") % node);
+        std::ifstream cpulist(path.c_str());
+        std::string list;
+        if (not std::getline(cpulist, list)) throw uhd::value_error(str(
+            boost::format("Cannot read the CPUs of NUMA node %s from %s") % node % path
+        ));
+        //the kernel separates ranges with commas
+        return parse_cpu_list(list, ",");
+    }
+
+    float parse_priority(const std::string &value){
+        float priority = 0.0;
+        try{
+            priority = boost::lexical_cast<float>(value);
+        }
+        catch(const boost::bad_lexical_cast &){
+            priority = 2.0; //rejected below
+        }
+        if (priority > +1.0 or priority < -1.0) throw uhd::value_error(str(
+            boost::format("Invalid thread priority \"%s\", expected -1.0 to +1.0") % value
+        ));
+        return priority;
+    }
+
+    typedef uhd::dict<std::string, thread_placement_t> placement_table_t;
+    UHD_SINGLETON_FCN(placement_table_t, get_placement_table)
+    UHD_SINGLETON_FCN(boost::mutex, get_placement_mutex)
+
+    const char *THREAD_ROLES[] = {
+        "task", "recv_offload", "mux_recv", "usb_event", "send_worker", "gps_reader"
+    };
+}
+
+void uhd::set_thread_placement(const device_addr_t &args){
+    //arguments without thread_ keys give every role the default placement,
+    //so that a device does not inherit the policy of the previous device
+    thread_placement_t defaults;
+    if (args.has_key("thread_numa_node")){
+        defaults.cpus = get_numa_node_cpus(args["thread_numa_node"]);
+    }
+    if (args.has_key("thread_cpus")){
+        defaults.cpus = parse_cpu_list(args["thread_cpus"], ":");
+    }
+    if (args.has_key("thread_priority")){
+        defaults.has_priority = true;
+        defaults.priority = parse_priority(args["thread_priority"]);
+    }
+
+    placement_table_t table;
+    for(const char *role:  THREAD_ROLES){
+        thread_placement_t placement = defaults;
+        const std::string prefix = std::string("thread_") + role;
+        if (args.has_key(prefix + "_cpus")){
+            placement.cpus = parse_cpu_list(args[prefix + "_cpus"], ":");
+        }
+        if (args.has_key(prefix + "_priority")){
+            placement.has_priority = true;
+            placement.priority = parse_priority(args[prefix + "_priority"]);
+        }
+        table[role] = placement;
+    }
+
+    boost::mutex::scoped_lock lock(get_placement_mutex());
+    get_placement_table() = table;
+}
+
+void uhd::apply_thread_placement(const std::string &role){
+    set_thread_name("uhd_" + role);
+
+    thread_placement_t placement;
+    {
+        boost::mutex::scoped_lock lock(get_placement_mutex());
+        if (not get_placement_table().has_key(role)) return;
+        placement = get_placement_table()[role];
+    }
+
+    if (not placement.cpus.empty()){
+        try{
+            set_thread_affinity(placement.cpus);
+        }catch(const std::exception &e){
+            UHD_LOGGER_WARNING("UHD") << boost::format(
+                "Unable to set the CPU affinity of the %s thread: %s"
+            ) % role % e.what();
+        }
+    }
+    if (placement.has_priority){
+        set_thread_priority_safe(placement.priority);
+    }
+}
@@ -0,0 +1,213 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/utils/trace.hpp>
+#include <uhd/utils/platform.hpp>
+#include <uhd/utils/static.hpp>
+#include <uhd/exception.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/format.hpp>
+#include <boost/atomic.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace uhd::trace;
+
+//! Number of events kept per thread, must be a power of 2
+static const size_t TRACE_RING_SIZE = 1 << 15;
+
+static const char *const EVENT_NAMES[NUM_EVENTS] = {
+    "recv",
+    "recv_get_buff",
+    "recv_unpack",
+    "recv_convert",
+    "recv_fc_send",
+    "send",
+    "send_get_buff",
+    "send_pack",
+    "send_convert",
+    "send_commit",
+    "send_fc_recv"
+};
+
+/***********************************************************************
+ * Per-thread event rings
+ **********************************************************************/
+namespace {
+
+    struct trace_entry_t{
+        uint64_t time_ns;
+        uint64_t arg;
+        uint32_t event;
+        uint32_t phase;
+    };
+
+    /*!
+     * Only the owning thread writes to a ring. The head is the number
+     * of events ever written, it is published with release semantics
+     * after the entry so the dump sees complete entries.
+     * Clearing moves the tail up instead of touching the head.
+     */
+    struct trace_ring_t{
+        trace_ring_t(const size_t tid_): tid(tid_), entries(TRACE_RING_SIZE), head(0), tail(0){}
+        const size_t tid;
+        std::vector<trace_entry_t> entries;
+        boost::atomic<uint64_t> head;
+        boost::atomic<uint64_t> tail;
+    };
+
+    //! Rings outlive their threads so that events can be dumped at exit
+    struct trace_registry_t{
+        boost::mutex mutex;
+        std::vector<boost::shared_ptr<trace_ring_t> > rings;
+    };
+
+} //namespace
+
+UHD_SINGLETON_FCN(trace_registry_t, get_registry)
+
+static thread_local trace_ring_t *thread_ring = nullptr;
+
+static trace_ring_t *register_thread_ring(void){
+    trace_registry_t &registry = get_registry();
+    boost::mutex::scoped_lock lock(registry.mutex);
+    boost::shared_ptr<trace_ring_t> ring(new trace_ring_t(registry.rings.size()));
+    registry.rings.push_back(ring);
+    return ring.get();
+}
+
+static UHD_INLINE uint64_t get_time_ns(void){
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count());
+}
+
+/***********************************************************************
+ * Trace API
+ **********************************************************************/
+bool uhd::trace::is_enabled(void){
+    #ifdef UHD_TRACE
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+std::string uhd::trace::get_event_name(const event_t event){
+    if (size_t(event) >= size_t(NUM_EVENTS)){
+        throw uhd::key_error(str(boost::format("unknown trace event %d") % int(event)));
+    }
+    return EVENT_NAMES[event];
+}
+
+void uhd::trace::record(const event_t event, const phase_t phase, const uint64_t arg){
+    trace_ring_t *ring = thread_ring;
+    if (ring == nullptr){
+        ring = thread_ring = register_thread_ring();
+    }
+    const uint64_t head = ring->head.load(boost::memory_order_relaxed);
+    trace_entry_t &entry = ring->entries[head & (TRACE_RING_SIZE - 1)];
+    entry.time_ns = get_time_ns();
+    entry.arg = arg;
+    entry.event = uint32_t(event);
+    entry.phase = uint32_t(phase);
+    ring->head.store(head + 1, boost::memory_order_release);
+}
+
+size_t uhd::trace::dump(std::ostream &os){
+    trace_registry_t &registry = get_registry();
+    boost::mutex::scoped_lock lock(registry.mutex);
+    const int32_t pid = uhd::get_process_id();
+
+    size_t num_events = 0;
+    os << "{\"traceEvents\":[";
+    for (size_t r = 0; r < registry.rings.size(); r++){
+        const trace_ring_t &ring = *registry.rings[r];
+        const uint64_t head = ring.head.load(boost::memory_order_acquire);
+        uint64_t first = ring.tail.load(boost::memory_order_relaxed);
+        if (head - first > TRACE_RING_SIZE) first = head - TRACE_RING_SIZE;
+        for (uint64_t i = first; i < head; i++){
+            const trace_entry_t &entry = ring.entries[i & (TRACE_RING_SIZE - 1)];
+            if (entry.event >= uint32_t(NUM_EVENTS)) continue;
+            os << (num_events++ == 0? "\n" : ",\n")
+               << boost::format("{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u")
+                  % EVENT_NAMES[entry.event] % char(entry.phase) % (entry.time_ns/1e3) % pid % ring.tid;
+            if (entry.phase == PHASE_INSTANT) os << ",\"s\":\"t\"";
+            if (entry.phase != PHASE_END) os << ",\"args\":{\"arg\":" << entry.arg << "}";
+            os << "}";
+        }
+    }
+    os << "\n]}\n";
+    return num_events;
+}
+
+size_t uhd::trace::dump(const std::string &path){
+    std::ofstream file(path.c_str());
+    if (not file.is_open()){
+        throw uhd::os_error("cannot open trace file " + path);
+    }
+    const size_t num_events = dump(file);
+    file.close();
+    if (file.fail()){
+        throw uhd::os_error("cannot write trace file " + path);
+    }
+    return num_events;
+}
+
+void uhd::trace::clear(void){
+    trace_registry_t &registry = get_registry();
+    boost::mutex::scoped_lock lock(registry.mutex);
+    for (size_t r = 0; r < registry.rings.size(); r++){
+        trace_ring_t &ring = *registry.rings[r];
+        ring.tail.store(ring.head.load(boost::memory_order_acquire), boost::memory_order_relaxed);
+    }
+}
+
+/***********************************************************************
+ * Dump at exit when UHD_TRACE_FILE is set
+ **********************************************************************/
+namespace {
+
+    struct trace_exit_dump_t{
+        trace_exit_dump_t(void){
+            //construct the registry first so it is destroyed after this
+            get_registry();
+            const char *path = std::getenv("UHD_TRACE_FILE");
+            if (path != NULL) _path = path;
+        }
+
+        ~trace_exit_dump_t(void){
+            if (_path.empty()) return;
+            try{
+                dump(_path);
+            }
+            catch(const std::exception &e){
+                std::cerr << "UHD: failed to dump the trace: " << e.what() << std::endl;
+            }
+        }
+
+    private:
+        std::string _path;
+    };
+
+    trace_exit_dump_t trace_exit_dump;
+
+} //namespace
@@ -0,0 +1,104 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "ad9361_device.h"
+#include <boost/make_shared.hpp>
+#include <map>
+
+using namespace uhd::usrp;
+
+/***********************************************************************
+ * A register file that reports every PLL as locked, every calibration
+ * as done and the ENSM as being in the ALERT state
+ **********************************************************************/
+class fake_ad9361_io : public ad9361_io
+{
+public:
+    fake_ad9361_io(void): num_rx_bbf_cals(0) {}
+
+    uint8_t peek8(uint32_t reg)
+    {
+        switch (reg) {
+        case 0x016: return 0x00; // calibrations done
+        case 0x017: return 0x05; // ENSM in ALERT
+        case 0x037: return 0x08; // device ID
+        case 0x00C: return 0x02; // AuxADC data valid
+        case 0x05e:
+        case 0x244:
+        case 0x284: return _regs[reg] | 0x80; // BBPLL / VCO cal done
+        case 0x247:
+        case 0x287: return _regs[reg] | 0x02; // synthesizers locked
+        default: return _regs[reg];
+        }
+    }
+
+    void poke8(uint32_t reg, uint8_t val)
+    {
+        if (reg == 0x016 and val == 0x80) num_rx_bbf_cals++;
+        _regs[reg] = val;
+    }
+
+    size_t num_rx_bbf_cals;
+
+private:
+    std::map<uint32_t, uint8_t> _regs;
+};
+
+class fake_ad9361_params : public ad9361_params
+{
+public:
+    digital_interface_delays_t get_digital_interface_timing(void)
+    {
+        digital_interface_delays_t delays = {0, 0, 0, 0};
+        return delays;
+    }
+    digital_interface_mode_t get_digital_interface_mode(void)
+    {
+        return AD9361_DDR_FDD_LVCMOS;
+    }
+    clocking_mode_t get_clocking_mode(void)
+    {
+        return clocking_mode_t::AD9361_XTAL_N_CLK_PATH;
+    }
+    double get_band_edge(frequency_band_t)
+    {
+        return 0.0;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_ad9361_bw_filter_cal_cache){
+    boost::shared_ptr<fake_ad9361_io> io = boost::make_shared<fake_ad9361_io>();
+    ad9361_device_t device(boost::make_shared<fake_ad9361_params>(), io);
+    device.initialize();
+
+    //1 MHz and 500 kHz share a BBPLL rate, but not the baseband bandwidth
+    //the filter bandwidth is clipped to
+    BOOST_CHECK_CLOSE(device.set_clock_rate(1e6), 1e6, 0.01);
+    BOOST_CHECK_CLOSE(device.set_bw_filter(ad9361_device_t::RX, 2e6), 1e6, 0.01);
+
+    BOOST_CHECK_CLOSE(device.set_clock_rate(0.5e6), 0.5e6, 0.01);
+    const size_t num_cals = io->num_rx_bbf_cals;
+    BOOST_CHECK_CLOSE(device.set_bw_filter(ad9361_device_t::RX, 2e6), 0.5e6, 0.01);
+    BOOST_CHECK_EQUAL(io->num_rx_bbf_cals, num_cals + 1);
+
+    //switching back reuses the calibrations of the first rate
+    BOOST_CHECK_CLOSE(device.set_clock_rate(1e6), 1e6, 0.01);
+    const size_t num_cals_back = io->num_rx_bbf_cals;
+    BOOST_CHECK_CLOSE(device.set_bw_filter(ad9361_device_t::RX, 2e6), 1e6, 0.01);
+    BOOST_CHECK_EQUAL(io->num_rx_bbf_cals, num_cals_back);
+}
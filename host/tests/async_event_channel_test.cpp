@@ -0,0 +1,159 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "../lib/transport/async_event_channel.hpp"
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace uhd;
+using namespace uhd::transport;
+
+static const double timeout = 0.01/*secs*/;
+
+static async_metadata_t make_md(const size_t channel, const uint32_t count){
+    async_metadata_t md;
+    md.channel = channel;
+    md.has_time_spec = false;
+    md.event_code = async_metadata_t::EVENT_CODE_BURST_ACK;
+    md.user_payload[0] = count;
+    return md;
+}
+
+static void push_n(async_event_channel::sptr channel, const size_t producer, const size_t n){
+    for (size_t i = 0; i < n; i++){
+        channel->push(make_md(producer, uint32_t(i)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_async_event_channel_fifo){
+    async_event_channel::sptr channel = async_event_channel::make(3);
+
+    //capacity is rounded up to 4, then the oldest messages are dropped
+    for (size_t i = 0; i < 6; i++){
+        BOOST_CHECK(channel->push(make_md(0, uint32_t(i))));
+    }
+    BOOST_CHECK_EQUAL(channel->get_num_dropped(), 2UL);
+
+    async_metadata_t md;
+    for (size_t i = 2; i < 6; i++){
+        BOOST_REQUIRE(channel->pop_with_timed_wait(md, timeout));
+        BOOST_CHECK_EQUAL(md.user_payload[0], i);
+    }
+    BOOST_CHECK(not channel->pop(md));
+    BOOST_CHECK(not channel->pop_with_timed_wait(md, timeout));
+
+    //the ring wraps around
+    for (size_t i = 0; i < 10; i++){
+        BOOST_CHECK(channel->push(make_md(0, uint32_t(i))));
+        BOOST_REQUIRE(channel->pop(md));
+        BOOST_CHECK_EQUAL(md.user_payload[0], i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_async_event_channel_multi_producer){
+    static const size_t NUM_PRODUCERS = 4;
+    static const size_t NUM_MSGS = 10000;
+    async_event_channel::sptr channel = async_event_channel::make(64);
+
+    boost::thread_group producers;
+    for (size_t p = 0; p < NUM_PRODUCERS; p++){
+        producers.create_thread(boost::bind(&push_n, channel, p, NUM_MSGS));
+    }
+
+    //every producer's messages arrive in order, and every message
+    //either arrives or is counted as dropped
+    std::vector<uint32_t> next(NUM_PRODUCERS, 0);
+    size_t num_popped = 0;
+    async_metadata_t md;
+    while (num_popped + channel->get_num_dropped() < NUM_PRODUCERS*NUM_MSGS){
+        if (not channel->pop_with_timed_wait(md, 1.0)) break;
+        BOOST_REQUIRE(md.channel < NUM_PRODUCERS);
+        BOOST_CHECK_GE(md.user_payload[0], next[md.channel]);
+        next[md.channel] = md.user_payload[0] + 1;
+        num_popped++;
+    }
+    producers.join_all();
+    while (channel->pop(md)) num_popped++;
+    BOOST_CHECK_EQUAL(num_popped + channel->get_num_dropped(), NUM_PRODUCERS*NUM_MSGS);
+}
+
+static void count_md(size_t *count, const async_metadata_t &){
+    (*count)++;
+}
+
+BOOST_AUTO_TEST_CASE(test_async_event_channel_callback){
+    async_event_channel::sptr channel = async_event_channel::make(4);
+    size_t count = 0;
+    channel->set_callback(boost::bind(&count_md, &count, _1));
+
+    //the callback gets the messages, nothing is queued
+    for (size_t i = 0; i < 10; i++){
+        BOOST_CHECK(channel->push(make_md(0, uint32_t(i))));
+    }
+    BOOST_CHECK_EQUAL(count, 10UL);
+    async_metadata_t md;
+    BOOST_CHECK(not channel->pop(md));
+
+    //back to queueing
+    channel->set_callback(async_event_channel::callback_type());
+    BOOST_CHECK(channel->push(make_md(0, 10)));
+    BOOST_CHECK_EQUAL(count, 10UL);
+    BOOST_CHECK(channel->pop(md));
+}
+
+#ifdef __linux__
+static bool fd_readable(const int fd){
+    pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return ::poll(&pfd, 1, 0) == 1 and (pfd.revents & POLLIN);
+}
+
+BOOST_AUTO_TEST_CASE(test_async_event_channel_fd){
+    async_event_channel::sptr channel = async_event_channel::make(4);
+    const int fd = channel->get_fd();
+    if (fd < 0) return; //not built with eventfd
+    BOOST_CHECK_EQUAL(channel->get_fd(), fd);
+
+    //clear the initial event
+    uint64_t val;
+    BOOST_CHECK(fd_readable(fd));
+    BOOST_CHECK_EQUAL(::read(fd, &val, sizeof(val)), ssize_t(sizeof(val)));
+    BOOST_CHECK(not fd_readable(fd));
+
+    //a push makes it readable
+    channel->push(make_md(0, 0));
+    channel->push(make_md(0, 1));
+    BOOST_CHECK(fd_readable(fd));
+    BOOST_CHECK_EQUAL(::read(fd, &val, sizeof(val)), ssize_t(sizeof(val)));
+    BOOST_CHECK_EQUAL(val, 2UL);
+    BOOST_CHECK(not fd_readable(fd));
+
+    async_metadata_t md;
+    BOOST_CHECK(channel->pop(md));
+    BOOST_CHECK(channel->pop(md));
+    BOOST_CHECK(not channel->pop(md));
+}
+#endif
@@ -16,9 +16,11 @@
 //
 
 #include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
 #include <boost/test/unit_test.hpp>
 #include <stdint.h>
 #include <boost/assign/list_of.hpp>
+#include <algorithm>
 #include <complex>
 #include <vector>
 #include <cstdlib>
@@ -415,6 +417,44 @@ BOOST_AUTO_TEST_CASE(test_convert_types_sc16_and_sc8){
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_convert_sc16_to_sc8_best_vs_table){
+    convert::id_type id;
+    id.input_format = "sc16";
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    //every in-range input value, plus an odd sample to hit the remainder
+    const size_t nsamps = 32001;
+    std::vector<sc16_t> input(nsamps);
+    for (size_t i = 0; i < nsamps; i++){
+        input[i] = sc16_t(int16_t(i) - 16000, 16000 - int16_t(i));
+    }
+    std::vector<uint32_t> out_best(nsamps/2 + 1), out_table(nsamps/2 + 1);
+    std::vector<const void *> input0(1, &input[0]);
+    std::vector<void *> output0(1, &out_best[0]), output1(1, &out_table[0]);
+
+    const std::vector<std::string> formats = boost::assign::list_of
+        ("sc8_item32_le")("sc8_item32_be");
+    const std::vector<double> scalars = boost::assign::list_of
+        (32767./256)(32767./128)(100.);
+    for(const std::string &format:  formats){
+        id.output_format = format;
+        for(const double scalar:  scalars){
+            //the table converters are registered with priority 1
+            convert::converter::sptr c0 = convert::get_converter(id)();
+            convert::converter::sptr c1 = convert::get_converter(id, 1)();
+            c0->set_scalar(scalar);
+            c1->set_scalar(scalar);
+            c0->conv(input0, output0, nsamps);
+            c1->conv(input0, output1, nsamps);
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                out_best.begin(), out_best.end(),
+                out_table.begin(), out_table.end()
+            );
+        }
+    }
+}
+
 /***********************************************************************
  * Test u8 conversion
  **********************************************************************/
@@ -609,3 +649,30 @@ BOOST_AUTO_TEST_CASE(test_convert_types_f32_and_f32){
         test_convert_types_f32(nsamps, id);
     }
 }
+
+/***********************************************************************
+ * Test the converter registry queries
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_convert_registry_queries){
+    convert::id_type id;
+    id.input_format = "sc16";
+    id.num_inputs = 1;
+    id.output_format = "sc16_item32_le";
+    id.num_outputs = 1;
+
+    const std::vector<convert::id_type> ids = convert::get_converter_ids();
+    BOOST_CHECK(std::find(ids.begin(), ids.end(), id) != ids.end());
+
+    for(const convert::id_type &conv_id:  ids){
+        const std::vector<convert::priority_type> prios =
+            convert::get_converter_priorities(conv_id);
+        BOOST_REQUIRE(not prios.empty());
+        for (size_t i = 1; i < prios.size(); i++){
+            BOOST_CHECK(prios[i-1] < prios[i]);
+        }
+        BOOST_CHECK(convert::get_converter(conv_id, prios.back())());
+    }
+
+    id.output_format = "does_not_exist";
+    BOOST_CHECK_THROW(convert::get_converter_priorities(id), uhd::key_error);
+}
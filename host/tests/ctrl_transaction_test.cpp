@@ -0,0 +1,337 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "../lib/rfnoc/ctrl_iface.hpp"
+#include <uhd/rfnoc/ctrl_transaction.hpp>
+#include <uhd/rfnoc/constants.hpp>
+#include <uhd/transport/chdr.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/exception.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/make_shared.hpp>
+#include <deque>
+#include <vector>
+
+using namespace uhd;
+using namespace uhd::rfnoc;
+using namespace uhd::transport;
+
+// Records all accesses, readbacks return twice the address
+class recording_wb_iface : public wb_iface
+{
+public:
+    typedef boost::shared_ptr<recording_wb_iface> sptr;
+
+    void poke32(const wb_addr_type addr, const uint32_t data) {
+        log.push_back(std::make_pair(addr, uint64_t(data)));
+    }
+
+    uint64_t peek64(const wb_addr_type addr) {
+        log.push_back(std::make_pair(addr, uint64_t(-1)));
+        return addr * 2;
+    }
+
+    std::vector< std::pair<wb_addr_type, uint64_t> > log;
+};
+
+BOOST_AUTO_TEST_CASE(test_ctrl_transaction)
+{
+    recording_wb_iface::sptr iface0 = boost::make_shared<recording_wb_iface>();
+    recording_wb_iface::sptr iface1 = boost::make_shared<recording_wb_iface>();
+    ctrl_transaction::sptr t = ctrl_transaction::make();
+
+    t->add_poke32(iface0, 0x10, 1);
+    BOOST_CHECK_EQUAL(t->add_peek64(iface1, 0x100), 0);
+    BOOST_CHECK_EQUAL(t->add_peek64(iface0, 0x20), 1);
+    t->add_poke32(iface1, 0x110, 2);
+    BOOST_CHECK_EQUAL(t->add_peek64(iface0, 0x30), 2);
+    BOOST_CHECK_EQUAL(t->size(), 5);
+    BOOST_CHECK(iface0->log.empty());
+
+    // Readbacks come back in the order they were added
+    std::vector<uint64_t> results = t->execute();
+    BOOST_REQUIRE_EQUAL(results.size(), 3);
+    BOOST_CHECK_EQUAL(results[0], 0x200);
+    BOOST_CHECK_EQUAL(results[1], 0x40);
+    BOOST_CHECK_EQUAL(results[2], 0x60);
+
+    // Each interface sees its commands in order
+    BOOST_REQUIRE_EQUAL(iface0->log.size(), 3);
+    BOOST_CHECK_EQUAL(iface0->log[0].first, 0x10);
+    BOOST_CHECK_EQUAL(iface0->log[0].second, 1);
+    BOOST_CHECK_EQUAL(iface0->log[1].first, 0x20);
+    BOOST_CHECK_EQUAL(iface0->log[2].first, 0x30);
+    BOOST_REQUIRE_EQUAL(iface1->log.size(), 2);
+    BOOST_CHECK_EQUAL(iface1->log[0].first, 0x100);
+    BOOST_CHECK_EQUAL(iface1->log[1].first, 0x110);
+    BOOST_CHECK_EQUAL(iface1->log[1].second, 2);
+
+    // The transaction is empty again
+    BOOST_CHECK_EQUAL(t->size(), 0);
+    BOOST_CHECK(t->execute().empty());
+    BOOST_CHECK_EQUAL(t->add_peek64(iface1, 0x8), 0);
+    BOOST_CHECK_EQUAL(t->execute().at(0), 0x10);
+}
+
+BOOST_AUTO_TEST_CASE(test_ctrl_transaction_errors)
+{
+    ctrl_transaction::sptr t = ctrl_transaction::make();
+    BOOST_CHECK_THROW(t->add_poke32(wb_iface::sptr(), 0, 0), uhd::value_error);
+
+    // Plain interfaces cannot do timed commands
+    t->add_poke32(boost::make_shared<recording_wb_iface>(), 0x10, 1);
+    t->set_command_time(time_spec_t(1.0));
+    BOOST_CHECK_THROW(t->execute(), uhd::assertion_error);
+}
+
+/***********************************************************************
+ * A loopback transport that answers every control packet like a block,
+ * readbacks return twice the address
+ **********************************************************************/
+class loopback_ctrl_xport : public zero_copy_if
+{
+public:
+    typedef boost::shared_ptr<loopback_ctrl_xport> sptr;
+
+    loopback_ctrl_xport(void) : fail_send(false), _msb(this) {}
+
+    managed_recv_buffer::sptr get_recv_buff(double)
+    {
+        if (_resps.empty()) return managed_recv_buffer::sptr();
+        _recv_mem = _resps.front();
+        _resps.pop_front();
+        return _mrb.make(&_mrb, &_recv_mem.front(), _recv_mem.size()*sizeof(uint32_t));
+    }
+
+    size_t get_num_recv_frames(void) const { return 8; }
+    size_t get_recv_frame_size(void) const { return sizeof(_send_mem); }
+
+    managed_send_buffer::sptr get_send_buff(double)
+    {
+        if (fail_send) return managed_send_buffer::sptr();
+        return _msb.make(&_msb, _send_mem, sizeof(_send_mem));
+    }
+
+    size_t get_num_send_frames(void) const { return 1; }
+    size_t get_send_frame_size(void) const { return sizeof(_send_mem); }
+
+    //! The header of every packet sent, and its payload (address, data)
+    std::vector<vrt::if_packet_info_t> log;
+    std::vector<std::pair<uint32_t, uint32_t> > payloads;
+    //! Makes get_send_buff() time out
+    bool fail_send;
+
+private:
+    struct loopback_msb : managed_send_buffer
+    {
+        loopback_msb(loopback_ctrl_xport *xport) : _xport(xport) {}
+        void release(void) { _xport->respond(size()); }
+        loopback_ctrl_xport *_xport;
+    };
+
+    struct loopback_mrb : managed_recv_buffer
+    {
+        void release(void) {}
+    };
+
+    void respond(const size_t num_bytes)
+    {
+        vrt::if_packet_info_t info;
+        info.link_type = vrt::if_packet_info_t::LINK_TYPE_CHDR;
+        info.num_packet_words32 = num_bytes/sizeof(uint32_t);
+        vrt::chdr::if_hdr_unpack_le(_send_mem, info);
+        const uint32_t addr = uhd::wtohx(_send_mem[info.num_header_words32+0]);
+        const uint32_t data = uhd::wtohx(_send_mem[info.num_header_words32+1]);
+        log.push_back(info);
+        payloads.push_back(std::make_pair(addr, data));
+
+        const uint64_t value = (addr == SR_READBACK)? uint64_t(data)*8*2 : 0;
+        vrt::if_packet_info_t resp;
+        resp.link_type = vrt::if_packet_info_t::LINK_TYPE_CHDR;
+        resp.packet_type = vrt::if_packet_info_t::PACKET_TYPE_RESP;
+        resp.num_payload_words32 = 2;
+        resp.num_payload_bytes = 2*sizeof(uint32_t);
+        resp.packet_count = info.packet_count;
+        resp.sob = false;
+        resp.eob = false;
+        resp.sid = (info.sid >> 16) | (info.sid << 16);
+        resp.has_sid = true;
+        resp.has_cid = false;
+        resp.has_tsi = false;
+        resp.has_tsf = false;
+        resp.has_tlr = false;
+        std::vector<uint32_t> pkt(8);
+        vrt::chdr::if_hdr_pack_le(&pkt.front(), resp);
+        pkt[resp.num_header_words32+0] = uhd::htowx(uint32_t(value >> 32));
+        pkt[resp.num_header_words32+1] = uhd::htowx(uint32_t(value & 0xffffffff));
+        pkt.resize(resp.num_packet_words32);
+        _resps.push_back(pkt);
+    }
+
+    uint32_t _send_mem[8];
+    std::vector<uint32_t> _recv_mem;
+    std::deque<std::vector<uint32_t> > _resps;
+    loopback_msb _msb;
+    loopback_mrb _mrb;
+};
+
+// Forwards to a real ctrl_iface, counts the readbacks it keeps for batches
+class counting_ctrl_iface : public ctrl_iface
+{
+public:
+    typedef boost::shared_ptr<counting_ctrl_iface> sptr;
+
+    counting_ctrl_iface(loopback_ctrl_xport::sptr xport_) :
+        xport(xport_),
+        num_pending(0),
+        _ctrl(ctrl_iface::make(false, xport_, xport_, 0x00100200))
+    {}
+
+    void poke32(const wb_addr_type addr, const uint32_t data) { _ctrl->poke32(addr, data); }
+    uint32_t peek32(const wb_addr_type addr) { return _ctrl->peek32(addr); }
+    uint64_t peek64(const wb_addr_type addr) { return _ctrl->peek64(addr); }
+    void set_time(const time_spec_t &t) { _ctrl->set_time(t); }
+    time_spec_t get_time(void) { return _ctrl->get_time(); }
+    void set_tick_rate(const double rate) { _ctrl->set_tick_rate(rate); }
+
+    void send_batch(std::vector<batch_op_t> &ops)
+    {
+        _ctrl->send_batch(ops);
+        num_pending += count_readbacks(ops);
+    }
+
+    void recv_batch(std::vector<batch_op_t> &ops)
+    {
+        num_pending -= count_readbacks(ops);
+        _ctrl->recv_batch(ops);
+    }
+
+    void cancel_batch(const std::vector<batch_op_t> &ops)
+    {
+        num_pending -= count_readbacks(ops);
+        _ctrl->cancel_batch(ops);
+    }
+
+    loopback_ctrl_xport::sptr xport;
+    size_t num_pending;
+
+private:
+    static size_t count_readbacks(const std::vector<batch_op_t> &ops)
+    {
+        size_t n = 0;
+        for(const batch_op_t &op:  ops) n += op.readback? 1 : 0;
+        return n;
+    }
+
+    ctrl_iface::sptr _ctrl;
+};
+
+BOOST_AUTO_TEST_CASE(test_ctrl_transaction_ctrl_iface)
+{
+    counting_ctrl_iface::sptr iface0 = boost::make_shared<counting_ctrl_iface>(boost::make_shared<loopback_ctrl_xport>());
+    counting_ctrl_iface::sptr iface1 = boost::make_shared<counting_ctrl_iface>(boost::make_shared<loopback_ctrl_xport>());
+    iface0->xport->log.clear();
+    iface0->xport->payloads.clear();
+    iface1->xport->log.clear();
+    iface1->xport->payloads.clear();
+    ctrl_transaction::sptr t = ctrl_transaction::make();
+
+    // More readbacks than the response queue holds
+    static const size_t NUM_PEEKS = 20;
+    for (size_t i = 0; i < NUM_PEEKS; i++) {
+        t->add_poke32(iface0, 0x10, uint32_t(i));
+        BOOST_CHECK_EQUAL(t->add_peek64(iface0, 8*(i+1)), 2*i);
+        BOOST_CHECK_EQUAL(t->add_peek64(iface1, 8*(i+100)), 2*i+1);
+    }
+    t->set_command_time(time_spec_t(2.0));
+    const std::vector<uint64_t> results = t->execute();
+    BOOST_REQUIRE_EQUAL(results.size(), 2*NUM_PEEKS);
+    for (size_t i = 0; i < NUM_PEEKS; i++) {
+        BOOST_CHECK_EQUAL(results[2*i], 16*(i+1));
+        BOOST_CHECK_EQUAL(results[2*i+1], 16*(i+100));
+    }
+    BOOST_CHECK_EQUAL(iface0->num_pending, 0);
+    BOOST_CHECK_EQUAL(iface1->num_pending, 0);
+
+    // The commands went out in order, with the command time
+    BOOST_REQUIRE_EQUAL(iface0->xport->payloads.size(), 2*NUM_PEEKS);
+    for (size_t i = 0; i < NUM_PEEKS; i++) {
+        BOOST_CHECK_EQUAL(iface0->xport->payloads[2*i].first, 0x10/4);
+        BOOST_CHECK_EQUAL(iface0->xport->payloads[2*i].second, i);
+        BOOST_CHECK_EQUAL(iface0->xport->payloads[2*i+1].first, SR_READBACK);
+        BOOST_CHECK_EQUAL(iface0->xport->payloads[2*i+1].second, i+1);
+    }
+    for(const vrt::if_packet_info_t &info:  iface0->xport->log) {
+        BOOST_CHECK(info.has_tsf);
+        BOOST_CHECK_EQUAL(info.tsf, 2);
+    }
+    // and the interfaces went back to untimed commands
+    BOOST_CHECK(iface0->get_time() == time_spec_t(0.0));
+    BOOST_CHECK(iface1->get_time() == time_spec_t(0.0));
+    BOOST_CHECK_EQUAL(iface0->peek64(0x40), 0x80);
+    BOOST_CHECK(not iface0->xport->log.back().has_tsf);
+}
+
+BOOST_AUTO_TEST_CASE(test_ctrl_transaction_ctrl_iface_errors)
+{
+    counting_ctrl_iface::sptr iface0 = boost::make_shared<counting_ctrl_iface>(boost::make_shared<loopback_ctrl_xport>());
+    counting_ctrl_iface::sptr iface1 = boost::make_shared<counting_ctrl_iface>(boost::make_shared<loopback_ctrl_xport>());
+    ctrl_transaction::sptr t = ctrl_transaction::make();
+
+    // Sending to the second interface fails after the first got its batch
+    t->add_peek64(iface0, 0x8);
+    t->add_peek64(iface0, 0x10);
+    t->add_peek64(iface1, 0x18);
+    t->set_command_time(time_spec_t(1.0));
+    iface1->xport->fail_send = true;
+    BOOST_CHECK_THROW(t->execute(), uhd::io_error);
+    BOOST_CHECK_EQUAL(iface0->num_pending, 0);
+    BOOST_CHECK_EQUAL(iface1->num_pending, 0);
+    BOOST_CHECK(iface1->get_time() == time_spec_t(0.0));
+    BOOST_CHECK_EQUAL(t->size(), 0);
+
+    // Both interfaces still work afterwards
+    iface1->xport->fail_send = false;
+    BOOST_CHECK_EQUAL(t->add_peek64(iface1, 0x20), 0);
+    BOOST_CHECK_EQUAL(t->add_peek64(iface0, 0x28), 1);
+    const std::vector<uint64_t> results = t->execute();
+    BOOST_REQUIRE_EQUAL(results.size(), 2);
+    BOOST_CHECK_EQUAL(results[0], 0x40);
+    BOOST_CHECK_EQUAL(results[1], 0x50);
+    BOOST_CHECK_EQUAL(iface0->peek64(0x30), 0x60);
+    BOOST_CHECK_EQUAL(iface1->peek64(0x38), 0x70);
+
+    // A timed transaction with a plain interface is rejected before
+    // anything is sent to the interfaces that support it
+    recording_wb_iface::sptr plain = boost::make_shared<recording_wb_iface>();
+    const size_t num_sent = iface0->xport->log.size();
+    t->add_peek64(iface0, 0x8);
+    t->add_poke32(plain, 0x10, 1);
+    t->set_command_time(time_spec_t(1.0));
+    BOOST_CHECK_THROW(t->execute(), uhd::assertion_error);
+    BOOST_CHECK_EQUAL(iface0->xport->log.size(), num_sent);
+    BOOST_CHECK_EQUAL(iface0->num_pending, 0);
+    BOOST_CHECK(plain->log.empty());
+    BOOST_CHECK_EQUAL(t->size(), 0);
+
+    // and the command time does not stick to the next transaction
+    t->add_peek64(iface0, 0x8);
+    t->add_poke32(plain, 0x10, 1);
+    BOOST_CHECK_NO_THROW(t->execute());
+    BOOST_CHECK(not iface0->xport->log.back().has_tsf);
+    BOOST_CHECK_EQUAL(plain->log.size(), 1);
+}
@@ -0,0 +1,103 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "../lib/usrp/e300/e300_network_batch.hpp"
+#include <uhd/types/time_spec.hpp>
+#include <boost/format.hpp>
+#include <vector>
+
+using namespace uhd::usrp::e300;
+namespace asio = boost::asio;
+
+static const size_t DATAGRAM_SIZE = 1024;
+static const size_t NUM_BATCHES = 2000;
+
+BOOST_AUTO_TEST_CASE(test_e300_network_batch_loopback){
+    asio::io_service io_service;
+    asio::ip::udp::socket recver(io_service,
+        asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0));
+    asio::ip::udp::socket sender(io_service,
+        asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0));
+    asio::ip::udp::endpoint recver_ep = recver.local_endpoint();
+
+    std::vector<char> send_mem(E300_NETWORK_BATCH_SIZE*DATAGRAM_SIZE);
+    std::vector<char> recv_mem(E300_NETWORK_BATCH_SIZE*DATAGRAM_SIZE);
+    std::vector<asio::ip::udp::endpoint> recv_eps(E300_NETWORK_BATCH_SIZE);
+    std::vector<iovec> send_iovs(E300_NETWORK_BATCH_SIZE), recv_iovs(E300_NETWORK_BATCH_SIZE);
+    std::vector<tunnel_msg_t> send_msgs(E300_NETWORK_BATCH_SIZE), recv_msgs(E300_NETWORK_BATCH_SIZE);
+
+    //nothing is queued yet, so receiving returns at once
+    init_tunnel_msg(recv_msgs[0], recv_iovs[0], &recv_mem.front(), DATAGRAM_SIZE,
+        recv_eps[0], recv_eps[0].capacity());
+    BOOST_CHECK_EQUAL(recv_batch(recver.native_handle(), &recv_msgs.front(), 1), 0UL);
+
+    size_t num_recv_calls = 0;
+    double num_bytes = 0;
+    const uhd::time_spec_t start = uhd::time_spec_t::get_system_time();
+    for (size_t batch = 0; batch < NUM_BATCHES; batch++){
+        //every datagram carries its sequence number and its size differs
+        for (size_t i = 0; i < E300_NETWORK_BATCH_SIZE; i++){
+            const uint32_t seq = uint32_t(batch*E300_NETWORK_BATCH_SIZE + i);
+            char *mem = &send_mem[i*DATAGRAM_SIZE];
+            std::memcpy(mem, &seq, sizeof(seq));
+            init_tunnel_msg(send_msgs[i], send_iovs[i], mem, DATAGRAM_SIZE - i,
+                recver_ep, recver_ep.size());
+        }
+        send_batch(sender.native_handle(), &send_msgs.front(), E300_NETWORK_BATCH_SIZE);
+
+        size_t num_recvd = 0;
+        while (num_recvd < E300_NETWORK_BATCH_SIZE){
+            for (size_t i = num_recvd; i < E300_NETWORK_BATCH_SIZE; i++){
+                init_tunnel_msg(recv_msgs[i], recv_iovs[i], &recv_mem[i*DATAGRAM_SIZE], DATAGRAM_SIZE,
+                    recv_eps[i], recv_eps[i].capacity());
+            }
+            const size_t num_msgs = recv_batch(recver.native_handle(),
+                &recv_msgs[num_recvd], E300_NETWORK_BATCH_SIZE - num_recvd);
+            num_recv_calls++;
+            if (num_msgs == 0){
+                BOOST_REQUIRE(wait_for_recv_ready(recver.native_handle(), 100));
+                continue;
+            }
+            num_recvd += num_msgs;
+        }
+
+        for (size_t i = 0; i < E300_NETWORK_BATCH_SIZE; i++){
+            uint32_t seq = 0;
+            std::memcpy(&seq, &recv_mem[i*DATAGRAM_SIZE], sizeof(seq));
+            BOOST_REQUIRE_EQUAL(seq, uint32_t(batch*E300_NETWORK_BATCH_SIZE + i));
+            BOOST_REQUIRE_EQUAL(recv_msgs[i].msg_len, DATAGRAM_SIZE - i);
+            num_bytes += recv_msgs[i].msg_len;
+        }
+    }
+    const double elapsed = (uhd::time_spec_t::get_system_time() - start).get_real_secs();
+
+    //the source of the last datagram is the sending socket
+    asio::ip::udp::endpoint &last = recv_eps[E300_NETWORK_BATCH_SIZE-1];
+    last.resize(recv_msgs[E300_NETWORK_BATCH_SIZE-1].msg_hdr.msg_namelen);
+    BOOST_CHECK(last == sender.local_endpoint());
+
+    //loopback delivers a whole batch before the send call returns
+#ifdef HAVE_SENDMMSG
+    BOOST_CHECK_EQUAL(num_recv_calls, NUM_BATCHES);
+#else
+    BOOST_CHECK_EQUAL(num_recv_calls, NUM_BATCHES*E300_NETWORK_BATCH_SIZE);
+#endif
+
+    BOOST_TEST_MESSAGE(boost::format("%u datagrams in %.3f s, %.1f MB/s")
+        % (NUM_BATCHES*E300_NETWORK_BATCH_SIZE) % elapsed % (num_bytes/elapsed/1e6));
+}
@@ -0,0 +1,73 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "../lib/transport/event_fd.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#endif
+
+using namespace uhd::transport;
+
+#ifdef __linux__
+static bool fd_readable(const int fd){
+    pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return ::poll(&pfd, 1, 0) == 1 and (pfd.revents & POLLIN);
+}
+
+BOOST_AUTO_TEST_CASE(test_event_fd){
+    event_fd::sptr event = event_fd::make();
+    const int fd = event->get_fd();
+    if (fd < 0) return; //not built with eventfd
+
+    BOOST_CHECK(not fd_readable(fd));
+    event->signal();
+    event->signal();
+    BOOST_CHECK(fd_readable(fd));
+    event->clear();
+    BOOST_CHECK(not fd_readable(fd));
+
+    //clearing twice is harmless
+    event->clear();
+    BOOST_CHECK(not fd_readable(fd));
+}
+
+BOOST_AUTO_TEST_CASE(test_event_fd_set){
+    event_fd::sptr event0 = event_fd::make();
+    event_fd::sptr event1 = event_fd::make();
+    event_fd_set::sptr set = event_fd_set::make();
+    if (event0->get_fd() < 0 or set->get_fd() < 0) return; //not built with eventfd and epoll
+
+    BOOST_CHECK(set->add(event0->get_fd()));
+    BOOST_CHECK(set->add(event1->get_fd()));
+    BOOST_CHECK(not set->add(-1));
+    BOOST_CHECK(not fd_readable(set->get_fd()));
+
+    //the set is ready while any of its descriptors is
+    event1->signal();
+    BOOST_CHECK(fd_readable(set->get_fd()));
+    event0->signal();
+    event1->clear();
+    BOOST_CHECK(fd_readable(set->get_fd()));
+    event0->clear();
+    BOOST_CHECK(not fd_readable(set->get_fd()));
+}
+#endif
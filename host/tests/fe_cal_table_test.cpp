@@ -0,0 +1,130 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "../lib/cal/fe_cal_table.hpp"
+#include <uhd/exception.hpp>
+#include <boost/filesystem.hpp>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+using namespace uhd::cal;
+namespace fs = boost::filesystem;
+
+static const double eps = 1e-8;
+
+static const std::string cal_csv =
+    "name, RX Frontend Calibration\n"
+    "serial, F00000\n"
+    "timestamp, 1500000000\n"
+    "version, 0, 1\n"
+    "DATA STARTS HERE\n"
+    "lo_frequency, correction_real, correction_imag, measured, delta\n"
+    "2e9, 0.3, -0.3, 0, 0\n"
+    "1e9, 0.1, -0.1, 0, 0\n"
+    "3e9, 0.5, 0.5, 0, 0\n"
+;
+
+static void check_table(fe_cal_table::sptr table){
+    BOOST_REQUIRE_EQUAL(table->size(), 3);
+
+    //points and the area around them
+    BOOST_CHECK_CLOSE(table->get(1e9).real(), 0.1, eps);
+    BOOST_CHECK_CLOSE(table->get(2e9 + 0.05).imag(), -0.3, eps);
+    BOOST_CHECK_CLOSE(table->get(3e9 - 0.05).real(), 0.5, eps);
+
+    //outside of the table
+    BOOST_CHECK_CLOSE(table->get(0.5e9).imag(), -0.1, eps);
+    BOOST_CHECK_CLOSE(table->get(4e9).imag(), 0.5, eps);
+
+    //interpolated
+    BOOST_CHECK_CLOSE(table->get(1.5e9).real(), 0.2, eps);
+    BOOST_CHECK_CLOSE(table->get(2.5e9).real(), 0.4, eps);
+    BOOST_CHECK_CLOSE(table->get(2.5e9).imag(), 0.1, eps);
+}
+
+BOOST_AUTO_TEST_CASE(test_fe_cal_table_csv){
+    std::istringstream cal_data(cal_csv);
+    check_table(fe_cal_table::from_csv(cal_data));
+
+    std::istringstream no_data("name, RX Frontend Calibration\n");
+    BOOST_CHECK_THROW(fe_cal_table::from_csv(no_data), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_fe_cal_table_binary){
+    std::istringstream cal_data(cal_csv);
+    std::stringstream bin_data;
+    fe_cal_table::from_csv(cal_data)->to_binary(bin_data);
+    check_table(fe_cal_table::from_binary(bin_data));
+
+    //anything else is rejected
+    std::istringstream bad_data(cal_csv);
+    BOOST_CHECK_THROW(fe_cal_table::from_binary(bad_data), uhd::value_error);
+    std::string truncated = bin_data.str();
+    truncated.resize(truncated.size() - 1);
+    std::istringstream truncated_data(truncated);
+    BOOST_CHECK_THROW(fe_cal_table::from_binary(truncated_data), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_fe_cal_table_load){
+    const fs::path dir = fs::temp_directory_path() / fs::unique_path("uhd_fe_cal_%%%%%%%%");
+    fs::create_directories(dir);
+    const fs::path csv_path = dir / "rx_iq_cal_v0.2_F00000.csv";
+    const fs::path bin_path = dir / "rx_iq_cal_v0.2_F00000.bin";
+
+    BOOST_CHECK(not fe_cal_table::load(csv_path.string()));
+
+    std::ofstream(csv_path.string().c_str()) << cal_csv;
+    fe_cal_table::sptr table = fe_cal_table::load(csv_path.string());
+    BOOST_REQUIRE(table);
+    check_table(table);
+    BOOST_CHECK(fs::exists(bin_path));
+
+    //the same table is shared while the file is unchanged
+    BOOST_CHECK(fe_cal_table::load(csv_path.string()) == table);
+
+    //a rewrite of the same size (and likely in the same second) is noticed
+    std::string new_csv = cal_csv;
+    new_csv.replace(new_csv.find("0.5, 0.5"), 8, "0.7, 0.7");
+    std::ofstream(csv_path.string().c_str()) << new_csv;
+    fe_cal_table::sptr new_table = fe_cal_table::load(csv_path.string());
+    BOOST_REQUIRE(new_table);
+    BOOST_CHECK(new_table != table);
+    BOOST_CHECK_CLOSE(new_table->get(3e9).real(), 0.7, eps);
+
+    //also by a new process, which only has the binary copy
+    std::ifstream bin_data(bin_path.string().c_str(), std::ifstream::binary);
+    bin_data.seekg(16); //past the stamp of the CSV file
+    BOOST_CHECK_CLOSE(fe_cal_table::from_binary(bin_data)->get(3e9).real(), 0.7, eps);
+
+    //a file that was last written before it was loaded is not read again
+    //while its size and modification time stay the same
+    const std::time_t mtime = fs::last_write_time(csv_path) - 10;
+    fs::last_write_time(csv_path, mtime);
+    table = fe_cal_table::load(csv_path.string());
+    std::ofstream(csv_path.string().c_str()) << cal_csv;
+    fs::last_write_time(csv_path, mtime);
+    BOOST_CHECK(fe_cal_table::load(csv_path.string()) == table);
+    fs::last_write_time(csv_path, mtime + 1);
+    new_table = fe_cal_table::load(csv_path.string());
+    BOOST_REQUIRE(new_table);
+    BOOST_CHECK(new_table != table);
+    BOOST_CHECK_CLOSE(new_table->get(3e9).real(), 0.5, eps);
+
+    fs::remove_all(dir);
+}
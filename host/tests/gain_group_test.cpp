@@ -19,6 +19,8 @@
 #include <uhd/utils/gain_group.hpp>
 #include <boost/bind.hpp>
 #include <boost/math/special_functions/round.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 #include <iostream>
 
 #define rint(x) boost::math::iround(x)
@@ -120,3 +122,117 @@ BOOST_AUTO_TEST_CASE(test_gain_group_priority){
     //test the the higher priority gain got filled first (gain 2)
     BOOST_CHECK_CLOSE(g2.get_value(), g2.get_range().stop(), tolerance);
 }
+
+BOOST_AUTO_TEST_CASE(test_gain_group_table){
+    gain_group::sptr gg = get_gain_group(0, 1);
+    gg->set_value(0);
+
+    //repeated settings (looked up) match the first setting of a new group
+    //(computed), on and off the steps of the overall range
+    for (int i = -220; i <= 1020; i += 7){
+        const double gain = i/10.0 + ((i % 2)? 0.05 : 0.0);
+        get_gain_group(0, 1)->set_value(gain);
+        const double g1_value = g1.get_value(), g2_value = g2.get_value();
+        gg->set_value(gain);
+        BOOST_CHECK_CLOSE(g1.get_value(), g1_value, tolerance);
+        BOOST_CHECK_CLOSE(g2.get_value(), g2_value, tolerance);
+    }
+}
+
+//an element with a range that changes, can be used from several threads
+class gain_element3{
+public:
+    gain_element3(void): _gain(0), _max(10){}
+
+    gain_range_t get_range(void){
+        boost::mutex::scoped_lock lock(_mutex);
+        return gain_range_t(0, _max, 1);
+    }
+
+    double get_value(void){
+        boost::mutex::scoped_lock lock(_mutex);
+        return _gain;
+    }
+
+    void set_value(double gain){
+        boost::mutex::scoped_lock lock(_mutex);
+        _gain = gain;
+    }
+
+    void set_max(double max){
+        boost::mutex::scoped_lock lock(_mutex);
+        _max = max;
+    }
+
+private:
+    boost::mutex _mutex;
+    double _gain, _max;
+};
+
+BOOST_AUTO_TEST_CASE(test_gain_group_range_change){
+    gain_element3 g3;
+    gain_fcns_t gain_fcns;
+    gain_fcns.get_range = boost::bind(&gain_element3::get_range, &g3);
+    gain_fcns.get_value = boost::bind(&gain_element3::get_value, &g3);
+    gain_fcns.set_value = boost::bind(&gain_element3::set_value, &g3, _1);
+    gain_group::sptr gg(gain_group::make());
+    gg->register_fcns("g3", gain_fcns);
+
+    for (size_t i = 0; i < 3; i++){
+        gg->set_value(8);
+        BOOST_CHECK_CLOSE(g3.get_value(), 8.0, tolerance);
+    }
+
+    //a new range is used right away
+    g3.set_max(5);
+    gg->set_value(8);
+    BOOST_CHECK_CLOSE(g3.get_value(), 5.0, tolerance);
+    g3.set_max(20);
+    for (size_t i = 0; i < 3; i++){
+        gg->set_value(15);
+        BOOST_CHECK_CLOSE(g3.get_value(), 15.0, tolerance);
+    }
+}
+
+static void set_gains(gain_group::sptr gg, const size_t num_sets){
+    for (size_t i = 0; i < num_sets; i++){
+        gg->set_value(double(i % 25));
+        gg->get_range();
+    }
+}
+
+static void change_ranges(gain_element3 *g3, const size_t num_changes){
+    for (size_t i = 0; i < num_changes; i++){
+        g3->set_max((i % 2)? 20 : 10);
+        boost::this_thread::yield();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_gain_group_threads){
+    gain_element3 g3a, g3b;
+    gain_group::sptr gg(gain_group::make());
+    gain_fcns_t gain_fcns;
+    gain_fcns.get_range = boost::bind(&gain_element3::get_range, &g3a);
+    gain_fcns.get_value = boost::bind(&gain_element3::get_value, &g3a);
+    gain_fcns.set_value = boost::bind(&gain_element3::set_value, &g3a, _1);
+    gg->register_fcns("g3a", gain_fcns, 1);
+    gain_fcns.get_range = boost::bind(&gain_element3::get_range, &g3b);
+    gain_fcns.get_value = boost::bind(&gain_element3::get_value, &g3b);
+    gain_fcns.set_value = boost::bind(&gain_element3::set_value, &g3b, _1);
+    gg->register_fcns("g3b", gain_fcns, 0);
+
+    //the table is built, dropped and looked up from all threads at once
+    boost::thread_group threads;
+    for (size_t i = 0; i < 4; i++){
+        threads.create_thread(boost::bind(&set_gains, gg, 2000));
+    }
+    threads.create_thread(boost::bind(&change_ranges, &g3b, 2000));
+    threads.join_all();
+
+    g3b.set_max(10);
+    for (size_t i = 0; i < 3; i++){
+        gg->set_value(15);
+        BOOST_CHECK_CLOSE(g3a.get_value(), 10.0, tolerance);
+        BOOST_CHECK_CLOSE(g3b.get_value(), 5.0, tolerance);
+    }
+}
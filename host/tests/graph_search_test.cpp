@@ -167,3 +167,98 @@ BOOST_AUTO_TEST_CASE(test_mini_cycle_downstream_and_upstream)
     BOOST_REQUIRE_EQUAL(result.size(), 1);
     BOOST_REQUIRE(result[0] == node_A);
 }
+
+BOOST_AUTO_TEST_CASE(test_search_after_topology_change)
+{
+    MAKE_NODE(node_A);
+    MAKE_NODE(node_B);
+    MAKE_RESULT_NODE(node_C);
+    MAKE_RESULT_NODE(node_D);
+
+    connect_nodes(node_A, node_B);
+    connect_nodes(node_B, node_C);
+
+    // Repeated searches return the same result
+    std::vector< result_node::sptr > result = node_A->find_downstream_node<result_node>();
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK(result[0] == node_C);
+    result = node_A->find_downstream_node<result_node>();
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK(result[0] == node_C);
+
+    // A new connection further downstream is found
+    connect_nodes(node_B, node_D);
+    result = node_A->find_downstream_node<result_node>();
+    BOOST_CHECK_EQUAL(result.size(), 2);
+
+    // A removed connection is not
+    node_C->disconnect();
+    result = node_A->find_downstream_node<result_node>();
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK(result[0] == node_D);
+
+    // Neither is a node that went away
+    result.clear();
+    node_D.reset();
+    result = node_A->find_downstream_node<result_node>();
+    BOOST_CHECK(result.empty());
+
+    // Searches for other types are separate
+    std::vector< test_node::sptr > all = node_A->find_downstream_node<test_node>();
+    BOOST_REQUIRE_EQUAL(all.size(), 1);
+    BOOST_CHECK(all[0] == node_B);
+}
+
+BOOST_AUTO_TEST_CASE(test_search_after_node_removal)
+{
+    MAKE_NODE(node_A);
+    MAKE_NODE(node_B);
+    MAKE_RESULT_NODE(node_C);
+    MAKE_NODE(node_X);
+    MAKE_RESULT_NODE(node_Y);
+
+    connect_nodes(node_A, node_B);
+    connect_nodes(node_B, node_C);
+    // A separate graph
+    connect_nodes(node_X, node_Y);
+
+    std::vector< result_node::sptr > result = node_A->find_downstream_node<result_node>();
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK(result[0] == node_C);
+    result = node_X->find_downstream_node<result_node>();
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK(result[0] == node_Y);
+
+    // Removing a node between A and C cuts C off
+    node_B.reset();
+    BOOST_CHECK(node_A->find_downstream_node<result_node>().empty());
+    BOOST_CHECK(node_C->find_upstream_node<test_node>().empty());
+
+    // The other graph is not affected
+    result = node_X->find_downstream_node<result_node>();
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK(result[0] == node_Y);
+}
+
+BOOST_AUTO_TEST_CASE(test_active_search_after_streamer_change)
+{
+    MAKE_NODE(node_A);
+    MAKE_RESULT_NODE(node_B);
+
+    connect_nodes(node_A, node_B);
+
+    // Without a streamer, active searches find nothing
+    BOOST_CHECK(node_A->find_downstream_node<result_node>(true).empty());
+    BOOST_CHECK(node_A->find_downstream_node<result_node>(true).empty());
+    BOOST_CHECK_EQUAL(node_A->find_downstream_node<result_node>().size(), 1);
+
+    // Starting and stopping a streamer changes the result
+    node_A->set_tx_streamer(true, 0);
+    std::vector< result_node::sptr > result = node_A->find_downstream_node<result_node>(true);
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK(result[0] == node_B);
+    BOOST_CHECK_EQUAL(node_A->find_downstream_node<result_node>(true).size(), 1);
+
+    node_A->set_tx_streamer(false, 0);
+    BOOST_CHECK(node_A->find_downstream_node<result_node>(true).empty());
+}
@@ -0,0 +1,49 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "../lib/rfnoc/nocscript/block_iface.hpp"
+#include <uhd/exception.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace uhd::rfnoc::nocscript;
+
+BOOST_AUTO_TEST_CASE(test_block_iface_cached_expr_tree)
+{
+    // This code only uses NocScript variables, so it never touches the block
+    block_iface::sptr iface = block_iface::make(NULL);
+    const std::string code("SET_VAR('spp', 64), GE(GET_INT('spp'), 16)");
+
+    // The first run parses the code, the second one reuses the tree
+    BOOST_CHECK_NO_THROW(iface->run_and_check(code));
+    const expression::sptr tree = iface->get_expr_tree(code);
+    BOOST_CHECK_NO_THROW(iface->run_and_check(code));
+    BOOST_CHECK(iface->get_expr_tree(code) == tree);
+    BOOST_CHECK(tree->eval().get_bool());
+
+    // Other code gets its own tree, which fails on every run
+    const std::string failing_code("SET_VAR('spp', 8), GE(GET_INT('spp'), 16)");
+    BOOST_CHECK_THROW(iface->run_and_check(failing_code, "spp too small"), uhd::runtime_error);
+    const expression::sptr failing_tree = iface->get_expr_tree(failing_code);
+    BOOST_CHECK(failing_tree != tree);
+    BOOST_CHECK_THROW(iface->run_and_check(failing_code, "spp too small"), uhd::runtime_error);
+    BOOST_CHECK(iface->get_expr_tree(failing_code) == failing_tree);
+    BOOST_CHECK_NO_THROW(iface->run_and_check(code));
+
+    // Invalid code is rejected every time
+    BOOST_CHECK_THROW(iface->run_and_check("GE(GET_INT('spp'),"), uhd::syntax_error);
+    BOOST_CHECK_THROW(iface->run_and_check("GE(GET_INT('spp'),"), uhd::syntax_error);
+}
@@ -23,6 +23,10 @@
 #include <vector>
 #include <list>
 
+#ifdef __linux__
+#include <poll.h>
+#endif
+
 #define BOOST_CHECK_TS_CLOSE(a, b) \
     BOOST_CHECK_CLOSE((a).get_real_secs(), (b).get_real_secs(), 0.001)
 
@@ -815,3 +819,144 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_fragment){
 
     BOOST_REQUIRE_THROW(handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
 }
+
+////////////////////////////////////////////////////////////////////////
+static void set_dummy_xport_stats(uhd::stream_stats_t &stats){
+    stats.xport_frames_in_flight = 16;
+    stats.xport_frame_size = 8192;
+}
+
+BOOST_AUTO_TEST_CASE(test_sph_recv_stream_stats){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    dummy_recv_xport_class dummy_recv_xport("big");
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    //generate a bunch of packets, with one lost and one overflow message
+    size_t num_bytes = 0;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+        ifpi.num_payload_words32 = 10;
+        if (i == NUM_PKTS_TO_TEST/2){ //simulate a lost packet
+            ifpi.packet_count++;
+            continue;
+        }
+        if (i == NUM_PKTS_TO_TEST/3){
+            ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_CONTEXT;
+            ifpi.num_payload_words32 = 1;
+            dummy_recv_xport.push_back_packet(ifpi, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+            continue;
+        }
+        dummy_recv_xport.push_back_packet(ifpi);
+        num_bytes += ifpi.num_payload_words32*sizeof(uint32_t);
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet streamer
+    uhd::transport::sph::recv_packet_streamer streamer(20);
+    streamer.resize(1);
+    streamer.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    streamer.set_tick_rate(TICK_RATE);
+    streamer.set_samp_rate(SAMP_RATE);
+    streamer.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
+    streamer.set_converter(id);
+    uhd::device_addr_t args;
+    args["stats_timing"] = "1";
+    streamer.set_recv_args(args);
+
+    //receive everything until the timeout
+    std::vector<std::complex<float> > buff(20);
+    uhd::rx_metadata_t metadata;
+    size_t num_calls = 0;
+    do {
+        streamer.recv(&buff.front(), buff.size(), metadata, 0.0, true);
+        num_calls++;
+    } while (metadata.error_code != uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+
+    uhd::stream_stats_t stats = streamer.get_stats();
+    BOOST_CHECK_EQUAL(stats.num_packets, NUM_PKTS_TO_TEST-2);
+    BOOST_CHECK_EQUAL(stats.num_bytes, num_bytes);
+    BOOST_CHECK_EQUAL(stats.num_overflows, 1UL);
+    BOOST_CHECK_EQUAL(stats.num_seq_errors, 1UL);
+    BOOST_CHECK_EQUAL(stats.num_late_packets, 0UL);
+    BOOST_CHECK_EQUAL(stats.num_fc_stalls, 0UL);
+    BOOST_CHECK(stats.convert_time > 0.0);
+    BOOST_REQUIRE_EQUAL(stats.call_latency.size(), uhd::stream_stats_t::NUM_LATENCY_BUCKETS);
+    uint64_t num_timed_calls = 0;
+    for (size_t i = 0; i < stats.call_latency.size(); i++){
+        num_timed_calls += stats.call_latency[i];
+    }
+    BOOST_CHECK_EQUAL(num_timed_calls, num_calls);
+
+    //a reset starts the counters over
+    streamer.reset_stats();
+    stats = streamer.get_stats();
+    BOOST_CHECK_EQUAL(stats.num_packets, 0UL);
+    BOOST_CHECK_EQUAL(stats.num_bytes, 0UL);
+    BOOST_CHECK_EQUAL(stats.num_overflows, 0UL);
+    BOOST_CHECK_EQUAL(stats.num_seq_errors, 0UL);
+    BOOST_CHECK_EQUAL(stats.convert_time, 0.0);
+
+    //transport settings are reported as they are, not reset
+    BOOST_CHECK_EQUAL(stats.xport_frames_in_flight, 0UL);
+    streamer.set_xport_chan_xport_stats(0, &set_dummy_xport_stats);
+    stats = streamer.get_stats();
+    BOOST_CHECK_EQUAL(stats.xport_frames_in_flight, 16UL);
+    BOOST_CHECK_EQUAL(stats.xport_frame_size, 8192UL);
+}
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE(test_sph_recv_ready_fd){
+////////////////////////////////////////////////////////////////////////
+    uhd::transport::event_fd::sptr events[2] = {
+        uhd::transport::event_fd::make(), uhd::transport::event_fd::make()
+    };
+    if (events[0]->get_fd() < 0) return; //not built with eventfd
+
+    //a channel without a ready descriptor disables it
+    uhd::transport::sph::recv_packet_streamer partial_streamer(20);
+    partial_streamer.resize(2);
+    partial_streamer.set_xport_chan_ready_fd(0, boost::bind(&uhd::transport::event_fd::get_fd, events[0]));
+    BOOST_CHECK_EQUAL(partial_streamer.get_recv_fd(), -1);
+
+    //with all channels, the streamer is ready when any of them is
+    uhd::transport::sph::recv_packet_streamer streamer(20);
+    streamer.resize(2);
+    streamer.set_xport_chan_ready_fd(0, boost::bind(&uhd::transport::event_fd::get_fd, events[0]));
+    streamer.set_xport_chan_ready_fd(1, boost::bind(&uhd::transport::event_fd::get_fd, events[1]));
+    const int fd = streamer.get_recv_fd();
+    if (fd < 0) return; //not built with epoll
+    BOOST_CHECK_EQUAL(streamer.get_recv_fd(), fd);
+
+    pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    BOOST_CHECK_EQUAL(::poll(&pfd, 1, 0), 0);
+    events[1]->signal();
+    BOOST_CHECK_EQUAL(::poll(&pfd, 1, 0), 1);
+    events[1]->clear();
+    BOOST_CHECK_EQUAL(::poll(&pfd, 1, 0), 0);
+}
+#endif
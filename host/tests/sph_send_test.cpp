@@ -190,3 +190,199 @@ BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_full_buffer_mode){
         num_accum_samps += ifpi.num_payload_words32;
     }
 }
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_send_multi_channel_wait_strategies){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs = 1;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+    static const size_t NUM_CHANNELS = 3;
+
+    std::vector<std::string> strategies;
+    strategies.push_back("auto");
+    strategies.push_back("spin");
+    strategies.push_back("spin_block");
+    strategies.push_back("inline");
+
+    for (size_t s = 0; s < strategies.size(); s++){
+        std::cout << "wait strategy " << strategies[s] << std::endl;
+        uhd::device_addr_t args;
+        args["send_wait"] = strategies[s];
+
+        std::vector<boost::shared_ptr<dummy_send_xport_class> > dummy_send_xports;
+
+        //create the super send packet handler
+        uhd::transport::sph::send_packet_handler handler(NUM_CHANNELS);
+        handler.set_vrt_packer(&uhd::transport::vrt::if_hdr_pack_be);
+        handler.set_tick_rate(TICK_RATE);
+        handler.set_samp_rate(SAMP_RATE);
+        handler.set_send_args(args);
+        for (size_t ch = 0; ch < NUM_CHANNELS; ch++){
+            dummy_send_xports.push_back(boost::make_shared<dummy_send_xport_class>("big"));
+            handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_send_xport_class::get_send_buff, dummy_send_xports.back(), _1));
+        }
+        handler.set_converter(id);
+        handler.set_max_samples_per_packet(20);
+
+        //allocate metadata and buffers
+        std::vector<std::complex<float> > buff(20*NUM_PKTS_TO_TEST - 5);
+        std::vector<const void *> buffs(NUM_CHANNELS, &buff.front());
+        uhd::tx_metadata_t metadata;
+        metadata.start_of_burst = true;
+        metadata.end_of_burst = true;
+        metadata.has_time_spec = true;
+        metadata.time_spec = uhd::time_spec_t(0.0);
+
+        //send the whole buffer in one call
+        const size_t num_sent = handler.send(
+            buffs, buff.size(), metadata, 1.0
+        );
+        BOOST_CHECK_EQUAL(num_sent, buff.size());
+
+        //check the sent packets on every channel
+        for (size_t ch = 0; ch < NUM_CHANNELS; ch++){
+            size_t num_accum_samps = 0;
+            uhd::transport::vrt::if_packet_info_t ifpi;
+            for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+                dummy_send_xports[ch]->pop_front_packet(ifpi);
+                BOOST_CHECK_EQUAL(ifpi.num_payload_words32, (i == NUM_PKTS_TO_TEST-1)? 15UL : 20UL);
+                BOOST_CHECK_EQUAL(ifpi.packet_count, i%16);
+                BOOST_CHECK(ifpi.has_tsf);
+                BOOST_CHECK_EQUAL(ifpi.tsf, num_accum_samps*TICK_RATE/SAMP_RATE);
+                BOOST_CHECK_EQUAL(ifpi.sob, i == 0);
+                BOOST_CHECK_EQUAL(ifpi.eob, i == NUM_PKTS_TO_TEST-1);
+                num_accum_samps += ifpi.num_payload_words32;
+            }
+        }
+    }
+
+    //unknown strategies are rejected
+    uhd::transport::sph::send_packet_handler handler(1);
+    uhd::device_addr_t args;
+    args["send_wait"] = "sleepy";
+    BOOST_CHECK_THROW(handler.set_send_args(args), uhd::value_error);
+}
+
+static uhd::tx_flow_ctrl_stats_t dummy_fc_stats(void){
+    uhd::tx_flow_ctrl_stats_t stats;
+    stats.credit_occupancy = 0.5;
+    stats.num_stalls = 3;
+    stats.stall_time = 0.25;
+    return stats;
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_send_flow_ctrl_stats){
+////////////////////////////////////////////////////////////////////////
+    uhd::transport::sph::send_packet_streamer streamer(20);
+    streamer.resize(2);
+    streamer.set_xport_chan_fc_stats(1, &dummy_fc_stats);
+
+    //channels without flow control report zeros
+    const uhd::tx_flow_ctrl_stats_t stats0 = streamer.get_flow_ctrl_stats(0);
+    BOOST_CHECK_EQUAL(stats0.credit_occupancy, 0.0);
+    BOOST_CHECK_EQUAL(stats0.num_stalls, 0UL);
+    BOOST_CHECK_EQUAL(stats0.stall_time, 0.0);
+
+    const uhd::tx_flow_ctrl_stats_t stats1 = streamer.get_flow_ctrl_stats(1);
+    BOOST_CHECK_EQUAL(stats1.credit_occupancy, 0.5);
+    BOOST_CHECK_EQUAL(stats1.num_stalls, 3UL);
+    BOOST_CHECK_EQUAL(stats1.stall_time, 0.25);
+
+    BOOST_CHECK_THROW(streamer.get_flow_ctrl_stats(2), std::out_of_range);
+}
+
+static bool dummy_async_receiver(uhd::async_metadata_t &async_metadata, const double){
+    async_metadata.event_code = uhd::async_metadata_t::EVENT_CODE_UNDERFLOW;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_send_stream_stats){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs = 1;
+
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    for (size_t num_chans = 1; num_chans <= 2; num_chans++){
+        std::cout << "channels " << num_chans << std::endl;
+        std::vector<boost::shared_ptr<dummy_send_xport_class> > dummy_send_xports;
+
+        //create the super send packet streamer
+        uhd::transport::sph::send_packet_streamer streamer(20);
+        streamer.resize(num_chans);
+        streamer.set_vrt_packer(&uhd::transport::vrt::if_hdr_pack_be);
+        streamer.set_tick_rate(100e6);
+        streamer.set_samp_rate(10e6);
+        uhd::device_addr_t args;
+        args["stats_timing"] = "1";
+        streamer.set_send_args(args);
+        for (size_t ch = 0; ch < num_chans; ch++){
+            dummy_send_xports.push_back(boost::make_shared<dummy_send_xport_class>("big"));
+            streamer.set_xport_chan_get_buff(ch, boost::bind(&dummy_send_xport_class::get_send_buff, dummy_send_xports.back(), _1));
+            streamer.set_xport_chan_fc_stats(ch, &dummy_fc_stats);
+        }
+        streamer.set_async_receiver(&dummy_async_receiver);
+        streamer.set_converter(id);
+
+        //send one packet per call
+        std::vector<std::complex<float> > buff(20);
+        std::vector<const void *> buffs(num_chans, &buff.front());
+        uhd::tx_metadata_t metadata;
+        for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+            BOOST_CHECK_EQUAL(streamer.send(buffs, buff.size(), metadata, 1.0), buff.size());
+        }
+        uhd::async_metadata_t async_metadata;
+        BOOST_CHECK(streamer.recv_async_msg(async_metadata));
+
+        uhd::stream_stats_t stats = streamer.get_stats();
+        BOOST_CHECK_EQUAL(stats.num_packets, NUM_PKTS_TO_TEST*num_chans);
+        BOOST_CHECK_EQUAL(stats.num_bytes, NUM_PKTS_TO_TEST*num_chans*buff.size()*sizeof(uint32_t));
+        BOOST_CHECK_EQUAL(stats.num_underflows, 1UL);
+        BOOST_CHECK_EQUAL(stats.num_fc_stalls, 3*num_chans);
+        BOOST_CHECK_CLOSE(stats.fc_stall_time, 0.25*num_chans, 0.001);
+        BOOST_CHECK(stats.convert_time > 0.0);
+        uint64_t num_timed_calls = 0;
+        for (size_t i = 0; i < stats.call_latency.size(); i++){
+            num_timed_calls += stats.call_latency[i];
+        }
+        BOOST_CHECK_EQUAL(num_timed_calls, NUM_PKTS_TO_TEST);
+
+        //a reset starts the counters over, including the flow control ones
+        streamer.reset_stats();
+        stats = streamer.get_stats();
+        BOOST_CHECK_EQUAL(stats.num_packets, 0UL);
+        BOOST_CHECK_EQUAL(stats.num_underflows, 0UL);
+        BOOST_CHECK_EQUAL(stats.num_fc_stalls, 0UL);
+        BOOST_CHECK_EQUAL(stats.fc_stall_time, 0.0);
+    }
+}
+
+static void dummy_async_callback(const uhd::async_metadata_t &){
+    //NOP
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_send_async_callback){
+////////////////////////////////////////////////////////////////////////
+    uhd::transport::sph::send_packet_streamer streamer(20);
+    streamer.resize(1);
+
+    //without an async channel the streamer does not support callbacks
+    BOOST_CHECK_THROW(streamer.set_async_callback(&dummy_async_callback), uhd::not_implemented_error);
+    BOOST_CHECK_EQUAL(streamer.get_async_fd(), -1);
+
+    streamer.set_async_channel(uhd::transport::async_event_channel::make(16));
+    BOOST_CHECK_NO_THROW(streamer.set_async_callback(&dummy_async_callback));
+}
@@ -0,0 +1,95 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <uhd/exception.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+BOOST_AUTO_TEST_CASE(test_thread_placement_args){
+    //no thread keys resets the policy to the defaults
+    BOOST_CHECK_NO_THROW(uhd::set_thread_placement(uhd::device_addr_t("type=x300")));
+
+    //CPU 0 always exists, so this can be applied anywhere affinity is supported
+    BOOST_CHECK_NO_THROW(uhd::set_thread_placement(uhd::device_addr_t(
+        "thread_cpus=0,thread_task_cpus=0-0:0"
+    )));
+    //in threads of their own, to keep the affinity of the test thread
+    BOOST_CHECK_NO_THROW(boost::thread(boost::bind(
+        &uhd::apply_thread_placement, std::string("task"))).join());
+    BOOST_CHECK_NO_THROW(boost::thread(boost::bind(
+        &uhd::apply_thread_placement, std::string("unknown_role"))).join());
+
+    //malformed values are rejected
+    BOOST_CHECK_THROW(uhd::set_thread_placement(uhd::device_addr_t(
+        "thread_cpus=zero"
+    )), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::set_thread_placement(uhd::device_addr_t(
+        "thread_cpus=3-2"
+    )), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::set_thread_placement(uhd::device_addr_t(
+        "thread_task_cpus=0-100000000"
+    )), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::set_thread_placement(uhd::device_addr_t(
+        "thread_send_worker_priority=2.0"
+    )), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::set_thread_placement(uhd::device_addr_t(
+        "thread_priority=high"
+    )), uhd::value_error);
+
+    //leave the policy empty for other tests
+    BOOST_CHECK_NO_THROW(uhd::set_thread_placement(uhd::device_addr_t()));
+}
+
+#ifdef __linux__
+static void get_placed_cpus(const std::string &role, cpu_set_t *cpus){
+    uhd::apply_thread_placement(role);
+    CPU_ZERO(cpus);
+    sched_getaffinity(0, sizeof(*cpus), cpus);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_placement_roles){
+    //place every role on the last CPU this process may use
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    BOOST_REQUIRE_EQUAL(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    if (CPU_COUNT(&allowed) < 2) return; //placement makes no difference
+    size_t last_cpu = 0;
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; cpu++){
+        if (CPU_ISSET(cpu, &allowed)) last_cpu = cpu;
+    }
+
+    static const char *roles[] = {
+        "task", "recv_offload", "mux_recv", "usb_event", "send_worker", "gps_reader"
+    };
+    for(const char *role:  roles){
+        uhd::set_thread_placement(uhd::device_addr_t(str(
+            boost::format("thread_%s_cpus=%u") % role % last_cpu
+        )));
+        cpu_set_t cpus;
+        boost::thread(boost::bind(&get_placed_cpus, std::string(role), &cpus)).join();
+        BOOST_CHECK_MESSAGE(CPU_COUNT(&cpus) == 1 and CPU_ISSET(last_cpu, &cpus), role);
+    }
+    uhd::set_thread_placement(uhd::device_addr_t());
+}
+#endif
@@ -0,0 +1,95 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/utils/trace.hpp>
+#include <uhd/exception.hpp>
+#include <boost/thread/thread.hpp>
+#include <sstream>
+
+using namespace uhd::trace;
+
+static size_t count_substr(const std::string &str, const std::string &sub){
+    size_t count = 0;
+    for (size_t pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos+1)){
+        count++;
+    }
+    return count;
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_record_dump){
+    clear();
+    {
+        scoped_event event(RECV_CONVERT, 42);
+    }
+    record(SEND_FC_RECV, PHASE_INSTANT, 7);
+
+    std::stringstream ss;
+    BOOST_CHECK_EQUAL(dump(ss), 3UL);
+    const std::string json = ss.str();
+    BOOST_CHECK_EQUAL(json.find("{\"traceEvents\":["), 0UL);
+    BOOST_CHECK_EQUAL(count_substr(json, "\"name\":\"recv_convert\""), 2UL);
+    BOOST_CHECK_EQUAL(count_substr(json, "\"ph\":\"B\""), 1UL);
+    BOOST_CHECK_EQUAL(count_substr(json, "\"ph\":\"E\""), 1UL);
+    BOOST_CHECK_EQUAL(count_substr(json, "\"ph\":\"i\""), 1UL);
+    BOOST_CHECK_EQUAL(count_substr(json, "\"arg\":42"), 1UL);
+    BOOST_CHECK_EQUAL(count_substr(json, "\"arg\":7"), 1UL);
+
+    //clearing drops everything recorded so far
+    clear();
+    std::stringstream empty;
+    BOOST_CHECK_EQUAL(dump(empty), 0UL);
+    BOOST_CHECK_EQUAL(empty.str(), "{\"traceEvents\":[\n]}\n");
+}
+
+static void record_n(const size_t n){
+    for (size_t i = 0; i < n; i++){
+        record(SEND_COMMIT, PHASE_INSTANT, i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_threads){
+    clear();
+    static const size_t NUM_THREADS = 4;
+    boost::thread_group threads;
+    for (size_t i = 0; i < NUM_THREADS; i++){
+        threads.create_thread(boost::bind(&record_n, 100));
+    }
+    threads.join_all();
+
+    //every thread's events survive the thread
+    std::stringstream ss;
+    BOOST_CHECK_EQUAL(dump(ss), NUM_THREADS*100);
+
+    //a full ring keeps the newest events
+    clear();
+    record_n(1000000);
+    std::stringstream full;
+    const size_t num_events = dump(full);
+    BOOST_CHECK(num_events > 0 and num_events < 1000000);
+    BOOST_CHECK_EQUAL(count_substr(full.str(), "\"arg\":999999}"), 1UL);
+    BOOST_CHECK_EQUAL(count_substr(full.str(), "\"arg\":0}"), 0UL);
+    clear();
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_event_names){
+    BOOST_CHECK_EQUAL(get_event_name(RECV_GET_BUFF), "recv_get_buff");
+    BOOST_CHECK_EQUAL(get_event_name(SEND_COMMIT), "send_commit");
+    BOOST_CHECK_EQUAL(get_event_name(RECV_CALL), "recv");
+    BOOST_CHECK_EQUAL(get_event_name(SEND_CALL), "send");
+    BOOST_CHECK_THROW(get_event_name(NUM_EVENTS), uhd::key_error);
+}
@@ -23,12 +23,24 @@
 #include <boost/format.hpp>
 #include <boost/timer.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <chrono>
+#include <cmath>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <map>
 #include <complex>
 #include <stdint.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#  define CONVERTER_BENCHMARK_HAVE_TSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#  include <intrin.h>
+#  define CONVERTER_BENCHMARK_HAVE_TSC
+#endif
+
 namespace po = boost::program_options;
 using namespace uhd::convert;
 
@@ -55,11 +67,12 @@ std::string format_to_type(const std::string &format)
 void configure_conv(
         converter::sptr conv,
         const std::string &in_type,
-        const std::string &out_type
+        const std::string &out_type,
+        const bool verbose = true
 ) {
     if (in_type == "sc16") {
         if (out_type == "fc32") {
-            std::cout << "Setting scalar to 32767." << std::endl;
+            if (verbose) std::cout << "Setting scalar to 32767." << std::endl;
             conv->set_scalar(32767.);
             return;
         }
@@ -67,13 +80,13 @@ void configure_conv(
 
     if (in_type == "fc32") {
         if (out_type == "sc16") {
-            std::cout << "Setting scalar to 32767." << std::endl;
+            if (verbose) std::cout << "Setting scalar to 32767." << std::endl;
             conv->set_scalar(32767.);
             return;
         }
     }
 
-    std::cout << "No configuration required." << std::endl;
+    if (verbose) std::cout << "No configuration required." << std::endl;
 }
 
 template <typename T>
@@ -264,6 +277,250 @@ std::string item_to_string(
     }
 }
 
+/***********************************************************************
+ * Sweep mode: Benchmark many converters, write machine-readable results
+ **********************************************************************/
+struct sweep_result_t
+{
+    id_type id;
+    priority_type prio;
+    size_t n_samples;
+    size_t alignment;
+    size_t channels;
+    size_t iterations;
+    double duration_s;
+    double samples_per_sec;
+    double cycles_per_sample;
+    //! Throughput of the baseline run, or 0 if there is none
+    double baseline_samples_per_sec;
+    bool regression;
+};
+
+std::vector<size_t> parse_size_list(const std::string &list)
+{
+    std::vector<std::string> tokens;
+    boost::split(tokens, list, boost::is_any_of(","), boost::token_compress_on);
+    std::vector<size_t> values;
+    for(const std::string &token:  tokens) {
+        if (not token.empty()) {
+            values.push_back(boost::lexical_cast<size_t>(boost::trim_copy(token)));
+        }
+    }
+    return values;
+}
+
+// Everything that identifies a measurement, used to match up with the baseline
+std::string result_key(
+        const id_type &id,
+        const priority_type prio,
+        const size_t n_samples,
+        const size_t alignment,
+        const size_t channels
+) {
+    return str(boost::format("%s,%d,%s,%d,%d,%d,%d,%d")
+        % id.input_format % id.num_inputs
+        % id.output_format % id.num_outputs
+        % prio % n_samples % alignment % channels
+    );
+}
+
+// Read a CSV file previously written by --format csv.
+// Returns a map key -> samples/sec
+std::map<std::string, double> load_baseline(const std::string &path)
+{
+    std::ifstream file(path.c_str());
+    if (not file.good()) {
+        throw uhd::runtime_error(str(
+            boost::format("Cannot open baseline file: %s") % path
+        ));
+    }
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields;
+        boost::split(fields, line, boost::is_any_of(","));
+        if (fields.size() < 11 or fields[0] == "in_format") {
+            continue;
+        }
+        try {
+            baseline[
+                boost::join(std::vector<std::string>(fields.begin(), fields.begin() + 8), ",")
+            ] = boost::lexical_cast<double>(fields[10]);
+        } catch (const boost::bad_lexical_cast &) {
+            continue;
+        }
+    }
+    return baseline;
+}
+
+// Item size for a format, or the size of the largest registered item if the
+// format is unknown (e.g. packed wire formats), so buffers are always large
+// enough.
+size_t safe_bytes_per_item(const std::string &format)
+{
+    try {
+        return get_bytes_per_item(format);
+    } catch (const uhd::key_error &) {
+        return sizeof(std::complex<double>);
+    }
+}
+
+// Returns a pointer into buf which is `alignment' bytes past a 64-byte boundary
+char *aligned_ptr(std::vector<char> &buf, const size_t alignment)
+{
+    const uintptr_t base = reinterpret_cast<uintptr_t>(&buf[0]);
+    return reinterpret_cast<char *>(((base + 63) & ~uintptr_t(63)) + alignment);
+}
+
+// One converter instance with its own buffers, i.e. one streamer channel
+struct sweep_channel_t
+{
+    converter::sptr conv;
+    std::vector< std::vector<char> > input_buffers;
+    std::vector< std::vector<char> > output_buffers;
+    std::vector<const void *> input_buf_refs;
+    std::vector<void *> output_buf_refs;
+};
+
+// Runs `channels' converters round-robin on the calling thread. Every
+// converter has its own state (e.g. lookup tables) and buffers, just like
+// the converters of a multi-channel streamer, so this shows how well a
+// converter holds up when it has to share the caches.
+sweep_result_t run_sweep_point(
+        const id_type &id,
+        const priority_type prio,
+        const size_t n_samples,
+        const size_t alignment,
+        const size_t channels,
+        const size_t total_samples,
+        const double cpu_hz
+) {
+    const std::string in_type  = format_to_type(id.input_format);
+    const std::string out_type = format_to_type(id.output_format);
+    // Allocate with enough slack to move the start of the data around
+    const size_t in_size  = safe_bytes_per_item(id.input_format);
+    const size_t out_size = safe_bytes_per_item(id.output_format);
+
+    std::vector<sweep_channel_t> chans(channels);
+    for(sweep_channel_t &chan:  chans) {
+        chan.conv = get_converter(id, prio)();
+        // Quietly: the sweep results may be written to stdout
+        configure_conv(chan.conv, in_type, out_type, false);
+
+        chan.input_buffers.assign(id.num_inputs,
+                std::vector<char>(in_size * n_samples + alignment + 64, 0));
+        chan.output_buffers.assign(id.num_outputs,
+                std::vector<char>(out_size * n_samples + alignment + 64, 0));
+        try {
+            init_buffers(chan.input_buffers, in_type, in_size, RANDOM);
+        } catch (const uhd::runtime_error &) {
+            // Unknown sample type, random bytes will do
+            for (size_t i = 0; i < chan.input_buffers.size(); i++) {
+                init_random_vector_real_int<uint8_t>(chan.input_buffers[i], chan.input_buffers[i].size());
+            }
+        }
+        for (size_t i = 0; i < id.num_inputs; i++) {
+            chan.input_buf_refs.push_back(aligned_ptr(chan.input_buffers[i], alignment));
+        }
+        for (size_t i = 0; i < id.num_outputs; i++) {
+            chan.output_buf_refs.push_back(aligned_ptr(chan.output_buffers[i], alignment));
+        }
+    }
+
+    sweep_result_t result;
+    result.id = id;
+    result.prio = prio;
+    result.n_samples = n_samples;
+    result.alignment = alignment;
+    result.channels = channels;
+    result.iterations = std::max<size_t>(1, total_samples / (n_samples * channels));
+    result.baseline_samples_per_sec = 0.0;
+    result.regression = false;
+
+    // Warm up caches and branch predictors before timing
+    for(sweep_channel_t &chan:  chans) {
+        chan.conv->conv(chan.input_buf_refs, chan.output_buf_refs, n_samples);
+    }
+
+#ifdef CONVERTER_BENCHMARK_HAVE_TSC
+    const uint64_t start_tsc = __rdtsc();
+#endif
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < result.iterations; i++) {
+        for(sweep_channel_t &chan:  chans) {
+            chan.conv->conv(chan.input_buf_refs, chan.output_buf_refs, n_samples);
+        }
+    }
+    const std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+#ifdef CONVERTER_BENCHMARK_HAVE_TSC
+    const uint64_t stop_tsc = __rdtsc();
+#endif
+
+    const double samples = double(result.iterations) * double(n_samples) * double(channels);
+    result.duration_s = std::chrono::duration<double>(stop - start).count();
+    result.samples_per_sec = samples / result.duration_s;
+    if (cpu_hz > 0) {
+        result.cycles_per_sample = (result.duration_s * cpu_hz) / samples;
+    } else {
+#ifdef CONVERTER_BENCHMARK_HAVE_TSC
+        result.cycles_per_sample = double(stop_tsc - start_tsc) / samples;
+#else
+        result.cycles_per_sample = 0.0;
+#endif
+    }
+    return result;
+}
+
+void write_sweep_results(
+        std::ostream &out,
+        const std::vector<sweep_result_t> &results,
+        const std::string &format,
+        const bool have_baseline
+) {
+    if (format == "json") {
+        out << "{\n  \"results\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const sweep_result_t &r = results[i];
+            out << ((i == 0) ? "\n" : ",\n") << boost::format(
+                "    {\"in_format\": \"%s\", \"num_inputs\": %d, "
+                "\"out_format\": \"%s\", \"num_outputs\": %d, "
+                "\"prio\": %d, \"n_samples\": %d, \"alignment\": %d, "
+                "\"channels\": %d, \"iterations\": %d, \"duration_ms\": %f, "
+                "\"samples_per_sec\": %f, \"cycles_per_sample\": %f")
+                % r.id.input_format % r.id.num_inputs
+                % r.id.output_format % r.id.num_outputs
+                % r.prio % r.n_samples % r.alignment
+                % r.channels % r.iterations % (r.duration_s * 1000)
+                % r.samples_per_sec % r.cycles_per_sample;
+            if (have_baseline) {
+                out << boost::format(", \"baseline_samples_per_sec\": %f, \"regression\": %s")
+                    % r.baseline_samples_per_sec % (r.regression ? "true" : "false");
+            }
+            out << "}";
+        }
+        out << "\n  ]\n}" << std::endl;
+        return;
+    }
+
+    // CSV
+    out << "in_format,num_inputs,out_format,num_outputs,prio,n_samples,alignment,"
+           "channels,iterations,duration_ms,samples_per_sec,cycles_per_sample";
+    if (have_baseline) {
+        out << ",baseline_samples_per_sec,regression";
+    }
+    out << std::endl;
+    for(const sweep_result_t &r:  results) {
+        out << result_key(r.id, r.prio, r.n_samples, r.alignment, r.channels)
+            << boost::format(",%d,%f,%f,%f")
+                % r.iterations % (r.duration_s * 1000)
+                % r.samples_per_sec % r.cycles_per_sample;
+        if (have_baseline) {
+            out << boost::format(",%f,%d") % r.baseline_samples_per_sec % r.regression;
+        }
+        out << std::endl;
+    }
+}
+
 int UHD_SAFE_MAIN(int argc, char *argv[])
 {
     std::string in_format, out_format;
@@ -273,6 +530,9 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
     size_t iterations, n_samples;
     size_t n_inputs, n_outputs;
     buf_init_t buf_seed_mode = RANDOM;
+    std::string sizes, alignments, channels, output_format, output_file, baseline_file;
+    size_t sweep_samples;
+    double tolerance, cpu_mhz;
 
     /// Command line arguments
     po::options_description desc("Converter benchmark options:");
@@ -289,6 +549,16 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
         ("debug-converter", "Skip benchmark and print conversion results. Implies iterations==1 and will only run on a single converter.")
         ("seed-mode", po::value<std::string>(&seed_mode)->default_value("random"), "How to initialize the data: random, incremental")
         ("hex", "When using debug mode, dump memory in hex")
+        ("sweep", "Benchmark every registered converter and priority. --in and --out, if given, restrict the sweep to those formats.")
+        ("sizes", po::value<std::string>(&sizes)->default_value("64,1024,16384"), "Sweep mode: Comma-separated list of samples per conversion call")
+        ("alignments", po::value<std::string>(&alignments)->default_value("0"), "Sweep mode: Comma-separated list of buffer offsets in bytes from a 64-byte boundary")
+        ("channels", po::value<std::string>(&channels)->default_value("1"), "Sweep mode: Comma-separated list of converter instances to run round-robin, to measure the effect of cache pressure")
+        ("sweep-samples", po::value<size_t>(&sweep_samples)->default_value(10000000), "Sweep mode: Total number of samples to convert per measurement")
+        ("format", po::value<std::string>(&output_format)->default_value("csv"), "Sweep mode: Output format, 'csv' or 'json'")
+        ("output", po::value<std::string>(&output_file), "Sweep mode: Write results to this file instead of stdout")
+        ("baseline", po::value<std::string>(&baseline_file), "Sweep mode: CSV results of a previous sweep to compare against")
+        ("tolerance", po::value<double>(&tolerance)->default_value(0.1), "Sweep mode: Allowed relative throughput drop before a result is flagged as a regression")
+        ("cpu-mhz", po::value<double>(&cpu_mhz)->default_value(0), "Sweep mode: CPU clock used to compute cycles/sample. If 0, the time stamp counter is used where available.")
     ;
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -302,10 +572,81 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
                      "  for every conversion run in CSV format to stdout. Every line between\n"
                      "  the output delimiters {{{ }}} is of the format: <PRIO>,<TIME IN MILLISECONDS>\n"
                      "  When using for converter debugging, every line is formatted as\n"
-                     "  <INPUT_VALUE>,<OUTPUT_VALUE>\n" << std::endl;
+                     "  <INPUT_VALUE>,<OUTPUT_VALUE>\n"
+                     "  In sweep mode, every converter is run for all given sizes and\n"
+                     "  alignments, and the results are written as CSV or JSON. If a\n"
+                     "  baseline is given, the tool exits with an error if any converter\n"
+                     "  got slower by more than the tolerance.\n" << std::endl;
         return EXIT_FAILURE;
     }
 
+    /// Sweep mode ////////////////////////////////////////////////////////////
+    if (vm.count("sweep")) {
+        if (output_format != "csv" and output_format != "json") {
+            std::cout << "Invalid argument: --format must be either 'csv' or 'json'." << std::endl;
+            return EXIT_FAILURE;
+        }
+        const std::vector<size_t> sweep_sizes = parse_size_list(sizes);
+        const std::vector<size_t> sweep_alignments = parse_size_list(alignments);
+        const std::vector<size_t> sweep_channels = parse_size_list(channels);
+        const bool have_baseline = vm.count("baseline") > 0;
+        std::map<std::string, double> baseline;
+        if (have_baseline) {
+            baseline = load_baseline(baseline_file);
+        }
+
+        std::vector<sweep_result_t> results;
+        size_t n_regressions = 0;
+        for(const id_type &id:  get_converter_ids()) {
+            if ((vm.count("in") and id.input_format != in_format)
+                    or (vm.count("out") and id.output_format != out_format)) {
+                continue;
+            }
+            for(const priority_type prio_i:  get_converter_priorities(id)) {
+                std::cerr << "Benchmarking " << id.to_string() << " prio " << prio_i << std::endl;
+                for(const size_t size_i:  sweep_sizes) {
+                    for(const size_t alignment_i:  sweep_alignments) {
+                        for(const size_t channels_i:  sweep_channels) {
+                            sweep_result_t result = run_sweep_point(
+                                    id, prio_i, std::max<size_t>(1, size_i), alignment_i,
+                                    std::max<size_t>(1, channels_i), sweep_samples, cpu_mhz * 1e6
+                            );
+                            const std::string key = result_key(
+                                    id, prio_i, result.n_samples, alignment_i, result.channels);
+                            if (baseline.count(key)) {
+                                result.baseline_samples_per_sec = baseline[key];
+                                result.regression = result.samples_per_sec
+                                    < (1.0 - tolerance) * result.baseline_samples_per_sec;
+                                if (result.regression) {
+                                    n_regressions++;
+                                    std::cerr << boost::format(
+                                        "REGRESSION: %s prio %d, %d samples, alignment %d, %d channel(s): "
+                                        "%.3e samples/s (baseline %.3e samples/s)")
+                                        % id.to_string() % prio_i % result.n_samples
+                                        % alignment_i % result.channels % result.samples_per_sec
+                                        % result.baseline_samples_per_sec << std::endl;
+                                }
+                            }
+                            results.push_back(result);
+                        }
+                    }
+                }
+            }
+        }
+
+        if (vm.count("output")) {
+            std::ofstream out(output_file.c_str());
+            write_sweep_results(out, results, output_format, have_baseline);
+        } else {
+            write_sweep_results(std::cout, results, output_format, have_baseline);
+        }
+
+        if (have_baseline) {
+            std::cerr << n_regressions << " regression(s) found." << std::endl;
+        }
+        return (n_regressions == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // Parse more arguments
     if (seed_mode == "incremental") {
         buf_seed_mode = INC;